@@ -0,0 +1,3 @@
+# The second site has no position
+branch 3 1 4:1 invalid-profile.archer
+call 3 0 invalid-profile.archer
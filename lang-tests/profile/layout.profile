@@ -0,0 +1,9 @@
+# Branches that a training run almost always took one way, and loops that it mostly left without repeating
+branch 100 1 7:5 layout.archer
+branch 100 1 10:9 layout.archer
+branch 1 20 6:1 layout.archer
+branch 100 1 23:5 layout.archer
+branch 100 1 37:5 layout.archer
+branch 1 20 35:1 layout.archer
+branch 1 20 45:1 layout.archer
+branch 1 20 55:1 layout.archer
@@ -0,0 +1,10 @@
+# A training run that only ever gave these functions numbers
+call 40 0 5:5 specialised.archer
+operands 40 0 6:14 specialised.archer
+call 30 0 9:5 specialised.archer
+operands 30 0 10:24 specialised.archer
+operands 30 0 11:16 specialised.archer
+branch 2 28 11:5 specialised.archer
+call 1 0 18:5 specialised.archer
+call 30 0 22:5 specialised.archer
+operands 30 0 23:33 specialised.archer
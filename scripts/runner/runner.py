@@ -11,6 +11,13 @@ class TestResult:
         self.successful_count = successful_count
         self.total_count = total_count
         
+class TestOptions:
+    def __init__(self):
+        self.arguments = []
+        self.environment = {}
+        self.expected_error = None
+        self.expected_status = None
+        
 class BenchmarkResult:
     def __init__(self, interpreter, file, elapsed):
         self.interpreter = interpreter
@@ -103,7 +110,7 @@ def test_directory(args):
         print(f"Successfully completed {successful_count} out of {total_count} checks in total.")
         
 def run_test(interpreter, file, alias, args):
-    parsed = parse_expected(file)
+    parsed, options = parse_expected(file)
     
     expected, lines = map(list, zip(*parsed)) if parsed else ([], [])
     expected_count = len(expected)
@@ -111,11 +118,44 @@ def run_test(interpreter, file, alias, args):
     if not args.quiet:
         print(f"Running test '{file}' with '{alias}'...")
     
-    actual = get_interpreter_output(interpreter, file)
+    if options.expected_error:
+        return run_failing_test(interpreter, file, alias, args, options, expected, lines)
+    
+    actual = get_interpreter_output(interpreter, file, options.arguments, options.environment)
     if actual == None:
         print(f"File '{file}', containing {expected_count} checks, could not be run with '{alias}'.")
         return TestResult(interpreter, file, 0, expected_count)
     
+    return compare_output(interpreter, file, alias, args, expected, lines, actual)
+
+def run_failing_test(interpreter, file, alias, args, options, expected, lines):
+    error, error_line = options.expected_error
+    
+    try:
+        process = subprocess.run([interpreter, *options.arguments, file], stdout=subprocess.PIPE, stderr=subprocess.PIPE, env=make_environment(options.environment))
+    except OSError:
+        exit(f"Couldn't run interpreter at '{interpreter}'.")
+    
+    actual = [x.decode() for x in process.stdout.splitlines()]
+    result = compare_output(interpreter, file, alias, args, expected, lines, actual)
+    
+    #The error counts as one more check, which passes when the program fails with the expected message and status
+    errors = process.stderr.decode()
+    status = options.expected_status
+    if process.returncode == 0:
+        print(f"Expected error '{error}' but the program succeeded in test '{file}' on line {error_line}.")
+    elif status != None and process.returncode != status:
+        print(f"Expected exit code {status} but got {process.returncode} in test '{file}' on line {error_line}.")
+    elif error in errors:
+        result.successful_count += 1
+    else:
+        print(f"Expected error '{error}' but got '{errors.strip()}' in test '{file}' on line {error_line}.")
+    
+    result.total_count += 1
+    return result
+
+def compare_output(interpreter, file, alias, args, expected, lines, actual):
+    expected_count = len(expected)
     actual_count = len(actual)
 
     if expected_count != actual_count:
@@ -138,6 +178,7 @@ def run_test(interpreter, file, alias, args):
 
 def parse_expected(file):
     expected = []
+    options = TestOptions()
     current_line = 1
     
     reader = open(file, "r")
@@ -148,10 +189,26 @@ def parse_expected(file):
         if comment.startswith("Expected:"):
             _, _, value = comment.partition(':')
             expected.append((value.strip(), current_line))
+        elif comment.startswith("Expected error:"):
+            _, _, value = comment.partition(':')
+            options.expected_error = (value.strip(), current_line)
+        elif comment.startswith("Expected exit code:"):
+            _, _, value = comment.partition(':')
+            options.expected_status = int(value)
+        elif comment.startswith("Arguments:"):
+            _, _, value = comment.partition(':')
+            #Files that go along with the test are found through the directory it is in, wherever it is run from
+            directory = os.path.dirname(file) or "."
+            options.arguments.extend(argument.replace("$DIR", directory) for argument in value.split())
+        elif comment.startswith("Environment:"):
+            _, _, value = comment.partition(':')
+            for variable in value.split():
+                name, _, setting = variable.partition('=')
+                options.environment[name] = setting
             
         current_line += 1
             
-    return expected
+    return expected, options
 
 def benchmark(args):
     if (not (1 <= args.repeat <= 100)):
@@ -263,10 +320,10 @@ def get_benchmark_elapsed(interpreter, file):
     
     return float(output[-1])
 
-def get_interpreter_output(interpreter, file):
+def get_interpreter_output(interpreter, file, arguments=[], environment={}):
     output = None
     try:
-        output = subprocess.check_output([interpreter, file])
+        output = subprocess.check_output([interpreter, *arguments, file], env=make_environment(environment))
     except OSError:
         exit(f"Couldn't run interpreter at '{interpreter}'.")
     except subprocess.CalledProcessError:
@@ -274,6 +331,9 @@ def get_interpreter_output(interpreter, file):
         
     return [x.decode() for x in output.splitlines()]
 
+def make_environment(environment):
+    return {**os.environ, **environment} if environment else None
+
 def is_valid_file(file):
     return file.rpartition('.')[-1].lower() == "archer"
 
@@ -0,0 +1,287 @@
+#include <string.h>
+
+#include "analysis.h"
+#include "arena.h"
+
+#define NAMES_MIN_CAPACITY 16
+
+typedef struct Analyzer {
+    Arena* arena;
+    AssignedNames* names;
+} Analyzer;
+
+static void analyze_declaration(Analyzer* analyzer, Declaration* decl);
+static void analyze_statement(Analyzer* analyzer, Statement* stmt);
+static void analyze_expression(Analyzer* analyzer, Expression* expr);
+static void analyze_function(Analyzer* analyzer, Function* function);
+
+static uint32_t hash_lexeme(Token* identifier)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < identifier->length; i++) {
+        hash ^= (uint8_t)identifier->start[i];
+        hash *= 16777619;
+    }
+
+    return hash;
+}
+
+static Token* find_entry(Token* entries, size_t capacity, Token* identifier)
+{
+    uint32_t index = hash_lexeme(identifier) & (capacity - 1);
+    for (;;) {
+        Token* entry = &entries[index];
+        if (entry->start == NULL || Token_LexemesEqual(entry, identifier)) {
+            return entry;
+        }
+
+        index = (index + 1) & (capacity - 1);
+    }
+}
+
+static void grow_names(Analyzer* analyzer)
+{
+    AssignedNames* names = analyzer->names;
+
+    size_t capacity = names->capacity < NAMES_MIN_CAPACITY ? NAMES_MIN_CAPACITY : names->capacity * 2;
+    Token* entries = ARENA_ALLOCATE(analyzer->arena, Token, capacity);
+    memset(entries, 0, sizeof(Token) * capacity);
+
+    for (size_t i = 0; i < names->capacity; i++) {
+        if (names->entries[i].start != NULL) {
+            *find_entry(entries, capacity, &names->entries[i]) = names->entries[i];
+        }
+    }
+
+    names->entries = entries;
+    names->capacity = capacity;
+}
+
+static void add_name(Analyzer* analyzer, Token identifier)
+{
+    AssignedNames* names = analyzer->names;
+    if ((names->count + 1) * 4 > names->capacity * 3) {
+        grow_names(analyzer);
+    }
+
+    Token* entry = find_entry(names->entries, names->capacity, &identifier);
+    if (entry->start == NULL) {
+        *entry = identifier;
+        names->count++;
+    }
+}
+
+static void analyze_expression_list(Analyzer* analyzer, ExpressionList* list)
+{
+    for (ExpressionList* current = list; current != NULL; current = current->next) {
+        analyze_expression(analyzer, current->expression);
+    }
+}
+
+static void analyze_declaration_list(Analyzer* analyzer, DeclarationList* list)
+{
+    for (DeclarationList* current = list; current != NULL; current = current->next) {
+        analyze_declaration(analyzer, current->declaration);
+    }
+}
+
+static void analyze_optional_expression(Analyzer* analyzer, Expression* expr)
+{
+    if (expr) {
+        analyze_expression(analyzer, expr);
+    }
+}
+
+static void analyze_optional_statement(Analyzer* analyzer, Statement* stmt)
+{
+    if (stmt) {
+        analyze_statement(analyzer, stmt);
+    }
+}
+
+static void analyze_assignment_target(Analyzer* analyzer, AssignmentTarget* target)
+{
+    if (target->type == VAR_SINGLE) {
+        analyze_expression(analyzer, target->as.single);
+    } else {
+        analyze_expression_list(analyzer, target->as.unpack);
+    }
+}
+
+void analyze_function(Analyzer* analyzer, Function* function)
+{
+    FunctionBody* body = function->body;
+    if (body->notation == FUNC_EXPRESSION) {
+        analyze_expression(analyzer, body->as.expression);
+    } else {
+        analyze_declaration_list(analyzer, body->as.block->body);
+    }
+}
+
+void analyze_declaration(Analyzer* analyzer, Declaration* decl)
+{
+    switch (decl->type) {
+        case DECL_IMPORT: return;
+        case DECL_CLASS: {
+            for (MethodList* current = decl->as.classDecl.body; current != NULL; current = current->next) {
+                analyze_function(analyzer, current->method->namedFunction->function);
+            }
+            return;
+        }
+        case DECL_FUNCTION: analyze_function(analyzer, decl->as.functionDecl.function->function); return;
+        case DECL_VARIABLE: analyze_optional_expression(analyzer, decl->as.variableDecl.value); return;
+        case DECL_STATEMENT: analyze_statement(analyzer, decl->as.statement); return;
+    }
+}
+
+void analyze_statement(Analyzer* analyzer, Statement* stmt)
+{
+    switch (stmt->type) {
+        case STMT_FOR: {
+            if (stmt->as.forStmt.initializer) {
+                analyze_declaration(analyzer, stmt->as.forStmt.initializer);
+            }
+            analyze_optional_expression(analyzer, stmt->as.forStmt.condition);
+            analyze_optional_expression(analyzer, stmt->as.forStmt.increment);
+            analyze_statement(analyzer, stmt->as.forStmt.body);
+            return;
+        }
+        case STMT_FOR_IN: {
+            analyze_expression(analyzer, stmt->as.forInStmt.collection);
+            analyze_statement(analyzer, stmt->as.forInStmt.body);
+            return;
+        }
+        case STMT_WHILE: {
+            analyze_expression(analyzer, stmt->as.whileStmt.condition);
+            analyze_statement(analyzer, stmt->as.whileStmt.body);
+            return;
+        }
+        case STMT_DO_WHILE: {
+            analyze_statement(analyzer, stmt->as.doWhileStmt.body);
+            analyze_expression(analyzer, stmt->as.doWhileStmt.condition);
+            return;
+        }
+        case STMT_WHEN: {
+            analyze_expression(analyzer, stmt->as.whenStmt.control);
+            for (WhenEntryList* current = stmt->as.whenStmt.entries; current != NULL; current = current->next) {
+                analyze_expression_list(analyzer, current->entry->cases);
+                analyze_statement(analyzer, current->entry->body);
+            }
+            analyze_optional_statement(analyzer, stmt->as.whenStmt.elseBranch);
+            return;
+        }
+        case STMT_IF: {
+            analyze_expression(analyzer, stmt->as.ifStmt.condition);
+            analyze_statement(analyzer, stmt->as.ifStmt.thenBranch);
+            analyze_optional_statement(analyzer, stmt->as.ifStmt.elseBranch);
+            return;
+        }
+        case STMT_RETURN: analyze_optional_expression(analyzer, stmt->as.returnStmt.expression); return;
+        case STMT_PRINT: analyze_expression(analyzer, stmt->as.printStmt.expression); return;
+        case STMT_BLOCK: analyze_declaration_list(analyzer, stmt->as.blockStmt.block->body); return;
+        case STMT_EXPRESSION: analyze_expression(analyzer, stmt->as.expression); return;
+        case STMT_BREAK:
+        case STMT_CONTINUE: return;
+    }
+}
+
+void analyze_expression(Analyzer* analyzer, Expression* expr)
+{
+    switch (expr->type) {
+        case EXPR_CALL: {
+            analyze_expression(analyzer, expr->as.callExpr.callee);
+            for (ArgumentList* current = expr->as.callExpr.arguments; current != NULL; current = current->next) {
+                analyze_expression(analyzer, current->expression);
+            }
+            return;
+        }
+        case EXPR_PROPERTY: analyze_expression(analyzer, expr->as.propertyExpr.object); return;
+        case EXPR_SUBSCRIPT: {
+            analyze_expression(analyzer, expr->as.subscriptExpr.object);
+            analyze_expression(analyzer, expr->as.subscriptExpr.index);
+            return;
+        }
+        case EXPR_ASSIGNMENT: {
+            analyze_assignment_target(analyzer, expr->as.assignmentExpr.target);
+            analyze_expression(analyzer, expr->as.assignmentExpr.value);
+            return;
+        }
+        case EXPR_COMPOUND_ASSIGNMNET: {
+            analyze_assignment_target(analyzer, expr->as.compoundAssignmentExpr.target);
+            analyze_expression(analyzer, expr->as.compoundAssignmentExpr.value);
+            return;
+        }
+        case EXPR_COROUTINE: analyze_expression(analyzer, expr->as.coroutineExpr.expression); return;
+        case EXPR_YIELD: analyze_optional_expression(analyzer, expr->as.yieldExpr.expression); return;
+        case EXPR_POSTFIX_INC: analyze_expression(analyzer, expr->as.postfixIncExpr.target); return;
+        case EXPR_PREFIX_INC: analyze_expression(analyzer, expr->as.prefixIncExpr.target); return;
+        case EXPR_LOGICAL: {
+            analyze_expression(analyzer, expr->as.logicalExpr.left);
+            analyze_expression(analyzer, expr->as.logicalExpr.right);
+            return;
+        }
+        case EXPR_CONDITIONAL: {
+            analyze_expression(analyzer, expr->as.conditionalExpr.condition);
+            analyze_expression(analyzer, expr->as.conditionalExpr.thenBranch);
+            analyze_expression(analyzer, expr->as.conditionalExpr.elseBranch);
+            return;
+        }
+        case EXPR_ELVIS: {
+            analyze_expression(analyzer, expr->as.elvisExpr.left);
+            analyze_expression(analyzer, expr->as.elvisExpr.right);
+            return;
+        }
+        case EXPR_BINARY: {
+            analyze_expression(analyzer, expr->as.binaryExpr.left);
+            analyze_expression(analyzer, expr->as.binaryExpr.right);
+            return;
+        }
+        case EXPR_UNARY: analyze_expression(analyzer, expr->as.unaryExpr.expression); return;
+        case EXPR_STRING_INTERP: analyze_expression_list(analyzer, expr->as.stringInterpExpr.values); return;
+        case EXPR_RANGE: {
+            analyze_expression(analyzer, expr->as.rangeExpr.begin);
+            analyze_expression(analyzer, expr->as.rangeExpr.end);
+            analyze_optional_expression(analyzer, expr->as.rangeExpr.step);
+            return;
+        }
+        case EXPR_LAMBDA: analyze_function(analyzer, expr->as.lambdaExpr.function); return;
+        case EXPR_LIST: analyze_expression_list(analyzer, expr->as.listExpr.elements); return;
+        case EXPR_MAP: {
+            for (MapEntryList* current = expr->as.mapExpr.entries; current != NULL; current = current->next) {
+                analyze_expression(analyzer, current->entry->key);
+                analyze_expression(analyzer, current->entry->value);
+            }
+            return;
+        }
+        case EXPR_TUPLE: analyze_expression_list(analyzer, expr->as.tupleExpr.elements); return;
+        case EXPR_IDENTIFIER: {
+            if (expr->as.identifierExpr.context == STORE) {
+                add_name(analyzer, expr->as.identifierExpr.identifier);
+            }
+            return;
+        }
+        case EXPR_SUPER:
+        case EXPR_LITERAL: return;
+    }
+}
+
+AssignedNames* Analysis_CollectAssigned(Arena* arena, Declaration* decl)
+{
+    AssignedNames* names = ARENA_ALLOCATE(arena, AssignedNames, 1);
+    names->entries = NULL;
+    names->count = 0;
+    names->capacity = 0;
+
+    Analyzer analyzer = { .arena = arena, .names = names };
+    analyze_declaration(&analyzer, decl);
+    return names;
+}
+
+bool Analysis_IsAssigned(AssignedNames* names, Token* identifier)
+{
+    if (names->count == 0) {
+        return false;
+    }
+
+    return find_entry(names->entries, names->capacity, identifier)->start != NULL;
+}
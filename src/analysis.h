@@ -0,0 +1,15 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include "ast.h"
+
+typedef struct AssignedNames {
+    Token* entries;
+    size_t count;
+    size_t capacity;
+} AssignedNames;
+
+AssignedNames* Analysis_CollectAssigned(Arena* arena, Declaration* decl);
+bool Analysis_IsAssigned(AssignedNames* names, Token* identifier);
+
+#endif
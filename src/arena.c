@@ -0,0 +1,87 @@
+#include <stdlib.h>
+
+#include "arena.h"
+#include "memory.h"
+
+#define ARENA_BLOCK_SIZE (16 * 1024)
+#define ARENA_ALIGNMENT (2 * sizeof(void*))
+
+#define ALIGN_UP(size) (((size) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t capacity;
+    size_t used;
+    _Alignas(2 * sizeof(void*)) unsigned char data[];
+} ArenaBlock;
+
+void Arena_Init(Arena* arena)
+{
+    arena->blocks = NULL;
+}
+
+void Arena_Free(Arena* arena)
+{
+    ArenaBlock* block = arena->blocks;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+
+    Arena_Init(arena);
+}
+
+static ArenaBlock* new_block(size_t capacity, ArenaBlock* next)
+{
+    ArenaBlock* block = xmalloc(sizeof(ArenaBlock) + capacity);
+    block->next = next;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+void* Arena_Allocate(Arena* arena, size_t size)
+{
+    size = ALIGN_UP(size);
+
+    ArenaBlock* block = arena->blocks;
+    if (!block || block->capacity - block->used < size) {
+        block = new_block(size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE, block);
+        arena->blocks = block;
+    }
+
+    void* pointer = block->data + block->used;
+    block->used += size;
+    return pointer;
+}
+
+ArenaMark Arena_Mark(Arena* arena)
+{
+    ArenaMark mark;
+    mark.block = arena->blocks;
+    mark.used = arena->blocks ? arena->blocks->used : 0;
+    return mark;
+}
+
+void Arena_Release(Arena* arena, ArenaMark mark)
+{
+    ArenaBlock* block = arena->blocks;
+    while (block != mark.block) {
+        ArenaBlock* next = block->next;
+        if (!next) {
+            //Keep the oldest block around so that it can be reused
+            arena->blocks = block;
+            block->used = 0;
+            return;
+        }
+
+        free(block);
+        block = next;
+    }
+
+    arena->blocks = block;
+    if (block) {
+        block->used = mark.used;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "common.h"
+
+#define ARENA_ALLOCATE(arena, type, length)                                                         \
+    (type*)Arena_Allocate(arena, sizeof(type) * (length))                                           \
+
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock* blocks;
+} Arena;
+
+typedef struct ArenaMark {
+    ArenaBlock* block;
+    size_t used;
+} ArenaMark;
+
+void Arena_Init(Arena* arena);
+void Arena_Free(Arena* arena);
+
+void* Arena_Allocate(Arena* arena, size_t size);
+
+ArenaMark Arena_Mark(Arena* arena);
+void Arena_Release(Arena* arena, ArenaMark mark);
+
+#endif
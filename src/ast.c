@@ -2,11 +2,11 @@
 #include <stdlib.h>
 
 #include "ast.h"
-#include "memory.h"
+#include "arena.h"
 
-AST* Ast_NewTree(DeclarationList* body)
+AST* Ast_NewTree(Arena* arena, DeclarationList* body)
 {
-    AST* ast = xmalloc(sizeof(AST));
+    AST* ast = ARENA_ALLOCATE(arena, AST, 1);
     if (!ast) {
         return NULL;
     }
@@ -15,34 +15,9 @@ AST* Ast_NewTree(DeclarationList* body)
     return ast;
 }
 
-void Ast_DeleteTree(AST* ast)
+Declaration* Ast_NewImportAllDecl(Arena* arena, Expression* moduleName)
 {
-    if (!ast) {
-        return;
-    }
-
-    Ast_DeleteDeclarationList(ast->body);
-    free(ast);
-}
-
-void Ast_DeleteDeclaration(Declaration* declaration)
-{
-    if (!declaration) {
-        return;
-    }
-
-    switch (declaration->type) {
-        case DECL_IMPORT: Ast_DeleteImportDecl(declaration); return;
-        case DECL_CLASS: Ast_DeleteClassDecl(declaration); return;
-        case DECL_FUNCTION: Ast_DeleteFunctionDecl(declaration); return;
-        case DECL_VARIABLE: Ast_DeleteVariableDecl(declaration); return;
-        case DECL_STATEMENT: Ast_DeleteStatementDecl(declaration); return;
-    }
-}
-
-Declaration* Ast_NewImportAllDecl(Expression* moduleName)
-{
-    Declaration* decl = xmalloc(sizeof(Declaration));
+    Declaration* decl = ARENA_ALLOCATE(arena, Declaration, 1);
     if (!decl) {
         return NULL;
     }
@@ -53,9 +28,9 @@ Declaration* Ast_NewImportAllDecl(Expression* moduleName)
     return decl;
 }
 
-Declaration* Ast_NewImportAsDecl(Expression* moduleName, Token alias)
+Declaration* Ast_NewImportAsDecl(Arena* arena, Expression* moduleName, Token alias)
 {
-    Declaration* decl = xmalloc(sizeof(Declaration));
+    Declaration* decl = ARENA_ALLOCATE(arena, Declaration, 1);
     if (!decl) {
         return NULL;
     }
@@ -67,9 +42,9 @@ Declaration* Ast_NewImportAsDecl(Expression* moduleName, Token alias)
     return decl;
 }
 
-Declaration* Ast_NewImportForDecl(Expression* moduleName, ParameterList* names)
+Declaration* Ast_NewImportForDecl(Arena* arena, Expression* moduleName, ParameterList* names)
 {
-    Declaration* decl = xmalloc(sizeof(Declaration));
+    Declaration* decl = ARENA_ALLOCATE(arena, Declaration, 1);
     if (!decl) {
         return NULL;
     }
@@ -81,22 +56,9 @@ Declaration* Ast_NewImportForDecl(Expression* moduleName, ParameterList* names)
     return decl;
 }
 
-void Ast_DeleteImportDecl(Declaration* declaration)
+Declaration* Ast_NewClassDecl(Arena* arena, Token identifier, Token superclass, MethodList* body)
 {
-    Ast_DeleteExpression(declaration->as.importDecl.moduleName);
-
-    switch (declaration->as.importDecl.type) {
-        case IMPORT_ALL: break;
-        case IMPORT_AS: break;
-        case IMPORT_FOR: Ast_DeleteParameterList(declaration->as.importDecl.with.names);
-    }
-
-    free(declaration);
-}
-
-Declaration* Ast_NewClassDecl(Token identifier, Token superclass, MethodList* body)
-{
-    Declaration* decl = xmalloc(sizeof(Declaration));
+    Declaration* decl = ARENA_ALLOCATE(arena, Declaration, 1);
     if (!decl) {
         return NULL;
     }
@@ -108,15 +70,9 @@ Declaration* Ast_NewClassDecl(Token identifier, Token superclass, MethodList* bo
     return decl;
 }
 
-void Ast_DeleteClassDecl(Declaration* declaration)
-{
-    Ast_DeleteMethodList(declaration->as.classDecl.body);
-    free(declaration);
-}
-
-Declaration* Ast_NewFunctionDecl(NamedFunction* function)
+Declaration* Ast_NewFunctionDecl(Arena* arena, NamedFunction* function)
 {
-    Declaration* decl = xmalloc(sizeof(Declaration));
+    Declaration* decl = ARENA_ALLOCATE(arena, Declaration, 1);
     if (!decl) {
         return NULL;
     }
@@ -126,15 +82,9 @@ Declaration* Ast_NewFunctionDecl(NamedFunction* function)
     return decl;
 }
 
-void Ast_DeleteFunctionDecl(Declaration* declaration)
+Declaration* Ast_NewVariableDecl(Arena* arena, VariableTarget* target, Expression* value)
 {
-    Ast_DeleteNamedFunction(declaration->as.functionDecl.function);
-    free(declaration);
-}
-
-Declaration* Ast_NewVariableDecl(VariableTarget* target, Expression* value)
-{
-    Declaration* decl = xmalloc(sizeof(Declaration));
+    Declaration* decl = ARENA_ALLOCATE(arena, Declaration, 1);
     if (!decl) {
         return NULL;
     }
@@ -145,16 +95,9 @@ Declaration* Ast_NewVariableDecl(VariableTarget* target, Expression* value)
     return decl;
 }
 
-void Ast_DeleteVariableDecl(Declaration* declaration)
-{
-    Ast_DeleteVariableTarget(declaration->as.variableDecl.target);
-    Ast_DeleteExpression(declaration->as.variableDecl.value);
-    free(declaration);
-}
-
-Declaration* Ast_NewStatementDecl(Statement* statement)
+Declaration* Ast_NewStatementDecl(Arena* arena, Statement* statement)
 {
-    Declaration* decl = xmalloc(sizeof(Declaration));
+    Declaration* decl = ARENA_ALLOCATE(arena, Declaration, 1);
     if (!decl) {
         return NULL;
     }
@@ -164,42 +107,15 @@ Declaration* Ast_NewStatementDecl(Statement* statement)
     return decl;
 }
 
-void Ast_DeleteStatementDecl(Declaration* declaration)
-{
-    Ast_DeleteStatement(declaration->as.statement);
-    free(declaration);
-}
-
-void Ast_DeleteStatement(Statement* statement)
-{
-    if (!statement) {
-        return;
-    }
-
-    switch (statement->type) {
-        case STMT_FOR: Ast_DeleteForStmt(statement); return;
-        case STMT_FOR_IN: Ast_DeleteForInStmt(statement); return;
-        case STMT_WHILE: ast_DeleteWhileStmt(statement); return;
-        case STMT_DO_WHILE: Ast_DeleteDoWhileStmt(statement); return;
-        case STMT_BREAK: Ast_DeleteBreakStmt(statement); return;
-        case STMT_CONTINUE: Ast_DeleteContinueStmt(statement); return;
-        case STMT_WHEN: Ast_DeleteWhenStmt(statement); return;
-        case STMT_IF: Ast_DeleteIfStmt(statement); return;
-        case STMT_RETURN: Ast_DeleteReturnStmt(statement); return;
-        case STMT_PRINT: Ast_DeletePrintStmt(statement); return;
-        case STMT_BLOCK: Ast_DeleteBlockStmt(statement); return;
-        case STMT_EXPRESSION: Ast_DeleteExpressionStmt(statement); return;
-    }
-}
-
-Statement* Ast_NewForStmt(Declaration* initializer, Expression* condition, Expression* increment, Statement* body)
+Statement* Ast_NewForStmt(Arena* arena, Token keyword, Declaration* initializer, Expression* condition, Expression* increment, Statement* body)
 {
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
 
     stmt->type = STMT_FOR;
+    stmt->as.forStmt.keyword = keyword;
     stmt->as.forStmt.initializer = initializer;
     stmt->as.forStmt.condition = condition;
     stmt->as.forStmt.increment = increment;
@@ -207,18 +123,9 @@ Statement* Ast_NewForStmt(Declaration* initializer, Expression* condition, Expre
     return stmt;
 }
 
-void Ast_DeleteForStmt(Statement* statement)
-{
-    Ast_DeleteDeclaration(statement->as.forStmt.initializer);
-    Ast_DeleteExpression(statement->as.forStmt.condition);
-    Ast_DeleteExpression(statement->as.forStmt.increment);
-    Ast_DeleteStatement(statement->as.forStmt.body);
-    free(statement);
-}
-
-Statement* Ast_NewForInStmt(Declaration* element, Expression* collection, Statement* body)
+Statement* Ast_NewForInStmt(Arena* arena, Declaration* element, Expression* collection, Statement* body)
 {
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -230,37 +137,23 @@ Statement* Ast_NewForInStmt(Declaration* element, Expression* collection, Statem
     return stmt;
 }
 
-void Ast_DeleteForInStmt(Statement* statement)
+Statement* Ast_NewWhileStmt(Arena* arena, Token keyword, Expression* condition, Statement* body)
 {
-    Ast_DeleteDeclaration(statement->as.forInStmt.element);
-    Ast_DeleteExpression(statement->as.forInStmt.collection);
-    Ast_DeleteStatement(statement->as.forInStmt.body);
-    free(statement);
-}
-
-Statement* Ast_NewWhileStmt(Expression* condition, Statement* body)
-{
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
 
     stmt->type = STMT_WHILE;
+    stmt->as.whileStmt.keyword = keyword;
     stmt->as.whileStmt.condition = condition;
     stmt->as.whileStmt.body = body;
     return stmt;
 }
 
-void ast_DeleteWhileStmt(Statement* statement)
+Statement* Ast_NewDoWhileStmt(Arena* arena, Statement* body, Expression* condition)
 {
-    Ast_DeleteExpression(statement->as.whileStmt.condition);
-    Ast_DeleteStatement(statement->as.whileStmt.body);
-    free(statement);
-}
-
-Statement* Ast_NewDoWhileStmt(Statement* body, Expression* condition)
-{
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -271,16 +164,9 @@ Statement* Ast_NewDoWhileStmt(Statement* body, Expression* condition)
     return stmt;
 }
 
-void Ast_DeleteDoWhileStmt(Statement* statement)
-{
-    Ast_DeleteStatement(statement->as.doWhileStmt.body);
-    Ast_DeleteExpression(statement->as.doWhileStmt.condition);
-    free(statement);
-}
-
-Statement* Ast_NewBreakStmt(Token keyword)
+Statement* Ast_NewBreakStmt(Arena* arena, Token keyword)
 {
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -290,14 +176,9 @@ Statement* Ast_NewBreakStmt(Token keyword)
     return stmt;
 }
 
-void Ast_DeleteBreakStmt(Statement* statement)
+Statement* Ast_NewContinueStmt(Arena* arena, Token keyword)
 {
-    free(statement);
-}
-
-Statement* Ast_NewContinueStmt(Token keyword)
-{
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -307,14 +188,9 @@ Statement* Ast_NewContinueStmt(Token keyword)
     return stmt;
 }
 
-void Ast_DeleteContinueStmt(Statement* statement)
-{
-    free(statement);
-}
-
-Statement* Ast_NewWhenStmt(Expression* control, WhenEntryList* entries, Statement* elseBranch)
+Statement* Ast_NewWhenStmt(Arena* arena, Expression* control, WhenEntryList* entries, Statement* elseBranch)
 {
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -326,39 +202,24 @@ Statement* Ast_NewWhenStmt(Expression* control, WhenEntryList* entries, Statemen
     return stmt;
 }
 
-void Ast_DeleteWhenStmt(Statement* statement)
-{
-    Ast_DeleteExpression(statement->as.whenStmt.control);
-    Ast_DeleteWhenEntryList(statement->as.whenStmt.entries);
-    Ast_DeleteStatement(statement->as.whenStmt.elseBranch);
-    free(statement);
-}
-
-Statement* Ast_NewIfStmt(Expression* condition, Statement* thenBranch, Statement* elseBranch)
+Statement* Ast_NewIfStmt(Arena* arena, Token keyword, Expression* condition, Statement* thenBranch, Statement* elseBranch)
 {
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
 
     stmt->type = STMT_IF;
+    stmt->as.ifStmt.keyword = keyword;
     stmt->as.ifStmt.condition = condition;
     stmt->as.ifStmt.thenBranch = thenBranch;
     stmt->as.ifStmt.elseBranch = elseBranch;
     return stmt;
 }
 
-void Ast_DeleteIfStmt(Statement* statement)
-{
-    Ast_DeleteExpression(statement->as.ifStmt.condition);
-    Ast_DeleteStatement(statement->as.ifStmt.thenBranch);
-    Ast_DeleteStatement(statement->as.ifStmt.elseBranch);
-    free(statement);
-}
-
-Statement* Ast_NewReturnStmt(Token keyword, Expression* expression)
+Statement* Ast_NewReturnStmt(Arena* arena, Token keyword, Expression* expression)
 {
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -369,15 +230,9 @@ Statement* Ast_NewReturnStmt(Token keyword, Expression* expression)
     return stmt;
 }
 
-void Ast_DeleteReturnStmt(Statement* statement)
+Statement* Ast_NewPrintStmt(Arena* arena, Expression* expression)
 {
-    Ast_DeleteExpression(statement->as.returnStmt.expression);
-    free(statement);
-}
-
-Statement* Ast_NewPrintStmt(Expression* expression)
-{
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -387,15 +242,9 @@ Statement* Ast_NewPrintStmt(Expression* expression)
     return stmt;
 }
 
-void Ast_DeletePrintStmt(Statement* statement)
+Statement* Ast_NewBlockStmt(Arena* arena, Block* block)
 {
-    Ast_DeleteExpression(statement->as.printStmt.expression);
-    free(statement);
-}
-
-Statement* Ast_NewBlockStmt(Block* block)
-{
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -405,15 +254,9 @@ Statement* Ast_NewBlockStmt(Block* block)
     return stmt;
 }
 
-void Ast_DeleteBlockStmt(Statement* statement)
-{
-    Ast_DeleteBlock(statement->as.blockStmt.block);
-    free(statement);
-}
-
-Statement* Ast_NewExpressionStmt(Expression* expression)
+Statement* Ast_NewExpressionStmt(Arena* arena, Expression* expression)
 {
-    Statement* stmt = xmalloc(sizeof(Statement));
+    Statement* stmt = ARENA_ALLOCATE(arena, Statement, 1);
     if (!stmt) {
         return NULL;
     }
@@ -423,48 +266,9 @@ Statement* Ast_NewExpressionStmt(Expression* expression)
     return stmt;
 }
 
-void Ast_DeleteExpressionStmt(Statement* statement)
+Expression* Ast_NewCallExpr(Arena* arena, Expression* callee, ArgumentList* arguments)
 {
-    Ast_DeleteExpression(statement->as.expression);
-    free(statement);
-}
-
-void Ast_DeleteExpression(Expression* expression)
-{
-    if (!expression) {
-        return;
-    }
-
-    switch (expression->type) {
-        case EXPR_CALL: Ast_DeleteCallExpr(expression); return;
-        case EXPR_PROPERTY: Ast_DeletePropertyExpr(expression); return;
-        case EXPR_SUBSCRIPT: Ast_DeleteSubscriptExpr(expression); return;
-        case EXPR_SUPER: Ast_DeleteSuperExpr(expression); return;
-        case EXPR_ASSIGNMENT: Ast_DeleteAssignmentExpr(expression); return;
-        case EXPR_COMPOUND_ASSIGNMNET: Ast_DeleteCompoundAssignmentExpr(expression); return;
-        case EXPR_COROUTINE: Ast_DeleteCoroutineExpr(expression); return;
-        case EXPR_YIELD: Ast_DeleteYieldExpr(expression); return;
-        case EXPR_POSTFIX_INC: Ast_DeletePostifxIncExpr(expression); return;
-        case EXPR_PREFIX_INC: Ast_DeletePrefixIncExpr(expression); return;
-        case EXPR_LOGICAL: Ast_DeleteLogicalExpr(expression); return;
-        case EXPR_CONDITIONAL: Ast_DeleteConditionalExpr(expression); return;
-        case EXPR_ELVIS: Ast_DeleteElvisExpr(expression); return;
-        case EXPR_BINARY: Ast_DeleteBinaryExpr(expression); return;
-        case EXPR_UNARY: Ast_DeleteUnaryExpr(expression); return;
-        case EXPR_LITERAL: Ast_DeleteLiteralExpr(expression); return;
-        case EXPR_STRING_INTERP: Ast_DeleteStringInterpExpr(expression); return;
-        case EXPR_RANGE: Ast_DeleteRangeExpr(expression); return;
-        case EXPR_LAMBDA: Ast_DeleteLambdaExpr(expression); return;
-        case EXPR_LIST: Ast_DeleteListExpr(expression); return;
-        case EXPR_MAP: Ast_DeleteMapExpr(expression); return;
-        case EXPR_TUPLE: Ast_DeleteTupleExpr(expression); return;
-        case EXPR_IDENTIFIER: Ast_DeleteIdentifierExpr(expression); return;
-    }
-}
-
-Expression* Ast_NewCallExpr(Expression* callee, ArgumentList* arguments)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -475,16 +279,9 @@ Expression* Ast_NewCallExpr(Expression* callee, ArgumentList* arguments)
     return expr;
 }
 
-void Ast_DeleteCallExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.callExpr.callee);
-    Ast_DeleteArgumentList(expression->as.callExpr.arguments);
-    free(expression);
-}
-
-Expression* Ast_NewPropertyExpr(Expression* object, Token property, ExprContext context, bool safe)
+Expression* Ast_NewPropertyExpr(Arena* arena, Expression* object, Token property, ExprContext context, bool safe)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -497,15 +294,9 @@ Expression* Ast_NewPropertyExpr(Expression* object, Token property, ExprContext
     return expr;
 }
 
-void Ast_DeletePropertyExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.propertyExpr.object);
-    free(expression);
-}
-
-Expression* Ast_NewSubscriptExpr(Expression* object, Expression* index, ExprContext context, bool safe)
+Expression* Ast_NewSubscriptExpr(Arena* arena, Expression* object, Expression* index, ExprContext context, bool safe)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -518,16 +309,9 @@ Expression* Ast_NewSubscriptExpr(Expression* object, Expression* index, ExprCont
     return expr;
 }
 
-void Ast_DeleteSubscriptExpr(Expression* expression)
+Expression* Ast_NewSuperExpr(Arena* arena, Token keyword, Token method)
 {
-    Ast_DeleteExpression(expression->as.subscriptExpr.object);
-    Ast_DeleteExpression(expression->as.subscriptExpr.index);
-    free(expression);
-}
-
-Expression* Ast_NewSuperExpr(Token keyword, Token method)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -538,14 +322,9 @@ Expression* Ast_NewSuperExpr(Token keyword, Token method)
     return expr;
 }
 
-void Ast_DeleteSuperExpr(Expression* expression)
+Expression* Ast_NewAssignmentExpr(Arena* arena, AssignmentTarget* target, Expression* value)
 {
-    free(expression);
-}
-
-Expression* Ast_NewAssignmentExpr(AssignmentTarget* target, Expression* value)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -556,16 +335,9 @@ Expression* Ast_NewAssignmentExpr(AssignmentTarget* target, Expression* value)
     return expr;
 }
 
-void Ast_DeleteAssignmentExpr(Expression* expression)
-{
-    Ast_DeleteAssignmentTarget(expression->as.assignmentExpr.target);
-    Ast_DeleteExpression(expression->as.assignmentExpr.value);
-    free(expression);
-}
-
-Expression* Ast_NewCompoundAssignmentExpr(AssignmentTarget* target, Token op, Expression* value)
+Expression* Ast_NewCompoundAssignmentExpr(Arena* arena, AssignmentTarget* target, Token op, Expression* value)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -577,16 +349,9 @@ Expression* Ast_NewCompoundAssignmentExpr(AssignmentTarget* target, Token op, Ex
     return expr;
 }
 
-void Ast_DeleteCompoundAssignmentExpr(Expression* expression)
+Expression* Ast_NewCoroutineExpr(Arena* arena, Token keyword, Expression* expression)
 {
-    Ast_DeleteAssignmentTarget(expression->as.compoundAssignmentExpr.target);
-    Ast_DeleteExpression(expression->as.compoundAssignmentExpr.value);
-    free(expression);
-}
-
-Expression* Ast_NewCoroutineExpr(Token keyword, Expression* expression)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -597,15 +362,9 @@ Expression* Ast_NewCoroutineExpr(Token keyword, Expression* expression)
     return expr;
 }
 
-void Ast_DeleteCoroutineExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.coroutineExpr.expression);
-    free(expression);
-}
-
-Expression* Ast_NewYieldExpr(Token keyword, Expression* expression)
+Expression* Ast_NewYieldExpr(Arena* arena, Token keyword, Expression* expression)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -616,15 +375,9 @@ Expression* Ast_NewYieldExpr(Token keyword, Expression* expression)
     return expr;
 }
 
-void Ast_DeleteYieldExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.yieldExpr.expression);
-    free(expression);
-}
-
-Expression* Ast_NewLogicalExpr(Expression* left, Token op, Expression* right)
+Expression* Ast_NewLogicalExpr(Arena* arena, Expression* left, Token op, Expression* right)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -636,16 +389,9 @@ Expression* Ast_NewLogicalExpr(Expression* left, Token op, Expression* right)
     return expr;
 }
 
-void Ast_DeleteLogicalExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.logicalExpr.left);
-    Ast_DeleteExpression(expression->as.logicalExpr.right);
-    free(expression);
-}
-
-Expression* Ast_NewConditionalExpr(Expression* condition, Expression* thenBranch, Expression* elseBranch)
+Expression* Ast_NewConditionalExpr(Arena* arena, Expression* condition, Expression* thenBranch, Expression* elseBranch)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -657,17 +403,9 @@ Expression* Ast_NewConditionalExpr(Expression* condition, Expression* thenBranch
     return expr;
 }
 
-void Ast_DeleteConditionalExpr(Expression* expression)
+Expression* Ast_NewElvisExpr(Arena* arena, Expression* left, Expression* right)
 {
-    Ast_DeleteExpression(expression->as.conditionalExpr.condition);
-    Ast_DeleteExpression(expression->as.conditionalExpr.thenBranch);
-    Ast_DeleteExpression(expression->as.conditionalExpr.elseBranch);
-    free(expression);
-}
-
-Expression* Ast_NewElvisExpr(Expression* left, Expression* right)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -678,16 +416,9 @@ Expression* Ast_NewElvisExpr(Expression* left, Expression* right)
     return expr;
 }
 
-void Ast_DeleteElvisExpr(Expression* expression)
+Expression* Ast_NewBinaryExpr(Arena* arena, Expression* left, Token op, Expression* right)
 {
-    Ast_DeleteExpression(expression->as.elvisExpr.left);
-    Ast_DeleteExpression(expression->as.elvisExpr.right);
-    free(expression);
-}
-
-Expression* Ast_NewBinaryExpr(Expression* left, Token op, Expression* right)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -699,16 +430,9 @@ Expression* Ast_NewBinaryExpr(Expression* left, Token op, Expression* right)
     return expr;
 }
 
-void Ast_DeleteBinaryExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.binaryExpr.left);
-    Ast_DeleteExpression(expression->as.binaryExpr.right);
-    free(expression);
-}
-
-Expression* Ast_NewUnaryExpr(Token op, Expression* expression)
+Expression* Ast_NewUnaryExpr(Arena* arena, Token op, Expression* expression)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -719,15 +443,9 @@ Expression* Ast_NewUnaryExpr(Token op, Expression* expression)
     return expr;
 }
 
-void Ast_DeleteUnaryExpr(Expression* expression)
+Expression* Ast_NewPostfixIncExpr(Arena* arena, Token op, Expression* expression)
 {
-    Ast_DeleteExpression(expression->as.unaryExpr.expression);
-    free(expression);
-}
-
-Expression* Ast_NewPostfixIncExpr(Token op, Expression* expression)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -738,15 +456,9 @@ Expression* Ast_NewPostfixIncExpr(Token op, Expression* expression)
     return expr;
 }
 
-void Ast_DeletePostifxIncExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.postfixIncExpr.target);
-    free(expression);
-}
-
-Expression* Ast_NewPrefixIncExpr(Token op, Expression* expression)
+Expression* Ast_NewPrefixIncExpr(Arena* arena, Token op, Expression* expression)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -757,15 +469,9 @@ Expression* Ast_NewPrefixIncExpr(Token op, Expression* expression)
     return expr;
 }
 
-void Ast_DeletePrefixIncExpr(Expression* expression)
-{
-    Ast_DeleteExpression(expression->as.prefixIncExpr.target);
-    free(expression);
-}
-
-Expression* Ast_NewLiteralExpr(Token value)
+Expression* Ast_NewLiteralExpr(Arena* arena, Token value)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -775,14 +481,9 @@ Expression* Ast_NewLiteralExpr(Token value)
     return expr;
 }
 
-void Ast_DeleteLiteralExpr(Expression* expression)
-{
-    free(expression);
-}
-
-Expression* Ast_NewStringInterpExpr(ExpressionList* values)
+Expression* Ast_NewStringInterpExpr(Arena* arena, ExpressionList* values)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -792,15 +493,9 @@ Expression* Ast_NewStringInterpExpr(ExpressionList* values)
     return expr;
 }
 
-void Ast_DeleteStringInterpExpr(Expression* expression)
+Expression* Ast_NewRangeExpr(Arena* arena, Expression* begin, Expression* end, Expression* step)
 {
-    Ast_DeleteExpressionList(expression->as.stringInterpExpr.values);
-    free(expression);
-}
-
-Expression* Ast_NewRangeExpr(Expression* begin, Expression* end, Expression* step)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -812,17 +507,9 @@ Expression* Ast_NewRangeExpr(Expression* begin, Expression* end, Expression* ste
     return expr;
 }
 
-void Ast_DeleteRangeExpr(Expression* expression)
+Expression* Ast_NewLambdaExpr(Arena* arena, Function* function)
 {
-    Ast_DeleteExpression(expression->as.rangeExpr.begin);
-    Ast_DeleteExpression(expression->as.rangeExpr.end);
-    Ast_DeleteExpression(expression->as.rangeExpr.step);
-    free(expression);
-}
-
-Expression* Ast_NewLambdaExpr(Function* function)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -832,15 +519,9 @@ Expression* Ast_NewLambdaExpr(Function* function)
     return expr;
 }
 
-void Ast_DeleteLambdaExpr(Expression* expression)
-{
-    Ast_DeleteFunction(expression->as.lambdaExpr.function);
-    free(expression);
-}
-
-Expression* Ast_NewListExpr(ExpressionList* elements)
+Expression* Ast_NewListExpr(Arena* arena, ExpressionList* elements)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -850,15 +531,9 @@ Expression* Ast_NewListExpr(ExpressionList* elements)
     return expr;
 }
 
-void Ast_DeleteListExpr(Expression* expression)
+Expression* Ast_NewMapExpr(Arena* arena, MapEntryList* entries)
 {
-    Ast_DeleteExpressionList(expression->as.listExpr.elements);
-    free(expression);
-}
-
-Expression* Ast_NewMapExpr(MapEntryList* entries)
-{
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -868,15 +543,9 @@ Expression* Ast_NewMapExpr(MapEntryList* entries)
     return expr;
 }
 
-void Ast_DeleteMapExpr(Expression* expression)
-{
-    Ast_DeleteMapEntryList(expression->as.mapExpr.entries);
-    free(expression);
-}
-
-Expression* Ast_NewTupleExpr(ExpressionList* elements)
+Expression* Ast_NewTupleExpr(Arena* arena, ExpressionList* elements)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -886,15 +555,9 @@ Expression* Ast_NewTupleExpr(ExpressionList* elements)
     return expr;
 }
 
-void Ast_DeleteTupleExpr(Expression* expression)
-{
-    Ast_DeleteExpressionList(expression->as.tupleExpr.elements);
-    free(expression);
-}
-
-Expression* Ast_NewIdentifierExpr(Token identifier, ExprContext context)
+Expression* Ast_NewIdentifierExpr(Arena* arena, Token identifier, ExprContext context)
 {
-    Expression* expr = xmalloc(sizeof(Expression));
+    Expression* expr = ARENA_ALLOCATE(arena, Expression, 1);
     if (!expr) {
         return NULL;
     }
@@ -905,14 +568,9 @@ Expression* Ast_NewIdentifierExpr(Token identifier, ExprContext context)
     return expr;
 }
 
-void Ast_DeleteIdentifierExpr(Expression* expression)
-{
-    free(expression);
-}
-
-ExpressionList* Ast_NewExpressionNode(Expression* expression)
+ExpressionList* Ast_NewExpressionNode(Arena* arena, Expression* expression)
 {
-    ExpressionList* list = xmalloc(sizeof(ExpressionList));
+    ExpressionList* list = ARENA_ALLOCATE(arena, ExpressionList, 1);
     if (!list) {
         return NULL;
     }
@@ -923,10 +581,10 @@ ExpressionList* Ast_NewExpressionNode(Expression* expression)
     return list;
 }
 
-void Ast_ExpressionListAppend(ExpressionList** list, Expression* expression)
+void Ast_ExpressionListAppend(Arena* arena, ExpressionList** list, Expression* expression)
 {
     if (!(*list)) {
-        *list = Ast_NewExpressionNode(expression);
+        *list = Ast_NewExpressionNode(arena, expression);
         return;
     }
 
@@ -935,21 +593,10 @@ void Ast_ExpressionListAppend(ExpressionList** list, Expression* expression)
         current = current->next;
     }
 
-    current->next = Ast_NewExpressionNode(expression);
+    current->next = Ast_NewExpressionNode(arena, expression);
     current->next->prev = current;
 }
 
-void Ast_DeleteExpressionList(ExpressionList* list)
-{
-    ExpressionList* current = list;
-    while (current != NULL) {
-        ExpressionList* next = current->next;
-        Ast_DeleteExpression(current->expression);
-        free(current);
-        current = next;
-    }
-}
-
 size_t Ast_ExpressionListLength(ExpressionList* list)
 {
     size_t length = 0;
@@ -976,9 +623,9 @@ ExpressionList* Ast_ExpressionListEnd(ExpressionList* list)
     }
 }
 
-ArgumentList* Ast_NewArgumentNode(Expression* expression)
+ArgumentList* Ast_NewArgumentNode(Arena* arena, Expression* expression)
 {
-    ArgumentList* list = xmalloc(sizeof(ArgumentList));
+    ArgumentList* list = ARENA_ALLOCATE(arena, ArgumentList, 1);
     if (!list) {
         return NULL;
     }
@@ -988,10 +635,10 @@ ArgumentList* Ast_NewArgumentNode(Expression* expression)
     return list;
 }
 
-void Ast_ArgumentListAppend(ArgumentList** list, Expression* expression)
+void Ast_ArgumentListAppend(Arena* arena, ArgumentList** list, Expression* expression)
 {
     if (!(*list)) {
-        *list = Ast_NewArgumentNode(expression);
+        *list = Ast_NewArgumentNode(arena, expression);
         return;
     }
 
@@ -1000,18 +647,7 @@ void Ast_ArgumentListAppend(ArgumentList** list, Expression* expression)
         current = current->next;
     }
 
-    current->next = Ast_NewArgumentNode(expression);
-}
-
-void Ast_DeleteArgumentList(ArgumentList* list)
-{
-    ArgumentList* current = list;
-    while (current != NULL) {
-        ArgumentList* next = current->next;
-        Ast_DeleteExpression(current->expression);
-        free(current);
-        current = next;
-    }
+    current->next = Ast_NewArgumentNode(arena, expression);
 }
 
 size_t Ast_ArgumentListLength(ArgumentList* list)
@@ -1027,23 +663,24 @@ size_t Ast_ArgumentListLength(ArgumentList* list)
     return length;
 }
 
-ParameterList* Ast_NewParameterNode(Token parameter)
+ParameterList* Ast_NewParameterNode(Arena* arena, Token parameter, Token annotation)
 {
-    ParameterList* list = xmalloc(sizeof(ParameterList));
+    ParameterList* list = ARENA_ALLOCATE(arena, ParameterList, 1);
     if (!list) {
         return NULL;
     }
 
     list->parameter = parameter;
+    list->annotation = annotation;
     list->prev = NULL;
     list->next = NULL;
     return list;
 }
 
-void Ast_ParameterListAppend(ParameterList** list, Token parameter)
+void Ast_ParameterListAppend(Arena* arena, ParameterList** list, Token parameter, Token annotation)
 {
     if (!(*list)) {
-        *list = Ast_NewParameterNode(parameter);
+        *list = Ast_NewParameterNode(arena, parameter, annotation);
         return;
     }
 
@@ -1052,20 +689,10 @@ void Ast_ParameterListAppend(ParameterList** list, Token parameter)
         current = current->next;
     }
 
-    current->next = Ast_NewParameterNode(parameter);
+    current->next = Ast_NewParameterNode(arena, parameter, annotation);
     current->next->prev = current;
 }
 
-void Ast_DeleteParameterList(ParameterList* list)
-{
-    ParameterList* current = list;
-    while (current != NULL) {
-        ParameterList* next = current->next;
-        free(current);
-        current = next;
-    }
-}
-
 size_t Ast_ParameterListLength(ParameterList* list)
 {
     size_t length = 0;
@@ -1092,9 +719,9 @@ ParameterList* Ast_ParameterListEnd(ParameterList* list)
     }
 }
 
-WhenEntry* Ast_NewWhenEntry(ExpressionList* cases, Statement* body)
+WhenEntry* Ast_NewWhenEntry(Arena* arena, ExpressionList* cases, Statement* body)
 {
-    WhenEntry* entry = xmalloc(sizeof(WhenEntry));
+    WhenEntry* entry = ARENA_ALLOCATE(arena, WhenEntry, 1);
     if (!entry) {
         return NULL;
     }
@@ -1104,16 +731,9 @@ WhenEntry* Ast_NewWhenEntry(ExpressionList* cases, Statement* body)
     return entry;
 }
 
-void Ast_DeleteWhenEntry(WhenEntry* entry)
-{
-    Ast_DeleteExpressionList(entry->cases);
-    Ast_DeleteStatement(entry->body);
-    free(entry);
-}
-
-WhenEntryList* Ast_NewWhenEntryNode(WhenEntry* entry)
+WhenEntryList* Ast_NewWhenEntryNode(Arena* arena, WhenEntry* entry)
 {
-    WhenEntryList* list = xmalloc(sizeof(WhenEntryList));
+    WhenEntryList* list = ARENA_ALLOCATE(arena, WhenEntryList, 1);
     if (!list) {
         return NULL;
     }
@@ -1123,10 +743,10 @@ WhenEntryList* Ast_NewWhenEntryNode(WhenEntry* entry)
     return list;
 }
 
-void Ast_WhenEntryListAppend(WhenEntryList** list, WhenEntry* entry)
+void Ast_WhenEntryListAppend(Arena* arena, WhenEntryList** list, WhenEntry* entry)
 {
     if (!(*list)) {
-        *list = Ast_NewWhenEntryNode(entry);
+        *list = Ast_NewWhenEntryNode(arena, entry);
         return;
     }
 
@@ -1135,18 +755,7 @@ void Ast_WhenEntryListAppend(WhenEntryList** list, WhenEntry* entry)
         current = current->next;
     }
 
-    current->next = Ast_NewWhenEntryNode(entry);
-}
-
-void Ast_DeleteWhenEntryList(WhenEntryList* list)
-{
-    WhenEntryList* current = list;
-    while (current != NULL) {
-        WhenEntryList* next = current->next;
-        Ast_DeleteWhenEntry(current->entry);
-        free(current);
-        current = next;
-    }
+    current->next = Ast_NewWhenEntryNode(arena, entry);
 }
 
 size_t Ast_WhenEntryListLength(WhenEntryList* list)
@@ -1162,9 +771,9 @@ size_t Ast_WhenEntryListLength(WhenEntryList* list)
     return length;
 }
 
-MapEntry* Ast_NewMapEntry(Expression* key, Expression* value)
+MapEntry* Ast_NewMapEntry(Arena* arena, Expression* key, Expression* value)
 {
-    MapEntry* entry = xmalloc(sizeof(MapEntry));
+    MapEntry* entry = ARENA_ALLOCATE(arena, MapEntry, 1);
     if (!entry) {
         return NULL;
     }
@@ -1174,16 +783,9 @@ MapEntry* Ast_NewMapEntry(Expression* key, Expression* value)
     return entry;
 }
 
-void Ast_DeleteMapEntry(MapEntry* entry)
+MapEntryList* Ast_NewMapEntryNode(Arena* arena, MapEntry* entry)
 {
-    Ast_DeleteExpression(entry->key);
-    Ast_DeleteExpression(entry->value);
-    free(entry);
-}
-
-MapEntryList* Ast_NewMapEntryNode(MapEntry* entry)
-{
-    MapEntryList* list = xmalloc(sizeof(MapEntryList));
+    MapEntryList* list = ARENA_ALLOCATE(arena, MapEntryList, 1);
     if (!list) {
         return NULL;
     }
@@ -1193,10 +795,10 @@ MapEntryList* Ast_NewMapEntryNode(MapEntry* entry)
     return list;
 }
 
-void Ast_MapEntryListAppend(MapEntryList** list, MapEntry* entry)
+void Ast_MapEntryListAppend(Arena* arena, MapEntryList** list, MapEntry* entry)
 {
     if (!(*list)) {
-        *list = Ast_NewMapEntryNode(entry);
+        *list = Ast_NewMapEntryNode(arena, entry);
         return;
     }
 
@@ -1205,18 +807,7 @@ void Ast_MapEntryListAppend(MapEntryList** list, MapEntry* entry)
         current = current->next;
     }
 
-    current->next = Ast_NewMapEntryNode(entry);
-}
-
-void Ast_DeleteMapEntryList(MapEntryList* list)
-{
-    MapEntryList* current = list;
-    while (current != NULL) {
-        MapEntryList* next = current->next;
-        Ast_DeleteMapEntry(current->entry);
-        free(current);
-        current = next;
-    }
+    current->next = Ast_NewMapEntryNode(arena, entry);
 }
 
 size_t Ast_MapEntryListLength(MapEntryList* list)
@@ -1232,9 +823,9 @@ size_t Ast_MapEntryListLength(MapEntryList* list)
     return length;
 }
 
-Block* Ast_NewBlock(DeclarationList* body)
+Block* Ast_NewBlock(Arena* arena, DeclarationList* body)
 {
-    Block* block = xmalloc(sizeof(Block));
+    Block* block = ARENA_ALLOCATE(arena, Block, 1);
     if (!block) {
         return NULL;
     }
@@ -1243,23 +834,9 @@ Block* Ast_NewBlock(DeclarationList* body)
     return block;
 }
 
-void Ast_DeleteBlock(Block* block)
-{
-    Ast_DeleteDeclarationList(block->body);
-    free(block);
-}
-
-void Ast_DeleteFunctionBody(FunctionBody* body)
-{
-    switch (body->notation) {
-        case FUNC_EXPRESSION: Ast_DeleteExpressionFunctionBody(body); return;
-        case FUNC_BLOCK: Ast_DeleteBlockFunctionBody(body); return;
-    }
-}
-
-FunctionBody* Ast_NewExpressionFunctionBody(Expression* expression)
+FunctionBody* Ast_NewExpressionFunctionBody(Arena* arena, Expression* expression)
 {
-    FunctionBody* body = xmalloc(sizeof(FunctionBody));
+    FunctionBody* body = ARENA_ALLOCATE(arena, FunctionBody, 1);
     if (!body) {
         return NULL;
     }
@@ -1269,15 +846,9 @@ FunctionBody* Ast_NewExpressionFunctionBody(Expression* expression)
     return body;
 }
 
-void Ast_DeleteExpressionFunctionBody(FunctionBody* body)
+FunctionBody* Ast_NewBlockFunctionBody(Arena* arena, Block* block)
 {
-    Ast_DeleteExpression(body->as.expression);
-    free(body);
-}
-
-FunctionBody* Ast_NewBlockFunctionBody(Block* block)
-{
-    FunctionBody* body = xmalloc(sizeof(FunctionBody));
+    FunctionBody* body = ARENA_ALLOCATE(arena, FunctionBody, 1);
     if (!body) {
         return NULL;
     }
@@ -1287,15 +858,9 @@ FunctionBody* Ast_NewBlockFunctionBody(Block* block)
     return body;
 }
 
-void Ast_DeleteBlockFunctionBody(FunctionBody* body)
-{
-    Ast_DeleteBlock(body->as.block);
-    free(body);
-}
-
-Function* Ast_NewFunction(ParameterList* parameters, FunctionBody* body)
+Function* Ast_NewFunction(Arena* arena, ParameterList* parameters, FunctionBody* body)
 {
-    Function* function = xmalloc(sizeof(Function));
+    Function* function = ARENA_ALLOCATE(arena, Function, 1);
     if (!function) {
         return NULL;
     }
@@ -1305,16 +870,9 @@ Function* Ast_NewFunction(ParameterList* parameters, FunctionBody* body)
     return function;
 }
 
-void Ast_DeleteFunction(Function* function)
+NamedFunction* Ast_NewNamedFunction(Arena* arena, Token identifier, Function* function, bool coroutine)
 {
-    Ast_DeleteParameterList(function->parameters);
-    Ast_DeleteFunctionBody(function->body);
-    free(function);
-}
-
-NamedFunction* Ast_NewNamedFunction(Token identifier, Function* function, bool coroutine)
-{
-    NamedFunction* namedFunction = xmalloc(sizeof(NamedFunction));
+    NamedFunction* namedFunction = ARENA_ALLOCATE(arena, NamedFunction, 1);
     if (!function) {
         return NULL;
     }
@@ -1325,15 +883,9 @@ NamedFunction* Ast_NewNamedFunction(Token identifier, Function* function, bool c
     return namedFunction;
 }
 
-void Ast_DeleteNamedFunction(NamedFunction* namedFunction)
-{
-    Ast_DeleteFunction(namedFunction->function);
-    free(namedFunction);
-}
-
-NamedFunctionList* Ast_NewNamedFunctionNode(NamedFunction* function)
+NamedFunctionList* Ast_NewNamedFunctionNode(Arena* arena, NamedFunction* function)
 {
-    NamedFunctionList* list = xmalloc(sizeof(NamedFunctionList));
+    NamedFunctionList* list = ARENA_ALLOCATE(arena, NamedFunctionList, 1);
     if (!list) {
         return NULL;
     }
@@ -1343,10 +895,10 @@ NamedFunctionList* Ast_NewNamedFunctionNode(NamedFunction* function)
     return list;
 }
 
-void Ast_NamedFunctionListAppend(NamedFunctionList** list, NamedFunction* function)
+void Ast_NamedFunctionListAppend(Arena* arena, NamedFunctionList** list, NamedFunction* function)
 {
     if (!(*list)) {
-        *list = Ast_NewNamedFunctionNode(function);
+        *list = Ast_NewNamedFunctionNode(arena, function);
         return;
     }
 
@@ -1355,18 +907,7 @@ void Ast_NamedFunctionListAppend(NamedFunctionList** list, NamedFunction* functi
         current = current->next;
     }
 
-    current->next = Ast_NewNamedFunctionNode(function);
-}
-
-void Ast_DeleteNamedFunctionList(NamedFunctionList* list)
-{
-    NamedFunctionList* current = list;
-    while (current != NULL) {
-        NamedFunctionList* next = current->next;
-        Ast_DeleteNamedFunction(current->function);
-        free(current);
-        current = next;
-    }
+    current->next = Ast_NewNamedFunctionNode(arena, function);
 }
 
 size_t Ast_NamedFunctionListLength(NamedFunctionList* list)
@@ -1382,9 +923,9 @@ size_t Ast_NamedFunctionListLength(NamedFunctionList* list)
     return length;
 }
 
-Method* Ast_NewMethod(bool isStatic, NamedFunction* namedFunction)
+Method* Ast_NewMethod(Arena* arena, bool isStatic, NamedFunction* namedFunction)
 {
-    Method* method = xmalloc(sizeof(Method));
+    Method* method = ARENA_ALLOCATE(arena, Method, 1);
     if (!method) {
         return NULL;
     }
@@ -1394,15 +935,9 @@ Method* Ast_NewMethod(bool isStatic, NamedFunction* namedFunction)
     return method;
 }
 
-void Ast_DeleteMethod(Method* method)
-{
-    Ast_DeleteNamedFunction(method->namedFunction);
-    free(method);
-}
-
-MethodList* Ast_NewMethodNode(Method* method)
+MethodList* Ast_NewMethodNode(Arena* arena, Method* method)
 {
-    MethodList* list = xmalloc(sizeof(MethodList));
+    MethodList* list = ARENA_ALLOCATE(arena, MethodList, 1);
     if (!list) {
         return NULL;
     }
@@ -1412,10 +947,10 @@ MethodList* Ast_NewMethodNode(Method* method)
     return list;
 }
 
-void Ast_MethodListAppend(MethodList** list, Method* method)
+void Ast_MethodListAppend(Arena* arena, MethodList** list, Method* method)
 {
     if (!(*list)) {
-        *list = Ast_NewMethodNode(method);
+        *list = Ast_NewMethodNode(arena, method);
         return;
     }
 
@@ -1424,18 +959,7 @@ void Ast_MethodListAppend(MethodList** list, Method* method)
         current = current->next;
     }
 
-    current->next = Ast_NewMethodNode(method);
-}
-
-void Ast_DeleteMethodList(MethodList* list)
-{
-    MethodList* current = list;
-    while (current != NULL) {
-        MethodList* next = current->next;
-        Ast_DeleteMethod(current->method);
-        free(current);
-        current = next;
-    }
+    current->next = Ast_NewMethodNode(arena, method);
 }
 
 size_t Ast_MethodListLength(MethodList* list)
@@ -1451,9 +975,9 @@ size_t Ast_MethodListLength(MethodList* list)
     return length;
 }
 
-DeclarationList* Ast_NewDeclarationNode(Declaration* declaration)
+DeclarationList* Ast_NewDeclarationNode(Arena* arena, Declaration* declaration)
 {
-    DeclarationList* list = xmalloc(sizeof(DeclarationList));
+    DeclarationList* list = ARENA_ALLOCATE(arena, DeclarationList, 1);
     if (!list) {
         return NULL;
     }
@@ -1463,10 +987,10 @@ DeclarationList* Ast_NewDeclarationNode(Declaration* declaration)
     return list;
 }
 
-void Ast_DeclarationListAppend(DeclarationList** list, Declaration* declaration)
+void Ast_DeclarationListAppend(Arena* arena, DeclarationList** list, Declaration* declaration)
 {
     if (!(*list)) {
-        *list = Ast_NewDeclarationNode(declaration);
+        *list = Ast_NewDeclarationNode(arena, declaration);
         return;
     }
 
@@ -1475,18 +999,7 @@ void Ast_DeclarationListAppend(DeclarationList** list, Declaration* declaration)
         current = current->next;
     }
 
-    current->next = Ast_NewDeclarationNode(declaration);
-}
-
-void Ast_DeleteDeclarationList(DeclarationList* list)
-{
-    DeclarationList* current = list;
-    while (current != NULL) {
-        DeclarationList* next = current->next;
-        Ast_DeleteDeclaration(current->declaration);
-        free(current);
-        current = next;
-    }
+    current->next = Ast_NewDeclarationNode(arena, declaration);
 }
 
 size_t Ast_DeclarationListLength(DeclarationList* list)
@@ -1502,43 +1015,35 @@ size_t Ast_DeclarationListLength(DeclarationList* list)
     return length;
 }
 
-VariableTarget* Ast_NewSingleVariableTarget(Token single)
+VariableTarget* Ast_NewSingleVariableTarget(Arena* arena, Token single, Token annotation)
 {
-    VariableTarget* target = xmalloc(sizeof(VariableTarget));
+    VariableTarget* target = ARENA_ALLOCATE(arena, VariableTarget, 1);
     if (!target) {
         return NULL;
     }
 
     target->type = VAR_SINGLE;
     target->as.single = single;
+    target->annotation = annotation;
     return target;
 }
 
-VariableTarget* Ast_NewUnpackVariableTarget(ParameterList* unpack)
+VariableTarget* Ast_NewUnpackVariableTarget(Arena* arena, ParameterList* unpack)
 {
-    VariableTarget* target = xmalloc(sizeof(VariableTarget));
+    VariableTarget* target = ARENA_ALLOCATE(arena, VariableTarget, 1);
     if (!target) {
         return NULL;
     }
 
     target->type = VAR_UNPACK;
     target->as.unpack = unpack;
+    target->annotation = Token_Empty();
     return target;
 }
 
-void Ast_DeleteVariableTarget(VariableTarget* target)
-{
-    switch (target->type) {
-        case VAR_SINGLE: break;
-        case VAR_UNPACK: Ast_DeleteParameterList(target->as.unpack); break;
-    }
-
-    free(target);
-}
-
-AssignmentTarget* Ast_NewSingleAssignmentTarget(Expression* single)
+AssignmentTarget* Ast_NewSingleAssignmentTarget(Arena* arena, Expression* single)
 {
-    AssignmentTarget* target = xmalloc(sizeof(AssignmentTarget));
+    AssignmentTarget* target = ARENA_ALLOCATE(arena, AssignmentTarget, 1);
     if (!target) {
         return NULL;
     }
@@ -1548,9 +1053,9 @@ AssignmentTarget* Ast_NewSingleAssignmentTarget(Expression* single)
     return target;
 }
 
-AssignmentTarget* Ast_NewUnpackAssignmentTarget(ExpressionList* unpack)
+AssignmentTarget* Ast_NewUnpackAssignmentTarget(Arena* arena, ExpressionList* unpack)
 {
-    AssignmentTarget* target = xmalloc(sizeof(AssignmentTarget));
+    AssignmentTarget* target = ARENA_ALLOCATE(arena, AssignmentTarget, 1);
     if (!target) {
         return NULL;
     }
@@ -1560,12 +1065,3 @@ AssignmentTarget* Ast_NewUnpackAssignmentTarget(ExpressionList* unpack)
     return target;
 }
 
-void Ast_DeleteAssignmentTarget(AssignmentTarget* target)
-{
-    switch (target->type) {
-        case VAR_SINGLE: break;
-        case VAR_UNPACK: Ast_DeleteExpressionList(target->as.unpack); break;
-    }
-
-    free(target);
-}
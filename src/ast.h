@@ -3,6 +3,8 @@
 
 #include "token.h"
 
+typedef struct Arena Arena;
+
 typedef struct Declaration Declaration;
 typedef struct DeclarationList DeclarationList;
 
@@ -97,6 +99,7 @@ typedef struct Statement {
 
     union {
         struct {
+            Token keyword;
             Declaration* initializer;
             Expression* condition;
             Expression* increment;
@@ -110,6 +113,7 @@ typedef struct Statement {
         } forInStmt;
 
         struct {
+            Token keyword;
             Expression* condition;
             Statement* body;
         } whileStmt;
@@ -134,6 +138,7 @@ typedef struct Statement {
         } whenStmt;
         
         struct {
+            Token keyword;
             Expression* condition;
             Statement* thenBranch;
             Statement* elseBranch;
@@ -349,6 +354,7 @@ typedef struct FunctionBody {
 
 typedef struct ParameterList {
     Token parameter;
+    Token annotation;
     ParameterList* prev;
     ParameterList* next;
 } ParameterList;
@@ -390,6 +396,7 @@ typedef struct VariableTarget {
         Token single;
         ParameterList* unpack;
     } as;
+    Token annotation;
 } VariableTarget;
 
 typedef struct AssignmentTarget {
@@ -400,169 +407,106 @@ typedef struct AssignmentTarget {
     } as;
 } AssignmentTarget;
 
-AST* Ast_NewTree(DeclarationList* body);
-void Ast_DeleteTree(AST* ast);
-
-void Ast_DeleteDeclaration(Declaration* declaration);
-Declaration* Ast_NewImportAllDecl(Expression* moduleName);
-Declaration* Ast_NewImportAsDecl(Expression* moduleName, Token alias);
-Declaration* Ast_NewImportForDecl(Expression* moduleName, ParameterList* names);
-void Ast_DeleteImportDecl(Declaration* declaration);
-Declaration* Ast_NewClassDecl(Token identifier, Token superclass, MethodList* body);
-void Ast_DeleteClassDecl(Declaration* declaration);
-Declaration* Ast_NewFunctionDecl(NamedFunction* function);
-void Ast_DeleteFunctionDecl(Declaration* declaration);
-Declaration* Ast_NewVariableDecl(VariableTarget* target, Expression* value);
-void Ast_DeleteVariableDecl(Declaration* declaration);
-Declaration* Ast_NewStatementDecl(Statement* statement);
-void Ast_DeleteStatementDecl(Declaration* declaration);
-
-void Ast_DeleteStatement(Statement* statement);
-Statement* Ast_NewForStmt(Declaration* initializer, Expression* condition, Expression* increment, Statement* body);
-void Ast_DeleteForStmt(Statement* statement);
-Statement* Ast_NewForInStmt(Declaration* element, Expression* collection, Statement* body);
-void Ast_DeleteForInStmt(Statement* statement);
-Statement* Ast_NewWhileStmt(Expression* condition, Statement* body);
-void ast_DeleteWhileStmt(Statement* statement);
-Statement* Ast_NewDoWhileStmt(Statement* body, Expression* condition);
-void Ast_DeleteDoWhileStmt(Statement* statement);
-Statement* Ast_NewBreakStmt(Token keyword);
-void Ast_DeleteBreakStmt(Statement* statement);
-Statement* Ast_NewContinueStmt(Token keyword);
-void Ast_DeleteContinueStmt(Statement* statement);
-Statement* Ast_NewWhenStmt(Expression* control, WhenEntryList* entries, Statement* elseBranch);
-void Ast_DeleteWhenStmt(Statement* statement);
-Statement* Ast_NewIfStmt(Expression* condition, Statement* thenBranch, Statement* elseBranch);
-void Ast_DeleteIfStmt(Statement* statement);
-Statement* Ast_NewReturnStmt(Token keyword, Expression* expression);
-void Ast_DeleteReturnStmt(Statement* statement);
-Statement* Ast_NewPrintStmt(Expression* expression);
-void Ast_DeletePrintStmt(Statement* statement);
-Statement* Ast_NewBlockStmt(Block* block);
-void Ast_DeleteBlockStmt(Statement* statement);
-Statement* Ast_NewExpressionStmt(Expression* expression);
-void Ast_DeleteExpressionStmt(Statement* statement);
-
-void Ast_DeleteExpression(Expression* expression);
-Expression* Ast_NewCallExpr(Expression* callee, ArgumentList* arguments);
-void Ast_DeleteCallExpr(Expression* expression);
-Expression* Ast_NewPropertyExpr(Expression* object, Token property, ExprContext context, bool safe);
-void Ast_DeletePropertyExpr(Expression* expression);
-Expression* Ast_NewSubscriptExpr(Expression* object, Expression* index, ExprContext context, bool safe);
-void Ast_DeleteSubscriptExpr(Expression* expression);
-Expression* Ast_NewSuperExpr(Token keyword, Token method);
-void Ast_DeleteSuperExpr(Expression* expression);
-Expression* Ast_NewAssignmentExpr(AssignmentTarget* target, Expression* value);
-void Ast_DeleteAssignmentExpr(Expression* expression);
-Expression* Ast_NewCompoundAssignmentExpr(AssignmentTarget* target, Token op, Expression* value);
-void Ast_DeleteCompoundAssignmentExpr(Expression* expression);
-Expression* Ast_NewCoroutineExpr(Token keyword, Expression* expression);
-void Ast_DeleteCoroutineExpr(Expression* expression);
-Expression* Ast_NewYieldExpr(Token keyword, Expression* expression);
-void Ast_DeleteYieldExpr(Expression* expression);
-Expression* Ast_NewLogicalExpr(Expression* left, Token op, Expression* right);
-void Ast_DeleteLogicalExpr(Expression* expression);
-Expression* Ast_NewConditionalExpr(Expression* condition, Expression* thenBranch, Expression* elseBranch);
-void Ast_DeleteConditionalExpr(Expression* expression);
-Expression* Ast_NewElvisExpr(Expression* left, Expression* right);
-void Ast_DeleteElvisExpr(Expression* expression);
-Expression* Ast_NewBinaryExpr(Expression* left, Token op, Expression* right);
-void Ast_DeleteBinaryExpr(Expression* expression);
-Expression* Ast_NewUnaryExpr(Token op, Expression* expression);
-void Ast_DeleteUnaryExpr(Expression* expression);
-Expression* Ast_NewPostfixIncExpr(Token op, Expression* expression);
-void Ast_DeletePostifxIncExpr(Expression* expression);
-Expression* Ast_NewPrefixIncExpr(Token op, Expression* expression);
-void Ast_DeletePrefixIncExpr(Expression* expression);
-Expression* Ast_NewLiteralExpr(Token value);
-void Ast_DeleteLiteralExpr(Expression* expression);
-Expression* Ast_NewStringInterpExpr(ExpressionList* values);
-void Ast_DeleteStringInterpExpr(Expression* expression);
-Expression* Ast_NewRangeExpr(Expression* begin, Expression* end, Expression* step);
-void Ast_DeleteRangeExpr(Expression* expression);
-Expression* Ast_NewLambdaExpr(Function* function);
-void Ast_DeleteLambdaExpr(Expression* expression);
-Expression* Ast_NewListExpr(ExpressionList* elements);
-void Ast_DeleteListExpr(Expression* expression);
-Expression* Ast_NewMapExpr(MapEntryList* entries);
-void Ast_DeleteMapExpr(Expression* expression);
-Expression* Ast_NewTupleExpr(ExpressionList* elements);
-void Ast_DeleteTupleExpr(Expression* expression);
-Expression* Ast_NewIdentifierExpr(Token identifier, ExprContext context);
-void Ast_DeleteIdentifierExpr(Expression* expression);
-
-ExpressionList* Ast_NewExpressionNode(Expression* expression);
-void Ast_ExpressionListAppend(ExpressionList** list, Expression* expression);
-void Ast_DeleteExpressionList(ExpressionList* list);
+AST* Ast_NewTree(Arena* arena, DeclarationList* body);
+
+Declaration* Ast_NewImportAllDecl(Arena* arena, Expression* moduleName);
+Declaration* Ast_NewImportAsDecl(Arena* arena, Expression* moduleName, Token alias);
+Declaration* Ast_NewImportForDecl(Arena* arena, Expression* moduleName, ParameterList* names);
+Declaration* Ast_NewClassDecl(Arena* arena, Token identifier, Token superclass, MethodList* body);
+Declaration* Ast_NewFunctionDecl(Arena* arena, NamedFunction* function);
+Declaration* Ast_NewVariableDecl(Arena* arena, VariableTarget* target, Expression* value);
+Declaration* Ast_NewStatementDecl(Arena* arena, Statement* statement);
+
+Statement* Ast_NewForStmt(Arena* arena, Token keyword, Declaration* initializer, Expression* condition, Expression* increment, Statement* body);
+Statement* Ast_NewForInStmt(Arena* arena, Declaration* element, Expression* collection, Statement* body);
+Statement* Ast_NewWhileStmt(Arena* arena, Token keyword, Expression* condition, Statement* body);
+Statement* Ast_NewDoWhileStmt(Arena* arena, Statement* body, Expression* condition);
+Statement* Ast_NewBreakStmt(Arena* arena, Token keyword);
+Statement* Ast_NewContinueStmt(Arena* arena, Token keyword);
+Statement* Ast_NewWhenStmt(Arena* arena, Expression* control, WhenEntryList* entries, Statement* elseBranch);
+Statement* Ast_NewIfStmt(Arena* arena, Token keyword, Expression* condition, Statement* thenBranch, Statement* elseBranch);
+Statement* Ast_NewReturnStmt(Arena* arena, Token keyword, Expression* expression);
+Statement* Ast_NewPrintStmt(Arena* arena, Expression* expression);
+Statement* Ast_NewBlockStmt(Arena* arena, Block* block);
+Statement* Ast_NewExpressionStmt(Arena* arena, Expression* expression);
+
+Expression* Ast_NewCallExpr(Arena* arena, Expression* callee, ArgumentList* arguments);
+Expression* Ast_NewPropertyExpr(Arena* arena, Expression* object, Token property, ExprContext context, bool safe);
+Expression* Ast_NewSubscriptExpr(Arena* arena, Expression* object, Expression* index, ExprContext context, bool safe);
+Expression* Ast_NewSuperExpr(Arena* arena, Token keyword, Token method);
+Expression* Ast_NewAssignmentExpr(Arena* arena, AssignmentTarget* target, Expression* value);
+Expression* Ast_NewCompoundAssignmentExpr(Arena* arena, AssignmentTarget* target, Token op, Expression* value);
+Expression* Ast_NewCoroutineExpr(Arena* arena, Token keyword, Expression* expression);
+Expression* Ast_NewYieldExpr(Arena* arena, Token keyword, Expression* expression);
+Expression* Ast_NewLogicalExpr(Arena* arena, Expression* left, Token op, Expression* right);
+Expression* Ast_NewConditionalExpr(Arena* arena, Expression* condition, Expression* thenBranch, Expression* elseBranch);
+Expression* Ast_NewElvisExpr(Arena* arena, Expression* left, Expression* right);
+Expression* Ast_NewBinaryExpr(Arena* arena, Expression* left, Token op, Expression* right);
+Expression* Ast_NewUnaryExpr(Arena* arena, Token op, Expression* expression);
+Expression* Ast_NewPostfixIncExpr(Arena* arena, Token op, Expression* expression);
+Expression* Ast_NewPrefixIncExpr(Arena* arena, Token op, Expression* expression);
+Expression* Ast_NewLiteralExpr(Arena* arena, Token value);
+Expression* Ast_NewStringInterpExpr(Arena* arena, ExpressionList* values);
+Expression* Ast_NewRangeExpr(Arena* arena, Expression* begin, Expression* end, Expression* step);
+Expression* Ast_NewLambdaExpr(Arena* arena, Function* function);
+Expression* Ast_NewListExpr(Arena* arena, ExpressionList* elements);
+Expression* Ast_NewMapExpr(Arena* arena, MapEntryList* entries);
+Expression* Ast_NewTupleExpr(Arena* arena, ExpressionList* elements);
+Expression* Ast_NewIdentifierExpr(Arena* arena, Token identifier, ExprContext context);
+
+ExpressionList* Ast_NewExpressionNode(Arena* arena, Expression* expression);
+void Ast_ExpressionListAppend(Arena* arena, ExpressionList** list, Expression* expression);
 size_t Ast_ExpressionListLength(ExpressionList* list);
 ExpressionList* Ast_ExpressionListEnd(ExpressionList* list);
 
-ArgumentList* Ast_NewArgumentNode(Expression* expression);
-void Ast_ArgumentListAppend(ArgumentList** list, Expression* expression);
-void Ast_DeleteArgumentList(ArgumentList* list);
+ArgumentList* Ast_NewArgumentNode(Arena* arena, Expression* expression);
+void Ast_ArgumentListAppend(Arena* arena, ArgumentList** list, Expression* expression);
 size_t Ast_ArgumentListLength(ArgumentList* list);
 
-ParameterList* Ast_NewParameterNode(Token parameter);
-void Ast_ParameterListAppend(ParameterList** list, Token parameter);
-void Ast_DeleteParameterList(ParameterList* list);
+ParameterList* Ast_NewParameterNode(Arena* arena, Token parameter, Token annotation);
+void Ast_ParameterListAppend(Arena* arena, ParameterList** list, Token parameter, Token annotation);
 size_t Ast_ParameterListLength(ParameterList* list);
 ParameterList* Ast_ParameterListEnd(ParameterList* list);
 
-WhenEntry* Ast_NewWhenEntry(ExpressionList* cases, Statement* body);
-void Ast_DeleteWhenEntry(WhenEntry* entry);
+WhenEntry* Ast_NewWhenEntry(Arena* arena, ExpressionList* cases, Statement* body);
 
-WhenEntryList* Ast_NewWhenEntryNode(WhenEntry* entry);
-void Ast_WhenEntryListAppend(WhenEntryList** list, WhenEntry* entry);
-void Ast_DeleteWhenEntryList(WhenEntryList* list);
+WhenEntryList* Ast_NewWhenEntryNode(Arena* arena, WhenEntry* entry);
+void Ast_WhenEntryListAppend(Arena* arena, WhenEntryList** list, WhenEntry* entry);
 size_t Ast_WhenEntryListLength(WhenEntryList* list);
 
-MapEntry* Ast_NewMapEntry(Expression* key, Expression* value);
-void Ast_DeleteMapEntry(MapEntry* entry);
+MapEntry* Ast_NewMapEntry(Arena* arena, Expression* key, Expression* value);
 
-MapEntryList* Ast_NewMapEntryNode(MapEntry* entry);
-void Ast_MapEntryListAppend(MapEntryList** list, MapEntry* entry);
-void Ast_DeleteMapEntryList(MapEntryList* list);
+MapEntryList* Ast_NewMapEntryNode(Arena* arena, MapEntry* entry);
+void Ast_MapEntryListAppend(Arena* arena, MapEntryList** list, MapEntry* entry);
 size_t Ast_MapEntryListLength(MapEntryList* list);
 
-Block* Ast_NewBlock(DeclarationList* body);
-void Ast_DeleteBlock(Block* block);
+Block* Ast_NewBlock(Arena* arena, DeclarationList* body);
 
-void Ast_DeleteFunctionBody(FunctionBody* body);
-FunctionBody* Ast_NewExpressionFunctionBody(Expression* expression);
-void Ast_DeleteExpressionFunctionBody(FunctionBody* body);
-FunctionBody* Ast_NewBlockFunctionBody(Block* block);
-void Ast_DeleteBlockFunctionBody(FunctionBody* body);
+FunctionBody* Ast_NewExpressionFunctionBody(Arena* arena, Expression* expression);
+FunctionBody* Ast_NewBlockFunctionBody(Arena* arena, Block* block);
 
-Function* Ast_NewFunction(ParameterList* parameters, FunctionBody* body);
-void Ast_DeleteFunction(Function* function);
+Function* Ast_NewFunction(Arena* arena, ParameterList* parameters, FunctionBody* body);
 
-NamedFunction* Ast_NewNamedFunction(Token identifier, Function* function, bool coroutine);
-void Ast_DeleteNamedFunction(NamedFunction* function);
+NamedFunction* Ast_NewNamedFunction(Arena* arena, Token identifier, Function* function, bool coroutine);
 
-NamedFunctionList* Ast_NewNamedFunctionNode(NamedFunction* function);
-void Ast_NamedFunctionListAppend(NamedFunctionList** list, NamedFunction* function);
-void Ast_DeleteNamedFunctionList(NamedFunctionList* list);
+NamedFunctionList* Ast_NewNamedFunctionNode(Arena* arena, NamedFunction* function);
+void Ast_NamedFunctionListAppend(Arena* arena, NamedFunctionList** list, NamedFunction* function);
 size_t Ast_NamedFunctionListLength(NamedFunctionList* list);
 
-Method* Ast_NewMethod(bool isStatic, NamedFunction* namedFunction);
-void Ast_DeleteMethod(Method* method);
+Method* Ast_NewMethod(Arena* arena, bool isStatic, NamedFunction* namedFunction);
 
-MethodList* Ast_NewMethodNode(Method* method);
-void Ast_MethodListAppend(MethodList** list, Method* method);
-void Ast_DeleteMethodList(MethodList* list);
+MethodList* Ast_NewMethodNode(Arena* arena, Method* method);
+void Ast_MethodListAppend(Arena* arena, MethodList** list, Method* method);
 size_t Ast_MethodListLength(MethodList* list);
 
-DeclarationList* Ast_NewDeclarationNode(Declaration* declaration);
-void Ast_DeclarationListAppend(DeclarationList** list, Declaration* declaration);
-void Ast_DeleteDeclarationList(DeclarationList* list);
+DeclarationList* Ast_NewDeclarationNode(Arena* arena, Declaration* declaration);
+void Ast_DeclarationListAppend(Arena* arena, DeclarationList** list, Declaration* declaration);
 size_t Ast_DeclarationListLength(DeclarationList* list);
 
-VariableTarget* Ast_NewSingleVariableTarget(Token single);
-VariableTarget* Ast_NewUnpackVariableTarget(ParameterList* unpack);
-void Ast_DeleteVariableTarget(VariableTarget* target);
+VariableTarget* Ast_NewSingleVariableTarget(Arena* arena, Token single, Token annotation);
+VariableTarget* Ast_NewUnpackVariableTarget(Arena* arena, ParameterList* unpack);
 
-AssignmentTarget* Ast_NewSingleAssignmentTarget(Expression* single);
-AssignmentTarget* Ast_NewUnpackAssignmentTarget(ExpressionList* unpack);
-void Ast_DeleteAssignmentTarget(AssignmentTarget* target);
+AssignmentTarget* Ast_NewSingleAssignmentTarget(Arena* arena, Expression* single);
+AssignmentTarget* Ast_NewUnpackAssignmentTarget(Arena* arena, ExpressionList* unpack);
 
 #endif
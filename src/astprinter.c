@@ -89,6 +89,14 @@ static void print_token(Token token)
     printf("'%.*s'", (int)token.length, token.start);
 }
 
+static void print_annotation(Token annotation)
+{
+    if (annotation.type != TOKEN_NONE) {
+        printf(": ");
+        print_token(annotation);
+    }
+}
+
 static void print_token_field(int indent, const char* fieldName, Token token)
 {
     print_indented(indent, "%s: ", fieldName);
@@ -823,6 +831,7 @@ void print_parameter_list_inline(ParameterList* list)
     ParameterList* current = list;
     while (current) {
         print_token(current->parameter);
+        print_annotation(current->annotation);
         if (current = current->next) {
             printf(", ");
         }
@@ -910,6 +919,7 @@ void print_variable_target(int indent, VariableTarget* target)
     switch (target->type) {
         case VAR_SINGLE: {
             print_token(target->as.single);
+            print_annotation(target->annotation);
             break;
         }
         case VAR_UNPACK: {
@@ -49,26 +49,45 @@ void Chunk_Write(VM* vm, Chunk* chunk, uint8_t byte, int line)
     append_line(vm, &chunk->lines, line);
 }
 
-uint8_t Chunk_AddConst(VM* vm, Chunk* chunk, Value constant)
+uint32_t Chunk_AddConst(VM* vm, Chunk* chunk, Value constant)
 {
     Vm_PushTemporary(vm, constant);
     VECTOR_PUSH(&vm->gc, ValueArray, &chunk->constants, Value, constant);
     Vm_PopTemporary(vm);
-    return (uint8_t)(chunk->constants.count - 1);
+    return (uint32_t)(chunk->constants.count - 1);
 }
 
+#define SHRINK_ARRAY(gc, type, pointer, count, capacity)                                            \
+    do {                                                                                            \
+        if ((count) == 0) {                                                                         \
+            FREE_ARRAY(gc, type, pointer, capacity);                                                \
+            (pointer) = NULL;                                                                       \
+        } else if ((count) < (capacity)) {                                                          \
+            (pointer) = GROW_ARRAY(gc, type, pointer, capacity, count);                             \
+        }                                                                                           \
+        (capacity) = (count);                                                                       \
+    } while (0)                                                                                     \
+
+void Chunk_Compact(VM* vm, Chunk* chunk)
+{
+    SHRINK_ARRAY(&vm->gc, uint8_t, chunk->code, chunk->count, chunk->capacity);
+    SHRINK_ARRAY(&vm->gc, Line, chunk->lines.data, chunk->lines.count, chunk->lines.capacity);
+    SHRINK_ARRAY(&vm->gc, Value, chunk->constants.data, chunk->constants.count, chunk->constants.capacity);
+}
+
+#undef SHRINK_ARRAY
+
 int Chunk_GetLine(Chunk* chunk, size_t offset)
 {
-    size_t index = 0;
     size_t span = 0;
 
-    while (true) {
+    for (size_t index = 0; index < chunk->lines.count; index++) {
         span += chunk->lines.data[index].count;
 
         if (span > offset) {
             return chunk->lines.data[index].number;
         }
-
-        index++;
     }
+
+    return -1;
 }
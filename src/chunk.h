@@ -28,7 +28,8 @@ void Chunk_Init(Chunk* chunk);
 void Chunk_Free(GC* gc, Chunk* chunk);
 
 void Chunk_Write(VM* vm, Chunk* chunk, uint8_t byte, int line);
-uint8_t Chunk_AddConst(VM* vm, Chunk* chunk, Value constant);
+uint32_t Chunk_AddConst(VM* vm, Chunk* chunk, Value constant);
+void Chunk_Compact(VM* vm, Chunk* chunk);
 
 int Chunk_GetLine(Chunk* chunk, size_t offset);
 
@@ -15,6 +15,8 @@
 
 #define UINT8_COUNT (UINT8_MAX + 1)
 
+#define FILE_EXTENSION ".archer"
+
 typedef enum {
     ERR_USAGE = 64,
     ERR_DATA = 65,
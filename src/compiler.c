@@ -12,6 +12,10 @@
 #include "chunk.h"
 #include "parser.h"
 #include "memory.h"
+#include "arena.h"
+#include "analysis.h"
+#include "optimizer.h"
+#include "obj_map.h"
 
 #if DEBUG_PRINT_CODE
 #include "disassembler.h"
@@ -21,10 +25,17 @@
 #include "astprinter.h"
 #endif
 
+#define WHEN_DISPATCH_MIN_CASES 4
+#define WHEN_JUMP_TABLE_MAX 1024
+
+typedef enum { KIND_ANY, KIND_NUMBER } ValueKind;
+
 typedef struct {
     Token identifier;
     int scopeDepth;
     bool captured;
+    bool immutable;
+    ValueKind kind;
 } Local;
 
 typedef struct {
@@ -45,6 +56,7 @@ typedef struct ControlBlock {
     size_t start;
     size_t end;
     ControlBreak* breaks;
+    ControlBreak* continues;
 } ControlBlock;
 
 typedef enum {
@@ -59,6 +71,7 @@ typedef enum {
 
 typedef struct Compiler {
     VM* vm;
+    Arena* arena;
 
     struct Compiler* enclosing;
 
@@ -67,14 +80,33 @@ typedef struct Compiler {
     ObjectFunction* function;
     CompilerType type;
 
+    Table constants;
+
     ControlBlock* controlBlock;
 
     Local locals[UINT8_COUNT];
     int localCount;
 
     Upvalue upvalues[UINT8_COUNT];
+    Upvalue captures[UINT8_COUNT];
     int scopeDepth;
 
+    AssignedNames* assigned;
+
+    //Where the module's source starts and ends, and what profiles call the module, to find the sites of its tokens
+    const char* source;
+    const char* sourceEnd;
+    const char* profileFile;
+
+    //Parameters that operators were only seen to be given numbers, and those that they were also given anything else
+    uint32_t numberParameters;
+    uint32_t mixedParameters;
+    uint64_t numberUses;
+
+    ColdBlock* coldBlocks;
+    size_t coldBlockCount;
+    size_t coldBlockCapacity;
+
     Token token;
 
     bool error;
@@ -87,8 +119,6 @@ typedef struct ClassCompiler {
     bool hasSuperclass;
 } ClassCompiler;
 
-static void compile_tree(Compiler* compiler, AST* ast);
-
 static void compile_declaration(Compiler* compiler, Declaration* decl);
 static void compile_import_decl(Compiler* compiler, Declaration* decl);
 static void compile_class_decl(Compiler* compiler, Declaration* decl);
@@ -111,6 +141,7 @@ static void compile_block_stmt(Compiler* compiler, Statement* stmt);
 static void compile_expression_stmt(Compiler* compiler, Statement* stmt);
 
 static void compile_expression(Compiler* compiler, Expression* expr);
+static void compile_discarded_expression(Compiler* compiler, Expression* expr);
 static void compile_call_expr(Compiler* compiler, Expression* expr);
 static void compile_property_expr(Compiler* compiler, Expression* expr);
 static void compile_subscript_expr(Compiler* compiler, Expression* expr);
@@ -137,6 +168,7 @@ static void compile_identifier_expr(Compiler* compiler, Expression* expr);
 
 static void compile_when_entry(Compiler* compiler, WhenEntry* entry);
 static size_t compile_when_entry_list(Compiler* compiler, WhenEntryList* list);
+static bool compile_when_dispatch(Compiler* compiler, WhenEntryList* list, Statement* elseBranch);
 static void compile_map_entry(Compiler* compiler, MapEntry* entry);
 static size_t compile_map_entry_list(Compiler* compiler, MapEntryList* list);
 static void compile_block(Compiler* compiler, Block* block);
@@ -149,12 +181,27 @@ static size_t compile_argument_list(Compiler* compiler, ArgumentList* list);
 static size_t compile_expression_list(Compiler* compiler, ExpressionList* list);
 static size_t compile_declaration_list(Compiler* compiler, DeclarationList* list);
 
-static void compiler_init(Compiler* compiler, VM* vm, CompilerType type, Token identifier, ObjectModule* mod)
+static void compiler_init(Compiler* compiler, VM* vm, Arena* arena, CompilerType type, Token identifier, ObjectModule* mod)
 {
     compiler->enclosing = vm->compiler;
     vm->compiler = compiler;
 
+    compiler->assigned = compiler->enclosing ? compiler->enclosing->assigned : NULL;
+
+    compiler->source = compiler->enclosing ? compiler->enclosing->source : NULL;
+    compiler->sourceEnd = compiler->enclosing ? compiler->enclosing->sourceEnd : NULL;
+    compiler->profileFile = compiler->enclosing ? compiler->enclosing->profileFile : NULL;
+
+    compiler->numberParameters = 0;
+    compiler->mixedParameters = 0;
+    compiler->numberUses = 0;
+
+    compiler->coldBlocks = NULL;
+    compiler->coldBlockCount = 0;
+    compiler->coldBlockCapacity = 0;
+
     compiler->vm = vm;
+    compiler->arena = arena;
 
     compiler->controlBlock = NULL;
 
@@ -163,6 +210,8 @@ static void compiler_init(Compiler* compiler, VM* vm, CompilerType type, Token i
     compiler->function = Function_New(vm);
     compiler->type = type;
 
+    Table_Init(&compiler->constants);
+
     compiler->localCount = 0;
     compiler->scopeDepth = 0;
 
@@ -179,9 +228,13 @@ static void compiler_init(Compiler* compiler, VM* vm, CompilerType type, Token i
         compiler->function->name = String_Copy(vm, identifier.start, identifier.length);
     }
 
+    GC_WRITE_BARRIER(&vm->gc, compiler->function);
+
     Local* local = &compiler->locals[compiler->localCount++];
     local->scopeDepth = 0;
     local->captured = false;
+    local->immutable = true;
+    local->kind = KIND_ANY;
 
     if (type == TYPE_METHOD || type == TYPE_STATIC_METHOD || type == TYPE_INITIALIZER || type == TYPE_STATIC_INITIALIZER) {
         local->identifier.start = "this";
@@ -261,20 +314,78 @@ static void emit_return(Compiler* compiler)
     emit_byte(compiler, OP_RETURN);
 }
 
-static uint8_t make_constant(Compiler* compiler, Value value)
+static bool constants_identical(Value a, Value b)
+{
+    if (IS_NUMBER(a) && IS_NUMBER(b)) {
+        double x = AS_NUMBER(a);
+        double y = AS_NUMBER(b);
+        return memcmp(&x, &y, sizeof(double)) == 0;
+    }
+
+    return Value_Equal(a, b);
+}
+
+static uint16_t make_constant(Compiler* compiler, Value value)
 {
-    int constant = Chunk_AddConst(compiler->vm, current_chunk(compiler), value);
-    if (constant > UINT8_MAX) {
+    Chunk* chunk = current_chunk(compiler);
+
+    Value existing;
+    if (Table_Get(&compiler->constants, value, &existing)) {
+        uint32_t index = (uint32_t)AS_NUMBER(existing);
+        if (constants_identical(chunk->constants.data[index], value)) {
+            return (uint16_t)index;
+        }
+    }
+
+    uint32_t constant = Chunk_AddConst(compiler->vm, chunk, value);
+    GC_WRITE_BARRIER(&compiler->vm->gc, compiler->function);
+    if (constant > UINT16_MAX) {
         error(compiler, "Too many constants in one chunk.");
         return 0;
     }
 
-    return (uint8_t)constant;
+    Table_Put(compiler->vm, &compiler->constants, value, NUMBER_VAL((double)constant));
+    return (uint16_t)constant;
+}
+
+static OpCode long_instruction(OpCode instruction)
+{
+    switch (instruction) {
+        case OP_LOAD_CONSTANT: return OP_LOAD_CONSTANT_LONG;
+        case OP_DEFINE_GLOBAL: return OP_DEFINE_GLOBAL_LONG;
+        case OP_LOAD_GLOBAL: return OP_LOAD_GLOBAL_LONG;
+        case OP_STORE_GLOBAL: return OP_STORE_GLOBAL_LONG;
+        case OP_CLOSURE: return OP_CLOSURE_LONG;
+        case OP_CLASS: return OP_CLASS_LONG;
+        case OP_LOAD_PROPERTY: return OP_LOAD_PROPERTY_LONG;
+        case OP_LOAD_PROPERTY_SAFE: return OP_LOAD_PROPERTY_SAFE_LONG;
+        case OP_STORE_PROPERTY: return OP_STORE_PROPERTY_LONG;
+        case OP_STORE_PROPERTY_SAFE: return OP_STORE_PROPERTY_SAFE_LONG;
+        case OP_METHOD: return OP_METHOD_LONG;
+        case OP_STATIC_METHOD: return OP_STATIC_METHOD_LONG;
+        case OP_INVOKE: return OP_INVOKE_LONG;
+        case OP_INVOKE_SAFE: return OP_INVOKE_SAFE_LONG;
+        case OP_GET_SUPER: return OP_GET_SUPER_LONG;
+        case OP_SUPER_INVOKE: return OP_SUPER_INVOKE_LONG;
+        case OP_IMPORT_BY_NAME: return OP_IMPORT_BY_NAME_LONG;
+        default: return instruction;
+    }
+}
+
+static void emit_constant_instruction(Compiler* compiler, OpCode instruction, uint16_t constant)
+{
+    if (constant <= UINT8_MAX) {
+        emit_bytes(compiler, instruction, (uint8_t)constant);
+    } else {
+        emit_byte(compiler, long_instruction(instruction));
+        emit_byte(compiler, (constant >> 0) & 0xFF);
+        emit_byte(compiler, (constant >> 8) & 0xFF);
+    }
 }
 
 static void emit_constant(Compiler* compiler, Value value)
 {
-    emit_bytes(compiler, OP_LOAD_CONSTANT, make_constant(compiler, value));
+    emit_constant_instruction(compiler, OP_LOAD_CONSTANT, make_constant(compiler, value));
 }
 
 static void emit_loop(Compiler* compiler, size_t loopStart, uint8_t instruction)
@@ -304,23 +415,87 @@ static void patch_jump(Compiler* compiler, size_t offset)
 
 static void patch_breaks(Compiler* compiler, ControlBreak* breaks)
 {
-    ControlBreak* current = breaks;
-    while (current) {
-        ControlBreak* next = current->enclosing;
+    for (ControlBreak* current = breaks; current != NULL; current = current->enclosing) {
         patch_jump(compiler, current->address);
-        free(current);
-        current = next;
     }
 }
 
+//Only tokens that come from the module's source have a site, as the compiler makes up a few of its own
+static bool site_column(Compiler* compiler, Token token, int* column)
+{
+    if (!compiler->profileFile || token.start < compiler->source || token.start >= compiler->sourceEnd) {
+        return false;
+    }
+
+    const char* lineStart = token.start;
+    while (lineStart > compiler->source && lineStart[-1] != '\n') {
+        lineStart--;
+    }
+
+    *column = (int)(token.start - lineStart) + 1;
+    return true;
+}
+
+static void emit_profiling(Compiler* compiler, OpCode instruction, SiteKind kind, Token token)
+{
+    Profile* profile = compiler->vm->recordedProfile;
+    int column;
+    if (!profile || !site_column(compiler, token, &column)) {
+        return;
+    }
+
+    //Sites beyond what the instruction can name are not recorded
+    uint32_t site = Profile_AddSite(profile, compiler->profileFile, kind, token.line, column);
+    if (site <= UINT16_MAX) {
+        emit_byte(compiler, instruction);
+        emit_bytes(compiler, (site >> 0) & 0xFF, (site >> 8) & 0xFF);
+    }
+}
+
+static ProfileSite* profiled_site(Compiler* compiler, SiteKind kind, Token token)
+{
+    Profile* profile = compiler->vm->usedProfile;
+    int column;
+    if (!profile || !site_column(compiler, token, &column)) {
+        return NULL;
+    }
+
+    ProfileSite* site = Profile_FindSite(profile, compiler->profileFile, kind, token.line, column);
+    return site && site->counts[0] + site->counts[1] >= PROFILE_HOT_COUNT ? site : NULL;
+}
+
+static void push_cold_block(Compiler* compiler, size_t start, size_t end)
+{
+    if (compiler->coldBlockCount == compiler->coldBlockCapacity) {
+        compiler->coldBlockCapacity = compiler->coldBlockCapacity < 8 ? 8 : compiler->coldBlockCapacity * 2;
+        compiler->coldBlocks = xrealloc(compiler->coldBlocks, sizeof(ColdBlock) * compiler->coldBlockCapacity);
+    }
+
+    compiler->coldBlocks[compiler->coldBlockCount++] = (ColdBlock) { .start = start, .end = end };
+}
+
 static ObjectFunction* finish_compilation(VM* vm)
 {
     emit_return(vm->compiler);
     ObjectFunction* function = vm->compiler->function;
 
+    Table_Free(&vm->gc, &vm->compiler->constants);
+
+    if (!vm->compiler->error) {
+        ChunkLayout layout;
+        layout.entry = function->numberParameters != 0 ? &function->specialisedEntry : NULL;
+        layout.coldBlocks = vm->compiler->coldBlocks;
+        layout.coldBlockCount = vm->compiler->coldBlockCount;
+        Optimizer_OptimizeChunk(vm, vm->compiler->arena, &function->chunk, &layout);
+    }
+
+    free(vm->compiler->coldBlocks);
+
+    Chunk_Compact(vm, &function->chunk);
+
 #if DEBUG_PRINT_CODE
     if (!vm->compiler->error) {
-        disassemble_chunk(current_chunk(vm->compiler), function->name->chars);
+        Disassembler_DisChunk(current_chunk(vm->compiler), function->name->chars);
     }
 #endif
 
@@ -330,7 +505,7 @@ static ObjectFunction* finish_compilation(VM* vm)
 
 static ControlBreak* make_control_break(Compiler* compiler, size_t address, ControlBreak* enclosing)
 {
-    ControlBreak* controlBreak = xmalloc(sizeof(ControlBreak));
+    ControlBreak* controlBreak = ARENA_ALLOCATE(compiler->arena, ControlBreak, 1);
     if (!controlBreak) {
         return NULL;
     }
@@ -356,21 +531,20 @@ static void push_control_break_to_block(Compiler* compiler, size_t address, Cont
 
 static void push_control_block(Compiler* compiler, ControlType type, size_t start, size_t end)
 {
-    ControlBlock* block = xmalloc(sizeof(ControlBlock));
+    ControlBlock* block = ARENA_ALLOCATE(compiler->arena, ControlBlock, 1);
     block->type = type;
     block->start = start;
     block->end = end;
     block->enclosing = compiler->controlBlock;
     block->breaks = NULL;
+    block->continues = NULL;
 
     compiler->controlBlock = block;
 }
 
 static void pop_control_block(Compiler* compiler)
 {
-    ControlBlock* next = compiler->controlBlock->enclosing;
-    free(compiler->controlBlock);
-    compiler->controlBlock = next;
+    compiler->controlBlock = compiler->controlBlock->enclosing;
 }
 
 static void enter_control_block(Compiler* compiler, ControlType type, size_t start, size_t end)
@@ -378,6 +552,12 @@ static void enter_control_block(Compiler* compiler, ControlType type, size_t sta
     push_control_block(compiler, type, start, end);
 }
 
+static void patch_continues(Compiler* compiler)
+{
+    compiler->controlBlock->start = current_chunk(compiler)->count;
+    patch_breaks(compiler, compiler->controlBlock->continues);
+}
+
 static void exit_control_block(Compiler* compiler)
 {
     compiler->controlBlock->end = current_chunk(compiler)->count;
@@ -430,10 +610,10 @@ static void initialize_local_relative(Compiler* compiler, int n)
     }
 }
 
-static void define_variable(Compiler* compiler, uint8_t global)
+static void define_variable(Compiler* compiler, uint16_t global)
 {
     if (compiler->scopeDepth == 0) {
-        emit_bytes(compiler, OP_DEFINE_GLOBAL, global);
+        emit_constant_instruction(compiler, OP_DEFINE_GLOBAL, global);
     } else {
         initialize_local(compiler);
     }
@@ -450,6 +630,8 @@ static void add_local(Compiler* compiler, Token identifier)
     local->identifier = identifier;
     local->scopeDepth = -1;
     local->captured = false;
+    local->immutable = compiler->assigned != NULL && !Analysis_IsAssigned(compiler->assigned, &identifier);
+    local->kind = KIND_ANY;
 }
 
 static int resolve_local(Compiler* compiler, Token* identifier)
@@ -490,7 +672,29 @@ static int add_upvalue(Compiler* compiler, uint8_t index, bool isLocal)
     return (int)compiler->function->upvalueCount++;
 }
 
-static int resolve_upvalue(Compiler* compiler, Token* identifier)
+static int add_capture(Compiler* compiler, uint8_t index, bool isLocal)
+{
+    size_t captureCount = compiler->function->captureCount;
+
+    for (size_t i = 0; i < captureCount; i++) {
+        Upvalue* capture = &compiler->captures[i];
+        if (capture->index == index && capture->isLocal == isLocal) {
+            return (int)i;
+        }
+    }
+
+    if (captureCount == UINT8_COUNT) {
+        error(compiler, "Too many closure variables in function.");
+        return 0;
+    }
+
+    compiler->captures[captureCount].isLocal = isLocal;
+    compiler->captures[captureCount].index = index;
+    return (int)compiler->function->captureCount++;
+}
+
+//Locals that are never reassigned are copied into the closure instead of being shared through an upvalue
+static int resolve_upvalue(Compiler* compiler, Token* identifier, bool* byValue)
 {
     if (!compiler->enclosing) {
         return -1;
@@ -498,13 +702,19 @@ static int resolve_upvalue(Compiler* compiler, Token* identifier)
 
     int local = resolve_local(compiler->enclosing, identifier);
     if (local != -1) {
-        compiler->enclosing->locals[local].captured = true;
+        Local* captured = &compiler->enclosing->locals[local];
+        *byValue = captured->immutable;
+        if (*byValue) {
+            return add_capture(compiler, (uint8_t)local, true);
+        }
+
+        captured->captured = true;
         return add_upvalue(compiler, (uint8_t)local, true);
     }
 
-    int upvalue = resolve_upvalue(compiler->enclosing, identifier);
+    int upvalue = resolve_upvalue(compiler->enclosing, identifier, byValue);
     if (upvalue != -1) {
-        return add_upvalue(compiler, (uint8_t)upvalue, false);
+        return *byValue ? add_capture(compiler, (uint8_t)upvalue, false) : add_upvalue(compiler, (uint8_t)upvalue, false);
     }
 
     return -1;
@@ -530,12 +740,12 @@ static void declare_local_variable(Compiler* compiler, Token identifier)
     add_local(compiler, identifier);
 }
 
-static uint8_t make_identifier_constant(Compiler* compiler, Token identifier)
+static uint16_t make_identifier_constant(Compiler* compiler, Token identifier)
 {
     return make_constant(compiler, OBJ_VAL(String_Copy(compiler->vm, identifier.start, identifier.length)));
 }
 
-static uint8_t declare_variable(Compiler* compiler, Token identifier)
+static uint16_t declare_variable(Compiler* compiler, Token identifier)
 {
     if (compiler->scopeDepth == 0) {
         return make_identifier_constant(compiler, identifier);
@@ -545,26 +755,104 @@ static uint8_t declare_variable(Compiler* compiler, Token identifier)
     }
 }
 
-static void named_variable(Compiler* compiler, Token identifier, ExprContext context)
+static ValueKind annotation_kind(Compiler* compiler, Token annotation)
+{
+    if (annotation.type == TOKEN_NONE) {
+        return KIND_ANY;
+    }
+
+    compiler->token = annotation;
+    if (compiler->scopeDepth == 0) {
+        error(compiler, "Only local variables and parameters can have type annotations.");
+        return KIND_ANY;
+    }
+
+    Token number = Token_Synthetic("Number");
+    if (Token_LexemesEqual(&annotation, &number)) {
+        return KIND_NUMBER;
+    }
+
+    error(compiler, "Unknown type in annotation.");
+    return KIND_ANY;
+}
+
+//Mirrors the way variables are resolved, but without capturing anything along the way
+static ValueKind variable_kind(Compiler* compiler, Token* identifier)
+{
+    for (Compiler* current = compiler; current != NULL; current = current->enclosing) {
+        for (int i = current->localCount - 1; i >= 0; i--) {
+            if (Token_LexemesEqual(identifier, &current->locals[i].identifier)) {
+                return current->locals[i].kind;
+            }
+        }
+    }
+
+    return KIND_ANY;
+}
+
+static bool is_number_expr(Compiler* compiler, Expression* expr)
+{
+    switch (expr->type) {
+        case EXPR_LITERAL: return expr->as.literalExpr.value.type == TOKEN_NUMBER;
+        case EXPR_IDENTIFIER: return variable_kind(compiler, &expr->as.identifierExpr.identifier) == KIND_NUMBER;
+        case EXPR_PREFIX_INC:
+        case EXPR_POSTFIX_INC: return true;
+        case EXPR_UNARY: return expr->as.unaryExpr.op.type != TOKEN_BANG;
+        case EXPR_CONDITIONAL: {
+            return is_number_expr(compiler, expr->as.conditionalExpr.thenBranch)
+                && is_number_expr(compiler, expr->as.conditionalExpr.elseBranch);
+        }
+        case EXPR_BINARY: {
+            //Apart from addition, which also concatenates strings, arithmetic either yields a number or fails
+            switch (expr->as.binaryExpr.op.type) {
+                case TOKEN_PLUS: {
+                    return is_number_expr(compiler, expr->as.binaryExpr.left)
+                        || is_number_expr(compiler, expr->as.binaryExpr.right);
+                }
+                case TOKEN_MINUS:
+                case TOKEN_STAR:
+                case TOKEN_SLASH:
+                case TOKEN_PERCENT:
+                case TOKEN_DOUBLE_STAR:
+                case TOKEN_AMPERSAND:
+                case TOKEN_PIPE:
+                case TOKEN_CARET:
+                case TOKEN_L_SHIFT:
+                case TOKEN_R_SHIFT: return true;
+                default: return false;
+            }
+        }
+        default: return false;
+    }
+}
+
+static void emit_variable_access(Compiler* compiler, Token identifier, ExprContext context)
 {
     int scope = -1;
-    uint8_t operation;
+    bool byValue = false;
+    OpCode operation;
 
     if ((scope = resolve_local(compiler, &identifier)) != -1) {
         operation = context == LOAD ? OP_LOAD_LOCAL : OP_STORE_LOCAL;
-    } else if ((scope = resolve_upvalue(compiler, &identifier)) != -1) {
-        operation = context == LOAD ? OP_LOAD_UPVALUE : OP_STORE_UPVALUE;
+    } else if ((scope = resolve_upvalue(compiler, &identifier, &byValue)) != -1) {
+        operation = context == LOAD ? (byValue ? OP_LOAD_CAPTURE : OP_LOAD_UPVALUE) : OP_STORE_UPVALUE;
     } else {
         scope = make_identifier_constant(compiler, identifier);
         operation = context == LOAD ? OP_LOAD_GLOBAL : OP_STORE_GLOBAL;
+        emit_constant_instruction(compiler, operation, (uint16_t)scope);
+        return;
     }
     
     emit_bytes(compiler, operation, (uint8_t)scope);
 }
 
-void compile_tree(Compiler* compiler, AST* ast)
+static void named_variable(Compiler* compiler, Token identifier, ExprContext context)
 {
-    compile_declaration_list(compiler, ast->body);
+    if (context == STORE && variable_kind(compiler, &identifier) == KIND_NUMBER) {
+        emit_byte(compiler, OP_CHECK_NUMBER);
+    }
+
+    emit_variable_access(compiler, identifier, context);
 }
 
 void compile_declaration(Compiler* compiler, Declaration* decl)
@@ -583,6 +871,16 @@ void compile_declaration(Compiler* compiler, Declaration* decl)
 void compile_import_decl(Compiler* compiler, Declaration* decl)
 {
     compile_expression(compiler, decl->as.importDecl.moduleName);
+
+    //A namespace only needs its module executed once one of its fields is used
+    if (decl->as.importDecl.type == IMPORT_AS) {
+        emit_byte(compiler, OP_IMPORT_LAZY);
+
+        uint16_t global = declare_variable(compiler, decl->as.importDecl.with.alias);
+        define_variable(compiler, global);
+        return;
+    }
+
     emit_byte(compiler, OP_IMPORT_MODULE);
     emit_byte(compiler, OP_POP);
 
@@ -592,17 +890,14 @@ void compile_import_decl(Compiler* compiler, Declaration* decl)
             break;
         }
         case IMPORT_AS: {
-            uint8_t global = declare_variable(compiler, decl->as.importDecl.with.alias);
-            define_variable(compiler, global);
             break;
         }
         case IMPORT_FOR: {
             emit_byte(compiler, OP_SAVE_MODULE);
             for (ParameterList* current = decl->as.importDecl.with.names; current != NULL; current = current->next) {
-                emit_byte(compiler, OP_IMPORT_BY_NAME);
-                emit_byte(compiler, make_identifier_constant(compiler, current->parameter));
+                emit_constant_instruction(compiler, OP_IMPORT_BY_NAME, make_identifier_constant(compiler, current->parameter));
 
-                uint8_t global = declare_variable(compiler, current->parameter);
+                uint16_t global = declare_variable(compiler, current->parameter);
                 define_variable(compiler, global);
             }
             break;
@@ -616,7 +911,7 @@ static void compile_method(Compiler* compiler, Method* method)
 
     Token identifier = function->identifier;
     compiler->token = identifier;
-    uint8_t name = make_identifier_constant(compiler, identifier);
+    uint16_t name = make_identifier_constant(compiler, identifier);
 
     CompilerType type = method->isStatic ? TYPE_STATIC_METHOD : TYPE_METHOD;
     if (identifier.length == 4 && memcmp(identifier.start, "init", 4) == 0) {
@@ -624,18 +919,18 @@ static void compile_method(Compiler* compiler, Method* method)
     }
 
     compile_named_function(compiler, function, type);
-    emit_bytes(compiler, method->isStatic ? OP_STATIC_METHOD : OP_METHOD, name);
+    emit_constant_instruction(compiler, method->isStatic ? OP_STATIC_METHOD : OP_METHOD, name);
 }
 
 void compile_class_decl(Compiler* compiler, Declaration* decl)
 {
     Token identifier = decl->as.classDecl.identifier;
     compiler->token = identifier;
-    uint8_t name = make_identifier_constant(compiler, identifier);
+    uint16_t name = make_identifier_constant(compiler, identifier);
 
     declare_local_variable(compiler, identifier);
 
-    emit_bytes(compiler, OP_CLASS, name);
+    emit_constant_instruction(compiler, OP_CLASS, name);
     define_variable(compiler, name);
 
     ClassCompiler classCompiler = { .name = identifier, .enclosing = compiler->vm->classCompiler, .hasSuperclass = false };
@@ -677,16 +972,32 @@ void compile_function_decl(Compiler* compiler, Declaration* decl)
 {
     Token identifier = decl->as.functionDecl.function->identifier;
     compiler->token = identifier;
-    uint8_t global = declare_variable(compiler, identifier);
+    uint16_t global = declare_variable(compiler, identifier);
     initialize_local(compiler);
+
+    //The function may refer to itself before its closure is stored, so it must see the variable by reference
+    if (compiler->scopeDepth == 0) {
+        compile_named_function(compiler, decl->as.functionDecl.function, TYPE_FUNCTION);
+        define_variable(compiler, global);
+        return;
+    }
+
+    Local* local = top_local(compiler);
+    bool immutable = local->immutable;
+    local->immutable = false;
+
     compile_named_function(compiler, decl->as.functionDecl.function, TYPE_FUNCTION);
     define_variable(compiler, global);
+
+    local->immutable = immutable;
 }
 
 static void compile_single_variable_decl(Compiler* compiler, Declaration* decl, Token identifier)
 {
+    ValueKind kind = annotation_kind(compiler, decl->as.variableDecl.target->annotation);
+
     compiler->token = identifier;
-    uint8_t global = declare_variable(compiler, identifier);
+    uint16_t global = declare_variable(compiler, identifier);
 
     Expression* value = decl->as.variableDecl.value;
     if (value) {
@@ -695,7 +1006,20 @@ static void compile_single_variable_decl(Compiler* compiler, Declaration* decl,
         emit_byte(compiler, OP_LOAD_NIL);
     }
 
+    if (kind == KIND_NUMBER && !(value && is_number_expr(compiler, value))) {
+        emit_byte(compiler, OP_CHECK_NUMBER);
+    }
+
     define_variable(compiler, global);
+
+    if (compiler->scopeDepth != 0) {
+        top_local(compiler)->kind = kind;
+    }
+}
+
+static bool is_tuple_literal(Expression* expr, size_t length)
+{
+    return expr->type == EXPR_TUPLE && Ast_ExpressionListLength(expr->as.tupleExpr.elements) == length;
 }
 
 static void unpack_tuple(Compiler* compiler, Expression* tuple, size_t length)
@@ -707,6 +1031,12 @@ static void unpack_tuple(Compiler* compiler, Expression* tuple, size_t length)
         return;
     }
 
+    //A tuple literal can leave its elements on the stack directly instead of being built and taken apart
+    if (is_tuple_literal(tuple, length)) {
+        compile_expression_list(compiler, tuple->as.tupleExpr.elements);
+        return;
+    }
+
     compile_expression(compiler, tuple);
     emit_bytes(compiler, OP_TUPLE_UNPACK, (uint8_t)length);
 }
@@ -718,7 +1048,7 @@ static void compile_multiple_variable_decl(Compiler* compiler, Declaration* decl
         error(compiler, "Cannot unpack into more than 255 variables.");
     }
 
-    uint8_t* globals = xmalloc(length);
+    uint16_t* globals = ARENA_ALLOCATE(compiler->arena, uint16_t, length);
     size_t i = 0;
     for (ParameterList* current = identifiers; current != NULL; current = current->next) {
         compiler->token = current->parameter;
@@ -729,7 +1059,7 @@ static void compile_multiple_variable_decl(Compiler* compiler, Declaration* decl
 
     if (compiler->scopeDepth == 0) {
         for (int i = (int)length - 1; i >= 0; i--) {
-            emit_bytes(compiler, OP_DEFINE_GLOBAL, globals[i]);
+            emit_constant_instruction(compiler, OP_DEFINE_GLOBAL, globals[i]);
         }
     } else {
         for (int i = 0; i < (int)length; i++) {
@@ -737,7 +1067,14 @@ static void compile_multiple_variable_decl(Compiler* compiler, Declaration* decl
         }
     }
 
-    free(globals);
+    int slot = compiler->localCount - (int)length;
+    for (ParameterList* current = identifiers; current != NULL; current = current->next, slot++) {
+        ValueKind kind = annotation_kind(compiler, current->annotation);
+        if (kind == KIND_NUMBER) {
+            compiler->locals[slot].kind = kind;
+            emit_bytes(compiler, OP_CHECK_NUMBER_LOCAL, (uint8_t)slot);
+        }
+    }
 }
 
 void compile_variable_decl(Compiler* compiler, Declaration* decl)
@@ -773,6 +1110,34 @@ void compile_statement(Compiler* compiler, Statement* stmt)
     }
 }
 
+//Inverting a loop saves a jump on every iteration but costs one every time the loop is entered, which does not pay
+//off for loops that a profile found to usually be left before their body runs
+static bool loop_rarely_repeats(Compiler* compiler, Token keyword)
+{
+    ProfileSite* site = profiled_site(compiler, SITE_BRANCH, keyword);
+    return site && site->counts[0] < site->counts[1];
+}
+
+static void compile_top_tested_loop(Compiler* compiler, ControlType type, Token keyword, Expression* condition, Statement* body, Expression* increment)
+{
+    size_t loopStart = current_chunk(compiler)->count;
+    compile_expression(compiler, condition);
+    emit_profiling(compiler, OP_PROFILE_BRANCH, SITE_BRANCH, keyword);
+    size_t exitJump = emit_jump(compiler, OP_POP_JUMP_IF_FALSE);
+
+    enter_control_block(compiler, type, loopStart, 0xFFFF);
+    compile_statement(compiler, body);
+
+    patch_continues(compiler);
+    if (increment) {
+        compile_discarded_expression(compiler, increment);
+    }
+
+    emit_loop(compiler, loopStart, OP_LOOP);
+    patch_jump(compiler, exitJump);
+    exit_control_block(compiler);
+}
+
 void compile_for_stmt(Compiler* compiler, Statement* stmt)
 {
     begin_scope(compiler);
@@ -782,37 +1147,40 @@ void compile_for_stmt(Compiler* compiler, Statement* stmt)
         compile_declaration(compiler, initializer);
     }
 
-    size_t loopStart = current_chunk(compiler)->count;
-    size_t exitJump = -1;
+    Token keyword = stmt->as.forStmt.keyword;
+    if (stmt->as.forStmt.condition && loop_rarely_repeats(compiler, keyword)) {
+        compile_top_tested_loop(compiler, CONTROL_FOR, keyword, stmt->as.forStmt.condition, stmt->as.forStmt.body, stmt->as.forStmt.increment);
+        end_scope(compiler);
+        return;
+    }
 
+    //The loop is inverted: the condition is tested after the body, and entered once through a jump
     Expression* condition = stmt->as.forStmt.condition;
+    size_t conditionJump = -1;
     if (condition) {
-        compile_expression(compiler, condition);
-        exitJump = emit_jump(compiler, OP_POP_JUMP_IF_FALSE);
-    }
-
-    Expression* increment = stmt->as.forStmt.increment;
-    if (increment) {
-        size_t bodyJump = emit_jump(compiler, OP_JUMP);
-
-        size_t incrementStart = current_chunk(compiler)->count;
-        compile_expression(compiler, increment);
-        emit_byte(compiler, OP_POP);
-
-        emit_loop(compiler, loopStart, OP_LOOP);
-        loopStart = incrementStart;
-        patch_jump(compiler, bodyJump);
+        conditionJump = emit_jump(compiler, OP_JUMP);
     }
 
-    enter_control_block(compiler, CONTROL_FOR, loopStart, 0xFFFF);
+    size_t bodyStart = current_chunk(compiler)->count;
+    enter_control_block(compiler, CONTROL_FOR, bodyStart, 0xFFFF);
 
     Statement* body = stmt->as.forStmt.body;
     compile_statement(compiler, body);
 
-    emit_loop(compiler, loopStart, OP_LOOP);
+    patch_continues(compiler);
+
+    Expression* increment = stmt->as.forStmt.increment;
+    if (increment) {
+        compile_discarded_expression(compiler, increment);
+    }
 
-    if (exitJump != -1) {
-        patch_jump(compiler, exitJump);
+    if (condition) {
+        patch_jump(compiler, conditionJump);
+        compile_expression(compiler, condition);
+        emit_profiling(compiler, OP_PROFILE_BRANCH, SITE_BRANCH, keyword);
+        emit_loop(compiler, bodyStart, OP_POP_LOOP_IF_TRUE);
+    } else {
+        emit_loop(compiler, bodyStart, OP_LOOP);
     }
 
     exit_control_block(compiler);
@@ -825,6 +1193,9 @@ static void declare_for_in_variable(Compiler* compiler, Token identifier)
     emit_byte(compiler, OP_LOAD_NIL);
     declare_local_variable(compiler, identifier);
     initialize_local(compiler);
+
+    //The same slot is overwritten on every iteration
+    top_local(compiler)->immutable = false;
 }
 
 static void for_in_declare_elements(Compiler* compiler, VariableTarget* target)
@@ -832,13 +1203,15 @@ static void for_in_declare_elements(Compiler* compiler, VariableTarget* target)
     if (target->type == VAR_UNPACK) {
         for (ParameterList* current = target->as.unpack; current != NULL; current = current->next) {
             declare_for_in_variable(compiler, current->parameter);
+            top_local(compiler)->kind = annotation_kind(compiler, current->annotation);
         }
     } else {
         declare_for_in_variable(compiler, target->as.single);
+        top_local(compiler)->kind = annotation_kind(compiler, target->annotation);
     }
 }
 
-static void for_in_store_elements(Compiler* compiler, VariableTarget* target)
+static void for_in_store_elements(Compiler* compiler, VariableTarget* target, bool numbers)
 {
     if (target->type == VAR_UNPACK) {
         uint8_t count = (uint8_t)Ast_ParameterListLength(target->as.unpack);
@@ -847,12 +1220,51 @@ static void for_in_store_elements(Compiler* compiler, VariableTarget* target)
             named_variable(compiler, current->parameter, STORE);
             emit_byte(compiler, OP_POP);
         }
+    } else if (numbers) {
+        //Range counters are validated once before the loop, so the per-iteration type guard is redundant
+        emit_variable_access(compiler, target->as.single, STORE);
+        emit_byte(compiler, OP_POP);
     } else {
         named_variable(compiler, target->as.single, STORE);
         emit_byte(compiler, OP_POP);
     }
 }
 
+static void add_hidden_local(Compiler* compiler)
+{
+    add_local(compiler, Token_Empty());
+    initialize_local(compiler);
+}
+
+static OpCode for_in_begin_iteration(Compiler* compiler, Expression* collection)
+{
+    //Literal ranges keep counter, end and step on the stack instead of allocating a range and its iterator
+    if (collection->type == EXPR_RANGE) {
+        compile_expression(compiler, collection->as.rangeExpr.begin);
+        add_hidden_local(compiler);
+        compile_expression(compiler, collection->as.rangeExpr.end);
+        add_hidden_local(compiler);
+
+        if (collection->as.rangeExpr.step) {
+            compile_expression(compiler, collection->as.rangeExpr.step);
+        } else {
+            emit_constant(compiler, NUMBER_VAL(1.0f));
+        }
+        add_hidden_local(compiler);
+
+        emit_byte(compiler, OP_RANGE_COUNTER);
+        return OP_FOR_RANGE;
+    }
+
+    //The iterable and its iteration state occupy two hidden slots
+    compile_expression(compiler, collection);
+    add_hidden_local(compiler);
+    emit_byte(compiler, OP_ITERATOR);
+    add_hidden_local(compiler);
+
+    return OP_FOR_ITERATOR;
+}
+
 void compile_for_in_stmt(Compiler* compiler, Statement* stmt)
 {
     begin_scope(compiler);
@@ -863,15 +1275,12 @@ void compile_for_in_stmt(Compiler* compiler, Statement* stmt)
     for_in_declare_elements(compiler, target);
 
     Expression* collection = stmt->as.forInStmt.collection;
-    compile_expression(compiler, collection);
-    emit_byte(compiler, OP_ITERATOR);
-    add_local(compiler, Token_Empty());
-    initialize_local(compiler);
+    OpCode iteration = for_in_begin_iteration(compiler, collection);
 
     size_t loopStart = current_chunk(compiler)->count;
-    size_t exitJump = emit_jump(compiler, OP_FOR_ITERATOR);
+    size_t exitJump = emit_jump(compiler, iteration);
 
-    for_in_store_elements(compiler, target);
+    for_in_store_elements(compiler, target, collection->type == EXPR_RANGE);
 
     enter_control_block(compiler, CONTROL_FOR_IN, loopStart, 0xFFFF);
 
@@ -887,19 +1296,29 @@ void compile_for_in_stmt(Compiler* compiler, Statement* stmt)
 
 void compile_while_stmt(Compiler* compiler, Statement* stmt)
 {
-    size_t loopStart = current_chunk(compiler)->count;
-    push_control_block(compiler, CONTROL_WHILE, loopStart, 0xFFFF);
+    Token keyword = stmt->as.whileStmt.keyword;
+    if (loop_rarely_repeats(compiler, keyword)) {
+        compile_top_tested_loop(compiler, CONTROL_WHILE, keyword, stmt->as.whileStmt.condition, stmt->as.whileStmt.body, NULL);
+        return;
+    }
 
-    Expression* condition = stmt->as.whileStmt.condition;
-    compile_expression(compiler, condition);
+    //The loop is inverted: the condition is tested after the body, and entered once through a jump
+    size_t conditionJump = emit_jump(compiler, OP_JUMP);
 
-    size_t exitJump = emit_jump(compiler, OP_POP_JUMP_IF_FALSE);
+    size_t bodyStart = current_chunk(compiler)->count;
+    push_control_block(compiler, CONTROL_WHILE, bodyStart, 0xFFFF);
 
     Statement* body = stmt->as.whileStmt.body;
     compile_statement(compiler, body);
 
-    emit_loop(compiler, loopStart, OP_LOOP);
-    patch_jump(compiler, exitJump);
+    patch_continues(compiler);
+    patch_jump(compiler, conditionJump);
+
+    Expression* condition = stmt->as.whileStmt.condition;
+    compile_expression(compiler, condition);
+    emit_profiling(compiler, OP_PROFILE_BRANCH, SITE_BRANCH, keyword);
+
+    emit_loop(compiler, bodyStart, OP_POP_LOOP_IF_TRUE);
 
     exit_control_block(compiler);
 }
@@ -925,6 +1344,11 @@ static bool block_is_loop(ControlBlock* block)
     return block->type == CONTROL_FOR || block->type == CONTROL_FOR_IN || block->type == CONTROL_WHILE || block->type == CONTROL_DO_WHILE;
 }
 
+static bool continues_after_body(ControlBlock* block)
+{
+    return block->type == CONTROL_FOR || block->type == CONTROL_WHILE;
+}
+
 static ControlBlock* closest_loop(Compiler* compiler)
 {
     ControlBlock* block = compiler->controlBlock;
@@ -961,6 +1385,9 @@ void compile_continue_stmt(Compiler* compiler, Statement* stmt)
     ControlBlock* block = closest_loop(compiler);
     if (!block) {
         error(compiler, "Cannot use 'continue' outside of a loop.");
+    } else if (continues_after_body(block)) {
+        size_t address = emit_jump(compiler, OP_JUMP);
+        block->continues = make_control_break(compiler, address, block->continues);
     } else {
         emit_loop(compiler, block->start, OP_LOOP);
     }
@@ -975,11 +1402,16 @@ void compile_when_stmt(Compiler* compiler, Statement* stmt)
     compile_expression(compiler, control);
 
     WhenEntryList* entries = stmt->as.whenStmt.entries;
+    Statement* elseBranch = stmt->as.whenStmt.elseBranch;
+    if (compile_when_dispatch(compiler, entries, elseBranch)) {
+        exit_control_block(compiler);
+        return;
+    }
+
     compile_when_entry_list(compiler, entries);
 
-    Statement* elseBranch = stmt->as.whenStmt.elseBranch;
+    emit_byte(compiler, OP_POP);
     if (elseBranch) {
-        emit_byte(compiler, OP_POP);
         compile_statement(compiler, elseBranch);
     }
 
@@ -991,6 +1423,9 @@ void compile_if_stmt(Compiler* compiler, Statement* stmt)
     Expression* condition = stmt->as.ifStmt.condition;
     compile_expression(compiler, condition);
 
+    Token keyword = stmt->as.ifStmt.keyword;
+    emit_profiling(compiler, OP_PROFILE_BRANCH, SITE_BRANCH, keyword);
+
     size_t thenJump = emit_jump(compiler, OP_JUMP_IF_FALSE);
     emit_byte(compiler, OP_POP);
 
@@ -1000,16 +1435,39 @@ void compile_if_stmt(Compiler* compiler, Statement* stmt)
     size_t elseJump = emit_jump(compiler, OP_JUMP);
 
     patch_jump(compiler, thenJump);
+    size_t elseStart = current_chunk(compiler)->count;
     emit_byte(compiler, OP_POP);
 
     Statement* elseBranch = stmt->as.ifStmt.elseBranch;
     if (elseBranch) {
         compile_statement(compiler, elseBranch);
+
+        //An else branch that a profile found to be rarely taken is moved out of the way of the other one
+        ProfileSite* site = profiled_site(compiler, SITE_BRANCH, keyword);
+        if (site && site->counts[0] >= PROFILE_BIAS * (double)(site->counts[0] + site->counts[1])) {
+            push_cold_block(compiler, elseStart, current_chunk(compiler)->count);
+        }
     }
 
     patch_jump(compiler, elseJump);
 }
 
+static void emit_value_return(Compiler* compiler, Expression* value)
+{
+    //Returning a tuple literal lets a caller that unpacks the result take the values without the tuple
+    if (value->type == EXPR_TUPLE) {
+        size_t count = Ast_ExpressionListLength(value->as.tupleExpr.elements);
+        if (count > 0 && count <= 255) {
+            compile_expression_list(compiler, value->as.tupleExpr.elements);
+            emit_bytes(compiler, OP_RETURN_TUPLE, (uint8_t)count);
+            return;
+        }
+    }
+
+    compile_expression(compiler, value);
+    emit_byte(compiler, OP_RETURN);
+}
+
 void compile_return_stmt(Compiler* compiler, Statement* stmt)
 {
     compiler->token = stmt->as.returnStmt.keyword;
@@ -1023,8 +1481,7 @@ void compile_return_stmt(Compiler* compiler, Statement* stmt)
         if (compiler->type == TYPE_INITIALIZER || compiler->type == TYPE_STATIC_INITIALIZER) {
             error(compiler, "Cannot return a value from an initializer.");
         }
-        compile_expression(compiler, value);
-        emit_byte(compiler, OP_RETURN);
+        emit_value_return(compiler, value);
     } else {
         emit_return(compiler);
     }
@@ -1045,8 +1502,7 @@ void compile_block_stmt(Compiler* compiler, Statement* stmt)
 
 void compile_expression_stmt(Compiler* compiler, Statement* stmt)
 {
-    compile_expression(compiler, stmt->as.expression);
-    emit_byte(compiler, OP_POP);
+    compile_discarded_expression(compiler, stmt->as.expression);
 }
 
 void compile_expression(Compiler* compiler, Expression* expr)
@@ -1090,10 +1546,10 @@ static void compile_invocation(Compiler* compiler, Expression* expr)
 
     Token property = callee->as.propertyExpr.property;
     compiler->token = property;
-    uint8_t name = make_identifier_constant(compiler, property);
+    uint16_t name = make_identifier_constant(compiler, property);
 
     bool safe = callee->as.propertyExpr.safe;
-    emit_bytes(compiler, safe ? OP_INVOKE_SAFE : OP_INVOKE , name);
+    emit_constant_instruction(compiler, safe ? OP_INVOKE_SAFE : OP_INVOKE, name);
     emit_byte(compiler, argumentCount);
 }
 
@@ -1114,7 +1570,7 @@ static void compile_super_invocation(Compiler* compiler, Expression* expr)
 
     Token method = callee->as.superExpr.method;
     compiler->token = method;
-    uint8_t name = make_identifier_constant(compiler, method);
+    uint16_t name = make_identifier_constant(compiler, method);
 
     named_variable(compiler, Token_Synthetic("this"), LOAD);
 
@@ -1122,7 +1578,7 @@ static void compile_super_invocation(Compiler* compiler, Expression* expr)
     uint8_t argumentCount = (uint8_t)compile_argument_list(compiler, arguments);
 
     named_variable(compiler, Token_Synthetic("super"), LOAD);
-    emit_bytes(compiler, OP_SUPER_INVOKE, name);
+    emit_constant_instruction(compiler, OP_SUPER_INVOKE, name);
     emit_byte(compiler, argumentCount);
 }
 
@@ -1150,12 +1606,12 @@ void compile_property_expr(Compiler* compiler, Expression* expr)
 
     Token property = expr->as.propertyExpr.property;
     compiler->token = property;
-    uint8_t name = make_identifier_constant(compiler, property);
+    uint16_t name = make_identifier_constant(compiler, property);
 
     ExprContext context = expr->as.propertyExpr.context;
     bool safe = expr->as.propertyExpr.safe;
-    uint8_t operation = context == LOAD ? (safe ? OP_LOAD_PROPERTY_SAFE : OP_LOAD_PROPERTY) : (safe ? OP_STORE_PROPERTY_SAFE : OP_STORE_PROPERTY);
-    emit_bytes(compiler, operation, name);
+    OpCode operation = context == LOAD ? (safe ? OP_LOAD_PROPERTY_SAFE : OP_LOAD_PROPERTY) : (safe ? OP_STORE_PROPERTY_SAFE : OP_STORE_PROPERTY);
+    emit_constant_instruction(compiler, operation, name);
 }
 
 void compile_subscript_expr(Compiler* compiler, Expression* expr)
@@ -1187,11 +1643,19 @@ void compile_super_expr(Compiler* compiler, Expression* expr)
 
     Token method = expr->as.superExpr.method;
     compiler->token = method;
-    uint8_t name = make_identifier_constant(compiler, method);
+    uint16_t name = make_identifier_constant(compiler, method);
 
     named_variable(compiler, Token_Synthetic("this"), LOAD);
     named_variable(compiler, Token_Synthetic("super"), LOAD);
-    emit_bytes(compiler, OP_GET_SUPER, name);
+    emit_constant_instruction(compiler, OP_GET_SUPER, name);
+}
+
+static void store_unpacked_values(Compiler* compiler, ExpressionList* targets)
+{
+    for (ExpressionList* current = Ast_ExpressionListEnd(targets); current != NULL; current = current->prev) {
+        compile_expression(compiler, current->expression);
+        emit_byte(compiler, OP_POP);
+    }
 }
 
 static void compile_assignment_target(Compiler* compiler, AssignmentTarget* target)
@@ -1202,19 +1666,67 @@ static void compile_assignment_target(Compiler* compiler, AssignmentTarget* targ
         emit_byte(compiler, OP_DUP);
         emit_bytes(compiler, OP_TUPLE_UNPACK, count);
 
-        for (ExpressionList* current = Ast_ExpressionListEnd(target->as.unpack); current != NULL; current = current->prev) {
-            compile_expression(compiler, current->expression);
-            emit_byte(compiler, OP_POP);
-        }
+        store_unpacked_values(compiler, target->as.unpack);
     } else {
         compile_expression(compiler, target->as.single);
     }
 }
 
+//Compiles an expression whose value is not used, which lets unpacking of tuple literals skip the tuple
+static void compile_discarded_expression(Compiler* compiler, Expression* expr)
+{
+    if (expr->type == EXPR_ASSIGNMENT) {
+        AssignmentTarget* target = expr->as.assignmentExpr.target;
+        Expression* value = expr->as.assignmentExpr.value;
+        if (target->type == VAR_UNPACK && is_tuple_literal(value, Ast_ExpressionListLength(target->as.unpack))) {
+            compile_expression_list(compiler, value->as.tupleExpr.elements);
+            store_unpacked_values(compiler, target->as.unpack);
+            return;
+        }
+    }
+
+    compile_expression(compiler, expr);
+    emit_byte(compiler, OP_POP);
+}
+
 void compile_assignment_expr(Compiler* compiler, Expression* expr)
 {
-    compile_expression(compiler, expr->as.assignmentExpr.value);
-    compile_assignment_target(compiler, expr->as.assignmentExpr.target);
+    Expression* value = expr->as.assignmentExpr.value;
+    compile_expression(compiler, value);
+
+    //Values that are known to be numbers can be stored into typed variables without checking them again
+    AssignmentTarget* target = expr->as.assignmentExpr.target;
+    if (target->type == VAR_SINGLE && target->as.single->type == EXPR_IDENTIFIER && is_number_expr(compiler, value)) {
+        Token identifier = target->as.single->as.identifierExpr.identifier;
+        compiler->token = identifier;
+        emit_variable_access(compiler, identifier, STORE);
+        return;
+    }
+
+    compile_assignment_target(compiler, target);
+}
+
+static OpCode number_opcode(OpCode instruction)
+{
+    switch (instruction) {
+        case OP_GREATER: return OP_GREATER_NUMBER;
+        case OP_GREATER_EQUAL: return OP_GREATER_EQUAL_NUMBER;
+        case OP_LESS: return OP_LESS_NUMBER;
+        case OP_LESS_EQUAL: return OP_LESS_EQUAL_NUMBER;
+        case OP_NEGATE: return OP_NEGATE_NUMBER;
+        case OP_INC: return OP_INC_NUMBER;
+        case OP_DEC: return OP_DEC_NUMBER;
+        case OP_ADD: return OP_ADD_NUMBER;
+        case OP_SUBTRACT: return OP_SUBTRACT_NUMBER;
+        case OP_MULTIPLY: return OP_MULTIPLY_NUMBER;
+        case OP_DIVIDE: return OP_DIVIDE_NUMBER;
+        default: return instruction;
+    }
+}
+
+static void emit_arithmetic(Compiler* compiler, OpCode instruction, bool numbers)
+{
+    emit_byte(compiler, numbers ? number_opcode(instruction) : instruction);
 }
 
 static OpCode compound_opcode(Token op)
@@ -1241,13 +1753,17 @@ static void compile_compound_identifier_assignment(Compiler* compiler, Expressio
     compiler->token = identifier;
     named_variable(compiler, identifier, LOAD);
 
-    compile_expression(compiler, expr->as.compoundAssignmentExpr.value);
+    Expression* value = expr->as.compoundAssignmentExpr.value;
+    compile_expression(compiler, value);
+
+    //Any arithmetic on a number that does not fail yields a number, so the result needs no guard
+    bool typed = variable_kind(compiler, &identifier) == KIND_NUMBER;
 
     Token op = expr->as.compoundAssignmentExpr.op;
     compiler->token = op;
-    emit_byte(compiler, compound_opcode(op));
+    emit_arithmetic(compiler, compound_opcode(op), typed && is_number_expr(compiler, value));
 
-    named_variable(compiler, identifier, STORE);
+    emit_variable_access(compiler, identifier, STORE);
 }
 
 static void compile_compound_property_assignment(Compiler* compiler, Expression* expr, Expression* target)
@@ -1259,8 +1775,8 @@ static void compile_compound_property_assignment(Compiler* compiler, Expression*
 
     Token property = target->as.propertyExpr.property;
     compiler->token = property;
-    uint8_t name = make_identifier_constant(compiler, property);
-    emit_bytes(compiler, safe ? OP_LOAD_PROPERTY_SAFE : OP_LOAD_PROPERTY, name);
+    uint16_t name = make_identifier_constant(compiler, property);
+    emit_constant_instruction(compiler, safe ? OP_LOAD_PROPERTY_SAFE : OP_LOAD_PROPERTY, name);
 
     compile_expression(compiler, expr->as.compoundAssignmentExpr.value);
 
@@ -1269,7 +1785,7 @@ static void compile_compound_property_assignment(Compiler* compiler, Expression*
     emit_byte(compiler, compound_opcode(op));
 
     emit_byte(compiler, OP_SWAP);
-    emit_bytes(compiler, safe ? OP_STORE_PROPERTY_SAFE : OP_STORE_PROPERTY, name);
+    emit_constant_instruction(compiler, safe ? OP_STORE_PROPERTY_SAFE : OP_STORE_PROPERTY, name);
 }
 
 static void compile_compound_subscript_assignment(Compiler* compiler, Expression* expr, Expression* target)
@@ -1359,9 +1875,9 @@ static void compile_identifier_postfix_inc(Compiler* compiler, Expression* expr)
 
     Token op = expr->as.postfixIncExpr.op;
     compiler->token = op;
-    emit_byte(compiler, increment_operation(op));
+    emit_arithmetic(compiler, increment_operation(op), variable_kind(compiler, &identifier) == KIND_NUMBER);
 
-    named_variable(compiler, identifier, STORE);
+    emit_variable_access(compiler, identifier, STORE);
     emit_byte(compiler, OP_POP);
 }
 
@@ -1374,8 +1890,8 @@ static void compile_property_postfix_inc(Compiler* compiler, Expression* expr)
 
     Token property = target->as.propertyExpr.property;
     compiler->token = property;
-    uint8_t name = make_identifier_constant(compiler, property);
-    emit_bytes(compiler, OP_LOAD_PROPERTY, name);
+    uint16_t name = make_identifier_constant(compiler, property);
+    emit_constant_instruction(compiler, OP_LOAD_PROPERTY, name);
     emit_bytes(compiler, OP_DUP, OP_SWAP_THREE);
 
     Token op = expr->as.postfixIncExpr.op;
@@ -1383,7 +1899,7 @@ static void compile_property_postfix_inc(Compiler* compiler, Expression* expr)
     emit_byte(compiler, increment_operation(op));
 
     emit_byte(compiler, OP_SWAP);
-    emit_bytes(compiler, OP_STORE_PROPERTY, name);
+    emit_constant_instruction(compiler, OP_STORE_PROPERTY, name);
     emit_byte(compiler, OP_POP);
 }
 
@@ -1438,9 +1954,9 @@ static void compile_identifier_prefix_inc(Compiler* compiler, Expression* expr)
     named_variable(compiler, identifier, LOAD);
 
     Token op = expr->as.prefixIncExpr.op;
-    emit_byte(compiler, increment_operation(op));
+    emit_arithmetic(compiler, increment_operation(op), variable_kind(compiler, &identifier) == KIND_NUMBER);
 
-    named_variable(compiler, identifier, STORE);
+    emit_variable_access(compiler, identifier, STORE);
 }
 
 static void compile_property_prefix_inc(Compiler* compiler, Expression* expr)
@@ -1452,14 +1968,14 @@ static void compile_property_prefix_inc(Compiler* compiler, Expression* expr)
 
     Token property = target->as.propertyExpr.property;
     compiler->token = property;
-    uint8_t name = make_identifier_constant(compiler, property);
-    emit_bytes(compiler, OP_LOAD_PROPERTY, name);
+    uint16_t name = make_identifier_constant(compiler, property);
+    emit_constant_instruction(compiler, OP_LOAD_PROPERTY, name);
 
     Token op = expr->as.prefixIncExpr.op;
     emit_byte(compiler, increment_operation(op));
 
     emit_byte(compiler, OP_SWAP);
-    emit_bytes(compiler, OP_STORE_PROPERTY, name);
+    emit_constant_instruction(compiler, OP_STORE_PROPERTY, name);
 }
 
 static void compile_subscript_prefix_inc(Compiler* compiler, Expression* expr)
@@ -1573,24 +2089,78 @@ void compile_elvis_expr(Compiler* compiler, Expression* expr)
     patch_jump(compiler, elseJump);
 }
 
+static bool is_profiled_operator(Token op)
+{
+    switch (op.type) {
+        case TOKEN_GREATER:
+        case TOKEN_GREATER_EQUAL:
+        case TOKEN_LESS:
+        case TOKEN_LESS_EQUAL:
+        case TOKEN_PLUS:
+        case TOKEN_MINUS:
+        case TOKEN_STAR:
+        case TOKEN_SLASH: return true;
+        default: return false;
+    }
+}
+
+//Parameters that are never reassigned can be taken to be numbers for the whole call once they have been checked
+static void vote_parameter(Compiler* compiler, Expression* operand, ProfileSite* site)
+{
+    if (operand->type != EXPR_IDENTIFIER) {
+        return;
+    }
+
+    int slot = resolve_local(compiler, &operand->as.identifierExpr.identifier);
+    if (slot < 1 || slot > compiler->function->arity || slot >= 32) {
+        return;
+    }
+
+    Local* local = &compiler->locals[slot];
+    if (!local->immutable || local->kind == KIND_NUMBER) {
+        return;
+    }
+
+    if (site->counts[1] > 0) {
+        compiler->mixedParameters |= 1u << slot;
+    } else {
+        compiler->numberParameters |= 1u << slot;
+        compiler->numberUses += site->counts[0];
+    }
+}
+
 void compile_binary_expr(Compiler* compiler, Expression* expr)
 {
-    compile_expression(compiler, expr->as.binaryExpr.left);
-    compile_expression(compiler, expr->as.binaryExpr.right);
+    Expression* left = expr->as.binaryExpr.left;
+    Expression* right = expr->as.binaryExpr.right;
+    compile_expression(compiler, left);
+    compile_expression(compiler, right);
+
+    bool numbers = is_number_expr(compiler, left) && is_number_expr(compiler, right);
 
     Token op = expr->as.binaryExpr.op;
+    if (!numbers && is_profiled_operator(op)) {
+        emit_profiling(compiler, OP_PROFILE_OPERANDS, SITE_OPERANDS, op);
+
+        ProfileSite* site = profiled_site(compiler, SITE_OPERANDS, op);
+        if (site) {
+            vote_parameter(compiler, left, site);
+            vote_parameter(compiler, right, site);
+        }
+    }
+
     compiler->token = op;
     switch (op.type) {
         case TOKEN_BANG_EQUAL: emit_byte(compiler, OP_NOT_EQUAL); return;
         case TOKEN_EQUAL_EQUAL: emit_byte(compiler, OP_EQUAL); return;
-        case TOKEN_GREATER: emit_byte(compiler, OP_GREATER); return;
-        case TOKEN_GREATER_EQUAL: emit_byte(compiler, OP_GREATER_EQUAL); return;
-        case TOKEN_LESS: emit_byte(compiler, OP_LESS); return;
-        case TOKEN_LESS_EQUAL: emit_byte(compiler, OP_LESS_EQUAL); return;
-        case TOKEN_PLUS: emit_byte(compiler, OP_ADD); return;
-        case TOKEN_MINUS: emit_byte(compiler, OP_SUBTRACT); return;
-        case TOKEN_STAR: emit_byte(compiler, OP_MULTIPLY); return;
-        case TOKEN_SLASH: emit_byte(compiler, OP_DIVIDE); return;
+        case TOKEN_GREATER: emit_arithmetic(compiler, OP_GREATER, numbers); return;
+        case TOKEN_GREATER_EQUAL: emit_arithmetic(compiler, OP_GREATER_EQUAL, numbers); return;
+        case TOKEN_LESS: emit_arithmetic(compiler, OP_LESS, numbers); return;
+        case TOKEN_LESS_EQUAL: emit_arithmetic(compiler, OP_LESS_EQUAL, numbers); return;
+        case TOKEN_PLUS: emit_arithmetic(compiler, OP_ADD, numbers); return;
+        case TOKEN_MINUS: emit_arithmetic(compiler, OP_SUBTRACT, numbers); return;
+        case TOKEN_STAR: emit_arithmetic(compiler, OP_MULTIPLY, numbers); return;
+        case TOKEN_SLASH: emit_arithmetic(compiler, OP_DIVIDE, numbers); return;
         case TOKEN_PERCENT: emit_byte(compiler, OP_MODULO); return;
         case TOKEN_DOUBLE_STAR: emit_byte(compiler, OP_POWER); return;
         case TOKEN_AMPERSAND: emit_byte(compiler, OP_BITWISE_AND); return;
@@ -1603,13 +2173,14 @@ void compile_binary_expr(Compiler* compiler, Expression* expr)
 
 void compile_unary_expr(Compiler* compiler, Expression* expr)
 {
-    compile_expression(compiler, expr->as.unaryExpr.expression);
+    Expression* operand = expr->as.unaryExpr.expression;
+    compile_expression(compiler, operand);
 
     Token op = expr->as.unaryExpr.op;
     compiler->token = op;
     switch (op.type) {
         case TOKEN_BANG: emit_byte(compiler, OP_NOT); return;
-        case TOKEN_MINUS: emit_byte(compiler, OP_NEGATE); return;
+        case TOKEN_MINUS: emit_arithmetic(compiler, OP_NEGATE, is_number_expr(compiler, operand)); return;
         case TOKEN_TILDE: emit_byte(compiler, OP_BITWISE_NOT); return;
     }
 }
@@ -1639,7 +2210,7 @@ static char complete_escape_sequence(const char* start)
     return -1;
 }
 
-static void compile_string_literal(Compiler* compiler, Token literal)
+static ObjectString* make_string_literal(Compiler* compiler, Token literal)
 {
     const char* end = literal.start + literal.length;
 
@@ -1651,7 +2222,7 @@ static void compile_string_literal(Compiler* compiler, Token literal)
         }
     }
 
-    char* stringBuffer = xmalloc(bufferLength);
+    char* stringBuffer = ARENA_ALLOCATE(compiler->arena, char, bufferLength);
 
     size_t i = 0;
     for (const char* current = literal.start; current < end; current++) {
@@ -1663,10 +2234,12 @@ static void compile_string_literal(Compiler* compiler, Token literal)
         i++;
     }
 
-    ObjectString* string = String_Copy(compiler->vm, stringBuffer, bufferLength);
-    free(stringBuffer);
+    return String_Copy(compiler->vm, stringBuffer, bufferLength);
+}
 
-    emit_constant(compiler, OBJ_VAL(string));
+static void compile_string_literal(Compiler* compiler, Token literal)
+{
+    emit_constant(compiler, OBJ_VAL(make_string_literal(compiler, literal)));
 }
 
 static void compile_this_literal(Compiler* compiler, Token literal)
@@ -1806,6 +2379,169 @@ size_t compile_when_entry_list(Compiler* compiler, WhenEntryList* list)
     return count;
 }
 
+static bool is_number_case(Expression* expr)
+{
+    if (expr->type == EXPR_UNARY && expr->as.unaryExpr.op.type == TOKEN_MINUS) {
+        expr = expr->as.unaryExpr.expression;
+    }
+
+    return expr->type == EXPR_LITERAL && expr->as.literalExpr.value.type == TOKEN_NUMBER;
+}
+
+static bool is_constant_case(Expression* expr)
+{
+    return is_number_case(expr) || (expr->type == EXPR_LITERAL && expr->as.literalExpr.value.type == TOKEN_STRING);
+}
+
+static double number_case_value(Expression* expr)
+{
+    double sign = 1.0;
+    if (expr->type == EXPR_UNARY) {
+        sign = -1.0;
+        expr = expr->as.unaryExpr.expression;
+    }
+
+    //Negative zero compares equal to zero but hashes differently
+    double value = sign * strtod(expr->as.literalExpr.value.start, NULL);
+    return value == 0.0 ? 0.0 : value;
+}
+
+static void patch_dispatch_offset(Compiler* compiler, size_t address, size_t base, size_t target)
+{
+    size_t offset = target - base;
+    if (offset > UINT16_MAX) {
+        error(compiler, "Too much code to jump over.");
+    }
+
+    current_chunk(compiler)->code[address    ] = (offset >> 0) & 0xFF;
+    current_chunk(compiler)->code[address + 1] = (offset >> 8) & 0xFF;
+}
+
+//When every case is a number or string literal, the matching entry is found with a single lookup instead
+//of comparing against each case in turn. Small integer ranges use a jump table indexed by the value, and
+//anything else goes through a hash table that maps each case to the index of its entry.
+bool compile_when_dispatch(Compiler* compiler, WhenEntryList* list, Statement* elseBranch)
+{
+    size_t entryCount = 0;
+    size_t caseCount = 0;
+    bool integers = true;
+    double min = 0.0;
+    double max = 0.0;
+
+    for (WhenEntryList* entry = list; entry != NULL; entry = entry->next, entryCount++) {
+        for (ExpressionList* current = entry->entry->cases; current != NULL; current = current->next) {
+            Expression* expr = current->expression;
+            if (!is_constant_case(expr)) {
+                return false;
+            }
+
+            if (integers && is_number_case(expr)) {
+                double value = number_case_value(expr);
+                //Values out of range cannot be converted, so they leave the cases to the hash table
+                integers = value >= INT32_MIN && value <= INT32_MAX && value == (double)(int32_t)value;
+                min = (caseCount == 0 || value < min) ? value : min;
+                max = (caseCount == 0 || value > max) ? value : max;
+            } else {
+                integers = false;
+            }
+
+            caseCount++;
+        }
+    }
+
+    if (caseCount < WHEN_DISPATCH_MIN_CASES || entryCount > UINT16_MAX) {
+        return false;
+    }
+
+    size_t* entryTargets = ARENA_ALLOCATE(compiler->arena, size_t, entryCount);
+
+    VM* vm = compiler->vm;
+    size_t length = integers ? (size_t)(max - min) + 1 : entryCount;
+    bool dense = integers && length <= WHEN_JUMP_TABLE_MAX && length <= caseCount * 2;
+
+    //Slots of a jump table hold the entry they lead to, and -1 for values that fall through to the else branch
+    int32_t* slots = NULL;
+    if (dense) {
+        slots = ARENA_ALLOCATE(compiler->arena, int32_t, length);
+        for (size_t i = 0; i < length; i++) {
+            slots[i] = -1;
+        }
+
+        int32_t index = 0;
+        for (WhenEntryList* entry = list; entry != NULL; entry = entry->next, index++) {
+            for (ExpressionList* current = entry->entry->cases; current != NULL; current = current->next) {
+                size_t slot = (size_t)(number_case_value(current->expression) - min);
+                if (slots[slot] == -1) {
+                    slots[slot] = index;
+                }
+            }
+        }
+
+        emit_byte(compiler, OP_JUMP_TABLE);
+        uint16_t constant = make_constant(compiler, NUMBER_VAL(min));
+        emit_bytes(compiler, (constant >> 0) & 0xFF, (constant >> 8) & 0xFF);
+    } else {
+        length = entryCount;
+
+        ObjectMap* map = Map_New(vm);
+        uint16_t constant = make_constant(compiler, OBJ_VAL(map));
+
+        double index = 0.0;
+        for (WhenEntryList* entry = list; entry != NULL; entry = entry->next, index++) {
+            for (ExpressionList* current = entry->entry->cases; current != NULL; current = current->next) {
+                Expression* expr = current->expression;
+                Value key = is_number_case(expr)
+                    ? NUMBER_VAL(number_case_value(expr))
+                    : OBJ_VAL(make_string_literal(compiler, expr->as.literalExpr.value));
+
+                Value existing;
+                Vm_PushTemporary(vm, key);
+                if (!Table_Get(&map->table, key, &existing)) {
+                    Map_Insert(map, key, NUMBER_VAL(index), vm);
+                }
+                Vm_PopTemporary(vm);
+            }
+        }
+
+        emit_byte(compiler, OP_JUMP_HASH);
+        emit_bytes(compiler, (constant >> 0) & 0xFF, (constant >> 8) & 0xFF);
+    }
+
+    emit_bytes(compiler, (length >> 0) & 0xFF, (length >> 8) & 0xFF);
+
+    size_t fallback = current_chunk(compiler)->count;
+    emit_bytes(compiler, 0xFF, 0xFF);
+
+    size_t table = current_chunk(compiler)->count;
+    for (size_t i = 0; i < length; i++) {
+        emit_bytes(compiler, 0xFF, 0xFF);
+    }
+
+    size_t base = current_chunk(compiler)->count;
+
+    size_t index = 0;
+    for (WhenEntryList* entry = list; entry != NULL; entry = entry->next, index++) {
+        entryTargets[index] = current_chunk(compiler)->count;
+        compile_statement(compiler, entry->entry->body);
+
+        size_t address = emit_jump(compiler, OP_JUMP);
+        push_control_break(compiler, address);
+    }
+
+    size_t elseTarget = current_chunk(compiler)->count;
+    if (elseBranch) {
+        compile_statement(compiler, elseBranch);
+    }
+
+    patch_dispatch_offset(compiler, fallback, base, elseTarget);
+    for (size_t i = 0; i < length; i++) {
+        size_t target = dense ? (slots[i] == -1 ? elseTarget : entryTargets[slots[i]]) : entryTargets[i];
+        patch_dispatch_offset(compiler, table + i * 2, base, target);
+    }
+
+    return true;
+}
+
 void compile_map_entry(Compiler* compiler, MapEntry* entry)
 {
     compile_expression(compiler, entry->key);
@@ -1874,9 +2610,15 @@ size_t compile_parameter_list(Compiler* compiler, ParameterList* list)
         Token parameter = current->parameter;
         compiler->token = parameter;
 
-        uint8_t index = declare_variable(compiler, parameter);
+        uint16_t index = declare_variable(compiler, parameter);
         define_variable(compiler, index);
 
+        ValueKind kind = annotation_kind(compiler, current->annotation);
+        if (kind == KIND_NUMBER) {
+            top_local(compiler)->kind = kind;
+            emit_bytes(compiler, OP_CHECK_NUMBER_LOCAL, (uint8_t)(compiler->localCount - 1));
+        }
+
         count++;
         if (count > 255) {
             error(compiler, "Cannot have more than 255 parameters.");
@@ -1896,8 +2638,7 @@ void compile_function_body(Compiler* compiler, FunctionBody* body)
                 error(compiler, "Initializer cannot be an expression.");
             }
 
-            compile_expression(compiler, body->as.expression);
-            emit_byte(compiler, OP_RETURN);
+            emit_value_return(compiler, body->as.expression);
             break;
         }
         case FUNC_BLOCK: {
@@ -1909,12 +2650,40 @@ void compile_function_body(Compiler* compiler, FunctionBody* body)
     }
 }
 
+//A function whose parameters a profile found to be given numbers often enough gets a second copy of its body which
+//takes them to be numbers, and calls only enter it once they have been checked to be
+static void compile_specialised_body(Compiler* compiler, Function* function, Token identifier)
+{
+    uint32_t parameters = compiler->numberParameters & ~compiler->mixedParameters;
+    ProfileSite* site = profiled_site(compiler, SITE_CALL, identifier);
+    if (compiler->error || parameters == 0 || !site || compiler->numberUses < site->counts[0]) {
+        return;
+    }
+
+    emit_return(compiler);
+    compiler->function->numberParameters = parameters;
+    compiler->function->specialisedEntry = current_chunk(compiler)->count;
+
+    for (int slot = 1; slot <= compiler->function->arity; slot++) {
+        Local* local = &compiler->locals[slot];
+        if (slot < 32 && (parameters >> slot & 1)) {
+            local->kind = KIND_NUMBER;
+        } else if (local->kind == KIND_NUMBER) {
+            emit_bytes(compiler, OP_CHECK_NUMBER_LOCAL, (uint8_t)slot);
+        }
+    }
+
+    compile_function_body(compiler, function->body);
+}
+
 void compile_function(Compiler* compiler, Function* function, CompilerType type, Token identifier, bool coroutine)
 {
     Compiler newCompiler;
-    compiler_init(&newCompiler, compiler->vm, type, identifier, compiler->mod);
+    compiler_init(&newCompiler, compiler->vm, compiler->arena, type, identifier, compiler->mod);
     begin_scope(&newCompiler);
 
+    emit_profiling(&newCompiler, OP_PROFILE_CALL, SITE_CALL, identifier);
+
     newCompiler.function->arity = (int)compile_parameter_list(&newCompiler, function->parameters);
     if (type == TYPE_STATIC_INITIALIZER && newCompiler.function->arity > 0) {
         error(compiler, "Static initializer cannot accept parameters.");
@@ -1925,15 +2694,21 @@ void compile_function(Compiler* compiler, Function* function, CompilerType type,
     }
 
     compile_function_body(&newCompiler, function->body);
+    compile_specialised_body(&newCompiler, function, identifier);
 
     ObjectFunction* compiled = finish_compilation(newCompiler.vm);
 
-    emit_bytes(compiler, OP_CLOSURE, make_constant(compiler, OBJ_VAL(compiled)));
+    emit_constant_instruction(compiler, OP_CLOSURE, make_constant(compiler, OBJ_VAL(compiled)));
     for (size_t i = 0; i < compiled->upvalueCount; i++) {
         emit_byte(compiler, newCompiler.upvalues[i].isLocal ? 1 : 0);
         emit_byte(compiler, newCompiler.upvalues[i].index);
     }
 
+    for (size_t i = 0; i < compiled->captureCount; i++) {
+        emit_byte(compiler, newCompiler.captures[i].isLocal ? 1 : 0);
+        emit_byte(compiler, newCompiler.captures[i].index);
+    }
+
     if (coroutine) {
         emit_byte(compiler, OP_COROUTINE);
     }
@@ -1967,30 +2742,73 @@ size_t compile_declaration_list(Compiler* compiler, DeclarationList* list)
     return count;
 }
 
+//Modules are named in profiles by their file, relative to the main module's directory where it is inside of it, so
+//that a profile stays valid wherever the program is run from
+static char* profile_file_name(VM* vm, ObjectModule* mod)
+{
+    const char* path = AS_CSTRING(mod->path);
+    const char* mainPath = AS_CSTRING(vm->mainModule->path);
+
+    size_t mainLength = strlen(mainPath);
+    if (strncmp(path, mainPath, mainLength) == 0) {
+        path += mainLength;
+    }
+
+    size_t pathLength = strlen(path);
+    size_t nameLength = strlen(AS_CSTRING(mod->name));
+    size_t extensionLength = strlen(FILE_EXTENSION);
+
+    char* name = xmalloc(pathLength + nameLength + extensionLength + 1);
+    memcpy(name, path, pathLength);
+    memcpy(name + pathLength, AS_CSTRING(mod->name), nameLength);
+    memcpy(name + pathLength + nameLength, FILE_EXTENSION, extensionLength + 1);
+    return name;
+}
+
 ObjectFunction* Compiler_Compile(VM* vm, const char* source, ObjectModule* mod)
 {
     vm->compiler = NULL;
     vm->classCompiler = NULL;
 
-    AST* ast = Parser_Parse(source);
-    if (!ast) {
-        return NULL;
+    Arena arena;
+    Arena_Init(&arena);
+
+    Parser parser;
+    Parser_Init(&parser, &arena, source);
+
+    Compiler compiler;
+    compiler.vm = vm;
+    compiler_init(&compiler, vm, &arena, TYPE_SCRIPT, Token_Empty(), mod);
+
+    char* profileFile = NULL;
+    if (vm->recordedProfile || vm->usedProfile) {
+        profileFile = profile_file_name(vm, mod);
+        compiler.source = source;
+        compiler.sourceEnd = source + strlen(source);
+        compiler.profileFile = profileFile;
     }
 
+    while (!Parser_AtEnd(&parser)) {
+        ArenaMark mark = Arena_Mark(&arena);
+
+        Declaration* decl = Parser_ParseDeclaration(&parser);
+        if (!parser.error) {
 #if DEBUG_PRINT_AST
-    print_ast(ast);
+            AstPrinter_Print(Ast_NewTree(&arena, Ast_NewDeclarationNode(&arena, decl)));
 #endif
+            compiler.assigned = Analysis_CollectAssigned(&arena, decl);
+            compile_declaration(&compiler, decl);
+        }
 
-    Compiler compiler;
-    compiler.vm = vm;
-    compiler_init(&compiler, vm, TYPE_SCRIPT, Token_Empty(), mod);
+        Arena_Release(&arena, mark);
+    }
 
-    compile_tree(&compiler, ast);
     ObjectFunction* function = finish_compilation(vm);
 
-    Ast_DeleteTree(ast);
+    Arena_Free(&arena);
+    free(profileFile);
 
-    return compiler.error ? NULL : function;
+    return (parser.error || compiler.error) ? NULL : function;
 }
 
 void Compiler_MarkRoots(VM* vm)
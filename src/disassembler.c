@@ -20,13 +20,27 @@ static uint32_t simple_instruction(const char* name, uint32_t offset)
     return offset + 1;
 }
 
+static uint32_t operand_width(Chunk* chunk, uint32_t offset)
+{
+    return OP_IS_LONG(chunk->code[offset]) ? 2 : 1;
+}
+
+static uint16_t read_operand(Chunk* chunk, uint32_t offset)
+{
+    if (OP_IS_LONG(chunk->code[offset])) {
+        return (uint16_t)(chunk->code[offset + 1] << 0) | (uint16_t)(chunk->code[offset + 2] << 8);
+    }
+
+    return chunk->code[offset + 1];
+}
+
 static uint32_t constant_instruction(const char* name, Chunk* chunk, uint32_t offset)
 {
-    uint8_t location = chunk->code[offset + 1];
+    uint16_t location = read_operand(chunk, offset);
     printf("%-22s %4d '", name, location);
     Value_Print(chunk->constants.data[location]);
     printf("'\n");
-    return offset + 2;
+    return offset + 1 + operand_width(chunk, offset);
 }
 
 static uint32_t byte_instruction(const char* name, Chunk* chunk, uint32_t offset)
@@ -38,12 +52,13 @@ static uint32_t byte_instruction(const char* name, Chunk* chunk, uint32_t offset
 
 static uint32_t invoke_instruction(const char* name, Chunk* chunk, uint32_t offset)
 {
-    uint8_t constant = chunk->code[offset + 1];
-    uint8_t argCount = chunk->code[offset + 2];
+    uint16_t constant = read_operand(chunk, offset);
+    uint32_t width = operand_width(chunk, offset);
+    uint8_t argCount = chunk->code[offset + 1 + width];
     printf("%-22s %4d '", name, constant);
     Value_Print(chunk->constants.data[constant]);
     printf("' (%d args)\n", argCount);
-    return offset + 3;
+    return offset + 2 + width;
 }
 
 static uint32_t jump_instruction(const char* name, char sign, Chunk* chunk, uint32_t offset)
@@ -53,13 +68,39 @@ static uint32_t jump_instruction(const char* name, char sign, Chunk* chunk, uint
     return offset + 3;
 }
 
+static uint32_t site_instruction(const char* name, Chunk* chunk, uint32_t offset)
+{
+    uint16_t site = (uint16_t)(chunk->code[offset + 1] << 0) | (uint16_t)(chunk->code[offset + 2] << 8);
+    printf("%-22s %4d\n", name, site);
+    return offset + 3;
+}
+
+static uint32_t dispatch_instruction(const char* name, Chunk* chunk, uint32_t offset)
+{
+    uint16_t constant = (uint16_t)(chunk->code[offset + 1] << 0) | (uint16_t)(chunk->code[offset + 2] << 8);
+    uint16_t length = (uint16_t)(chunk->code[offset + 3] << 0) | (uint16_t)(chunk->code[offset + 4] << 8);
+    uint16_t fallback = (uint16_t)(chunk->code[offset + 5] << 0) | (uint16_t)(chunk->code[offset + 6] << 8);
+    uint32_t base = offset + 7 + length * 2;
+
+    printf("%-22s %4d ", name, constant);
+    Value_Print(chunk->constants.data[constant]);
+    printf(" else -> %d\n", base + fallback);
+
+    for (uint16_t i = 0; i < length; i++) {
+        uint32_t current = offset + 7 + i * 2;
+        uint16_t jump = (uint16_t)(chunk->code[current] << 0) | (uint16_t)(chunk->code[current + 1] << 8);
+        printf("%04d    |                     %d -> %d\n", current, i, base + jump);
+    }
+
+    return base;
+}
+
 static uint32_t closure_instruction(Chunk* chunk, uint32_t offset)
 {
-    uint32_t currentOffset = offset;
-    currentOffset++;
+    uint16_t constant = read_operand(chunk, offset);
+    uint32_t currentOffset = offset + 1 + operand_width(chunk, offset);
 
-    uint8_t constant = chunk->code[currentOffset++];
-    printf("%-22s %4d ", "CLOSURE", constant);
+    printf("%-22s %4d ", OP_IS_LONG(chunk->code[offset]) ? "CLOSURE_LONG" : "CLOSURE", constant);
     Value_Print(chunk->constants.data[constant]);
     printf("\n");
 
@@ -70,6 +111,12 @@ static uint32_t closure_instruction(Chunk* chunk, uint32_t offset)
         printf("%04d    |                     %s %d\n", currentOffset - 2, isLocal ? "local" : "upvalue", index);
     }
 
+    for (size_t j = 0; j < function->captureCount; j++) {
+        uint8_t isLocal = chunk->code[currentOffset++];
+        uint8_t index = chunk->code[currentOffset++];
+        printf("%04d    |                     %s %d\n", currentOffset - 2, isLocal ? "copy local" : "copy capture", index);
+    }
+
     return currentOffset;
 }
 
@@ -83,10 +130,10 @@ uint32_t Disassembler_DisInstruction(Chunk* chunk, uint32_t offset)
 {
     printf("%04d ", offset);
 
-    uint32_t previousLine = Chunk_GetLine(chunk, offset - 1);
-    uint32_t currentLine = Chunk_GetLine(chunk, offset);
+    int previousLine = offset > 0 ? Chunk_GetLine(chunk, offset - 1) : -1;
+    int currentLine = Chunk_GetLine(chunk, offset);
 
-    if (offset > 0 && currentLine == previousLine) {
+    if (currentLine == previousLine) {
         printf("   | ");
     } else {
         printf("%4d ", currentLine);
@@ -162,6 +209,10 @@ uint32_t Disassembler_DisInstruction(Chunk* chunk, uint32_t offset)
             return jump_instruction("POP_JUMP_IF_EQUAL", 1, chunk, offset);
         case OP_JUMP_IF_NOT_NIL:
             return jump_instruction("JUMP_IF_NOT_NIL", 1, chunk, offset);
+        case OP_JUMP_TABLE:
+            return dispatch_instruction("JUMP_TABLE", chunk, offset);
+        case OP_JUMP_HASH:
+            return dispatch_instruction("JUMP_HASH", chunk, offset);
         case OP_POP:
             return simple_instruction("POP", offset);
         case OP_DUP:
@@ -188,6 +239,8 @@ uint32_t Disassembler_DisInstruction(Chunk* chunk, uint32_t offset)
             return byte_instruction("LOAD_UPVALUE", chunk, offset);
         case OP_STORE_UPVALUE:
             return byte_instruction("STORE_UPVALUE", chunk, offset);
+        case OP_LOAD_CAPTURE:
+            return byte_instruction("LOAD_CAPTURE", chunk, offset);
         case OP_LOAD_PROPERTY:
             return constant_instruction("LOAD_PROPERTY", chunk, offset);
         case OP_LOAD_PROPERTY_SAFE:
@@ -198,6 +251,8 @@ uint32_t Disassembler_DisInstruction(Chunk* chunk, uint32_t offset)
             return constant_instruction("STORE_PROPERTY_SAFE", chunk, offset);
         case OP_CLOSURE:
             return closure_instruction(chunk, offset);
+        case OP_RETURN_TUPLE:
+            return byte_instruction("RETURN_TUPLE", chunk, offset);
         case OP_CLOSE_UPVALUE:
             return simple_instruction("CLOSE_UPVALUE", offset);
         case OP_CALL:
@@ -246,6 +301,8 @@ uint32_t Disassembler_DisInstruction(Chunk* chunk, uint32_t offset)
             return simple_instruction("YIELD", offset);
         case OP_IMPORT_MODULE:
             return simple_instruction("IMPORT_MODULE", offset);
+        case OP_IMPORT_LAZY:
+            return simple_instruction("IMPORT_LAZY", offset);
         case OP_IMPORT_ALL:
             return simple_instruction("IMPORT_ALL", offset);
         case OP_SAVE_MODULE:
@@ -256,8 +313,78 @@ uint32_t Disassembler_DisInstruction(Chunk* chunk, uint32_t offset)
             return simple_instruction("ITERATOR", offset);
         case OP_FOR_ITERATOR:
             return jump_instruction("FOR_ITERATOR", 1, chunk, offset);
+        case OP_RANGE_COUNTER:
+            return simple_instruction("RANGE_COUNTER", offset);
+        case OP_FOR_RANGE:
+            return jump_instruction("FOR_RANGE", 1, chunk, offset);
         case OP_RANGE:
             return simple_instruction("RANGE", offset);
+        case OP_CHECK_NUMBER:
+            return simple_instruction("CHECK_NUMBER", offset);
+        case OP_CHECK_NUMBER_LOCAL:
+            return byte_instruction("CHECK_NUMBER_LOCAL", chunk, offset);
+        case OP_GREATER_NUMBER:
+            return simple_instruction("GREATER_NUMBER", offset);
+        case OP_GREATER_EQUAL_NUMBER:
+            return simple_instruction("GREATER_EQUAL_NUMBER", offset);
+        case OP_LESS_NUMBER:
+            return simple_instruction("LESS_NUMBER", offset);
+        case OP_LESS_EQUAL_NUMBER:
+            return simple_instruction("LESS_EQUAL_NUMBER", offset);
+        case OP_NEGATE_NUMBER:
+            return simple_instruction("NEGATE_NUMBER", offset);
+        case OP_INC_NUMBER:
+            return simple_instruction("INC_NUMBER", offset);
+        case OP_DEC_NUMBER:
+            return simple_instruction("DEC_NUMBER", offset);
+        case OP_ADD_NUMBER:
+            return simple_instruction("ADD_NUMBER", offset);
+        case OP_SUBTRACT_NUMBER:
+            return simple_instruction("SUBTRACT_NUMBER", offset);
+        case OP_MULTIPLY_NUMBER:
+            return simple_instruction("MULTIPLY_NUMBER", offset);
+        case OP_DIVIDE_NUMBER:
+            return simple_instruction("DIVIDE_NUMBER", offset);
+        case OP_PROFILE_CALL:
+            return site_instruction("PROFILE_CALL", chunk, offset);
+        case OP_PROFILE_BRANCH:
+            return site_instruction("PROFILE_BRANCH", chunk, offset);
+        case OP_PROFILE_OPERANDS:
+            return site_instruction("PROFILE_OPERANDS", chunk, offset);
+        case OP_LOAD_CONSTANT_LONG:
+            return constant_instruction("LOAD_CONSTANT_LONG", chunk, offset);
+        case OP_DEFINE_GLOBAL_LONG:
+            return constant_instruction("DEFINE_GLOBAL_LONG", chunk, offset);
+        case OP_LOAD_GLOBAL_LONG:
+            return constant_instruction("LOAD_GLOBAL_LONG", chunk, offset);
+        case OP_STORE_GLOBAL_LONG:
+            return constant_instruction("STORE_GLOBAL_LONG", chunk, offset);
+        case OP_CLOSURE_LONG:
+            return closure_instruction(chunk, offset);
+        case OP_CLASS_LONG:
+            return constant_instruction("CLASS_LONG", chunk, offset);
+        case OP_LOAD_PROPERTY_LONG:
+            return constant_instruction("LOAD_PROPERTY_LONG", chunk, offset);
+        case OP_LOAD_PROPERTY_SAFE_LONG:
+            return constant_instruction("LOAD_PROPERTY_SAFE_LONG", chunk, offset);
+        case OP_STORE_PROPERTY_LONG:
+            return constant_instruction("STORE_PROPERTY_LONG", chunk, offset);
+        case OP_STORE_PROPERTY_SAFE_LONG:
+            return constant_instruction("STORE_PROPERTY_SAFE_LONG", chunk, offset);
+        case OP_METHOD_LONG:
+            return constant_instruction("METHOD_LONG", chunk, offset);
+        case OP_STATIC_METHOD_LONG:
+            return constant_instruction("STATIC_METHOD_LONG", chunk, offset);
+        case OP_INVOKE_LONG:
+            return invoke_instruction("INVOKE_LONG", chunk, offset);
+        case OP_INVOKE_SAFE_LONG:
+            return invoke_instruction("INVOKE_SAFE_LONG", chunk, offset);
+        case OP_GET_SUPER_LONG:
+            return constant_instruction("GET_SUPER_LONG", chunk, offset);
+        case OP_SUPER_INVOKE_LONG:
+            return invoke_instruction("SUPER_INVOKE_LONG", chunk, offset);
+        case OP_IMPORT_BY_NAME_LONG:
+            return constant_instruction("IMPORT_BY_NAME_LONG", chunk, offset);
         default:
             return unknown_instruction(instruction, offset);
     }
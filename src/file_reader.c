@@ -6,12 +6,11 @@
 #include "common.h"
 #include "memory.h"
 
-char* Reader_ReadFile(const char* fileName)
+static const char* read_file(const char* fileName, char** result)
 {
     FILE* file = fopen(fileName, "rb");
     if (file == NULL) {
-        fprintf(stderr, "Could not open file '%s'.\n", fileName);
-        exit(ERR_IO);
+        return "Could not open file '%s'.\n";
     }
 
     fseek(file, 0L, SEEK_END);
@@ -20,18 +19,89 @@ char* Reader_ReadFile(const char* fileName)
 
     char* buffer = xmalloc(fileSize + 1);
     if (buffer == NULL) {
-        fprintf(stderr, "Not enough memory to read '%s'.\n", fileName);
-        exit(ERR_IO);
+        fclose(file);
+        return "Not enough memory to read '%s'.\n";
     }
 
     size_t bytesRead = fread(buffer, sizeof(char), fileSize, file);
     if (bytesRead < fileSize) {
-        fprintf(stderr, "Could not read file '%s'.\n", fileName);
-        exit(ERR_IO);
+        free(buffer);
+        fclose(file);
+        return "Could not read file '%s'.\n";
     }
 
     buffer[bytesRead] = '\0';
 
     fclose(file);
+
+    *result = buffer;
+    return NULL;
+}
+
+char* Reader_ReadFile(const char* fileName)
+{
+    char* buffer = NULL;
+    const char* error = read_file(fileName, &buffer);
+    if (error) {
+        fprintf(stderr, error, fileName);
+        exit(ERR_IO);
+    }
+
+    return buffer;
+}
+
+char* Reader_TryReadFile(const char* fileName)
+{
+    char* buffer = NULL;
+    read_file(fileName, &buffer);
     return buffer;
 }
+
+static bool is_parent_segment(const char* start, size_t length)
+{
+    return length == 2 && start[0] == '.' && start[1] == '.';
+}
+
+static size_t append_segment(char* path, size_t written, size_t root, const char* segment, size_t length)
+{
+    if (written > root) {
+        path[written++] = '/';
+    }
+
+    memmove(path + written, segment, length);
+    return written + length;
+}
+
+//Lexically drops '.' segments and resolves '..' segments in place, so that
+//different spellings of the same file produce the same path
+size_t Reader_NormalizePath(char* path)
+{
+    size_t root = path[0] == '/' ? 1 : 0;
+    size_t written = root;
+
+    const char* segment = path + root;
+    while (*segment) {
+        const char* end = strchr(segment, '/');
+        size_t length = end ? (size_t)(end - segment) : strlen(segment);
+
+        if (is_parent_segment(segment, length)) {
+            size_t previous = written;
+            while (previous > root && path[previous - 1] != '/') {
+                previous--;
+            }
+
+            if (written > previous && !is_parent_segment(path + previous, written - previous)) {
+                written = previous > root ? previous - 1 : root;
+            } else if (!root) {
+                written = append_segment(path, written, root, segment, length);
+            }
+        } else if (length != 0 && !(length == 1 && segment[0] == '.')) {
+            written = append_segment(path, written, root, segment, length);
+        }
+
+        segment += end ? length + 1 : length;
+    }
+
+    path[written] = '\0';
+    return written;
+}
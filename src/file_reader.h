@@ -1,6 +1,11 @@
 #ifndef FILEREADER_H
 #define FILEREADER_H
 
+#include <stddef.h>
+
 char* Reader_ReadFile(const char* fileName);
+char* Reader_TryReadFile(const char* fileName);
+
+size_t Reader_NormalizePath(char* path);
 
 #endif
@@ -9,45 +9,252 @@
 #include "table.h"
 #include "compiler.h"
 
+#include <time.h>
+
 #if DEBUG_LOG_GC
 #include <stdio.h>
 #endif
 
-#define GC_THRESHOLD_GROW_FACTOR 2
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define GC_INITIAL_HEAP (4 * 1024 * 1024)
+#define GC_TARGET_PAUSE 0.001
+#define GC_GROWTH_FACTOR 2.0
+#define GC_MARK_THREADS 1
+#define GC_NURSERY_SIZE (256 * 1024)
+#define GC_STEP_BYTES (64 * 1024)
+#define GC_STRESS_MAJOR_INTERVAL 8
+#define GC_STRESS_STEP_WORK 4
+
+//The number of objects traced or swept by a single incremental step, which bounds the length of its pause
+#ifdef ARCHER_GC_STEP_WORK
+#define GC_STEP_WORK ARCHER_GC_STEP_WORK
+#else
+#define GC_STEP_WORK 2000
+#endif
+
+#define GC_MIN_STEP_WORK 100
+#define GC_MAX_STEP_WORK (1024 * 1024)
+
+#define MARK_WORD(page, bit) (&(page)->marks[(bit) / HEAP_WORD_BITS])
+
+#if defined(_MSC_VER)
+static size_t lowest_bit(uint64_t word)
+{
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (size_t)index;
+}
+#else
+#define lowest_bit(word) ((size_t)__builtin_ctzll(word))
+#endif
+
+static bool is_marked(Object* object)
+{
+    HeapPage* page = HEAP_PAGE_OF(object);
+    size_t bit = HEAP_INDEX_OF(page, object);
+    return (atomic_load_explicit(MARK_WORD(page, bit), memory_order_relaxed) & HEAP_BIT(bit)) != 0;
+}
+
+//Only parallel marking changes marks from several threads at once, and it claims them atomically instead
+static void set_mark(Object* object, bool marked)
+{
+    HeapPage* page = HEAP_PAGE_OF(object);
+    size_t bit = HEAP_INDEX_OF(page, object);
+    atomic_uint_least64_t* word = MARK_WORD(page, bit);
+
+    uint64_t value = atomic_load_explicit(word, memory_order_relaxed);
+    value = marked ? value | HEAP_BIT(bit) : value & ~HEAP_BIT(bit);
+    atomic_store_explicit(word, value, memory_order_relaxed);
+}
+
+static void push_object(Object*** objects, size_t* count, size_t* capacity, Object* object)
+{
+    if (*capacity < *count + 1) {
+        *capacity = GROW_CAPACITY(*capacity);
+        *objects = xrealloc(*objects, sizeof(Object*) * *capacity);
+    }
+
+    (*objects)[(*count)++] = object;
+}
+
+void GC_DefaultOptions(GCOptions* options)
+{
+    options->initialHeap = GC_INITIAL_HEAP;
+    options->maxHeap = 0;
+    options->targetPause = GC_TARGET_PAUSE;
+    options->growthFactor = GC_GROWTH_FACTOR;
+    options->markThreads = GC_MARK_THREADS;
+}
 
 void GC_Init(GC* gc)
 {
     gc->vm = NULL;
-    gc->allocatedObjects = NULL;
+    GC_DefaultOptions(&gc->options);
+
+    gc->youngCount = 0;
+    gc->youngCapacity = 0;
+    gc->young = NULL;
+
+    Heap_Init(&gc->heap);
 
     gc->bytesAllocated = 0;
-    gc->threshold = 1024 * 1024;
+    gc->bytesSinceCollection = 0;
+    gc->threshold = gc->options.initialHeap;
+    gc->cycleStartBytes = 0;
+    gc->exhausted = false;
+
+    gc->phase = GC_IDLE;
+    gc->tracing = TRACE_ALL;
+    gc->parallel = false;
+    gc->collections = 0;
+
+#if DEBUG_STRESS_GC
+    gc->stepWork = GC_STRESS_STEP_WORK;
+#else
+    gc->stepWork = GC_STEP_WORK;
+#endif
+    gc->bytesSinceStep = 0;
+
+    gc->deadTypeCount = 0;
+    gc->deadTypeCapacity = 0;
+    gc->deadTypes = NULL;
 
     gc->grayCount = 0;
     gc->grayCapacity = 0;
     gc->grayStack = NULL;
+
+    gc->rememberedCount = 0;
+    gc->rememberedCapacity = 0;
+    gc->remembered = NULL;
+
+    Pool_Init(&gc->pool);
+
+    Marker_Init(&gc->marker, gc, gc->options.markThreads);
+
+#ifdef ARCHER_GC_THREAD
+    Sweeper_Init(&gc->sweeper);
+    gc->unreachedCount = 0;
+    gc->unreachedCapacity = 0;
+    gc->unreached = NULL;
+#endif
+}
+
+void GC_Configure(GC* gc, const GCOptions* options)
+{
+    gc->options = *options;
+    if (gc->options.maxHeap > 0 && gc->options.initialHeap > gc->options.maxHeap) {
+        gc->options.initialHeap = gc->options.maxHeap;
+    }
+
+    if (gc->phase == GC_IDLE) {
+        gc->threshold = gc->options.initialHeap;
+    }
+
+    //Only the calling thread is busy between collections, so the workers can be replaced right away
+    if (gc->marker.workerCount != gc->options.markThreads) {
+        Marker_Free(&gc->marker);
+        Marker_Init(&gc->marker, gc, gc->options.markThreads);
+    }
+}
+
+//Instances have to be freed before their classes, and classes before the metaclasses they are instances of
+static void order_dead_types(GC* gc)
+{
+    size_t classes = 0;
+    for (size_t i = 0; i < gc->deadTypeCount; i++) {
+        Object* type = gc->deadTypes[i];
+        if ((Object*)type->type != type) {
+            gc->deadTypes[i] = gc->deadTypes[classes];
+            gc->deadTypes[classes++] = type;
+        }
+    }
+}
+
+static void free_page_objects(GC* gc, HeapPage* pages)
+{
+    HeapPage* page = pages;
+
+    while (page) {
+        //Large pages go away along with their objects
+        HeapPage* next = page->next;
+
+        size_t words = page->live ? HEAP_BITMAP_WORDS : 1;
+        for (size_t i = 0; i < words; i++) {
+            uint64_t live = page->live ? page->live[i] : 1;
+            while (live) {
+                size_t bit = i * HEAP_WORD_BITS + lowest_bit(live);
+                live &= live - 1;
+
+                Object* object = (Object*)(page->blocks + bit * HEAP_GRANULARITY);
+                Heap_Forget(&gc->heap, object);
+
+                if (Object_IsType(object)) {
+                    push_object(&gc->deadTypes, &gc->deadTypeCount, &gc->deadTypeCapacity, object);
+                } else {
+                    Object_Free(object, gc);
+                }
+            }
+        }
+
+        page = next;
+    }
 }
 
 static void free_objects(GC* gc)
 {
-    Object* current = gc->allocatedObjects;
+    for (size_t i = 0; i < HEAP_CLASS_COUNT; i++) {
+        free_page_objects(gc, gc->heap.classes[i].pages);
+        free_page_objects(gc, gc->heap.classes[i].unswept);
+    }
 
-    while (current) {
-        Object* next = current->next;
-        Object_Free(current, gc);
-        current = next;
+    free_page_objects(gc, gc->heap.largePages);
+    free_page_objects(gc, gc->heap.unsweptLarge);
+
+    order_dead_types(gc);
+    for (size_t i = 0; i < gc->deadTypeCount; i++) {
+        Object_Free(gc->deadTypes[i], gc);
     }
+
+    gc->deadTypeCount = 0;
 }
 
 void GC_Free(GC* gc)
 {
+#ifdef ARCHER_GC_THREAD
+    //Queued objects may still refer to live classes, so they have to be gone first
+    Sweeper_Free(&gc->sweeper);
+#endif
+
     free_objects(gc);
+    free(gc->young);
+    free(gc->deadTypes);
     free(gc->grayStack);
+    free(gc->remembered);
+
+#ifdef ARCHER_GC_THREAD
+    free(gc->unreached);
+#endif
+
+    Marker_Free(&gc->marker);
+
+    //Pages may only go once nothing is left to be freed into them
+    Heap_Free(&gc->heap);
+    Pool_Free(&gc->pool);
 }
 
 void GC_AllocateBytes(GC* gc, size_t size)
 {
     gc->bytesAllocated += size;
+
+    //Large blocks are mapped on their own rather than carved out of the nursery, so they only bring a full collection closer
+    if (size < MEM_LARGE_SIZE) {
+        gc->bytesSinceCollection += size;
+    }
+
+    gc->bytesSinceStep += size;
 }
 
 void GC_DeallocateBytes(GC* gc, size_t size)
@@ -55,25 +262,41 @@ void GC_DeallocateBytes(GC* gc, size_t size)
     gc->bytesAllocated -= size;
 }
 
-static void ensure_graylist_capacity(GC* gc)
+static void push_gray(GC* gc, Object* object)
 {
-    if (gc->grayCapacity < gc->grayCount + 1) {
-        gc->grayCapacity = GROW_CAPACITY(gc->grayCapacity);
-
-        void* reallocated = realloc(gc->grayStack, sizeof(Object*) * gc->grayCapacity);
-        if (reallocated) {
-            gc->grayStack = reallocated;
-        }
-    }
+    push_object(&gc->grayStack, &gc->grayCount, &gc->grayCapacity, object);
 }
 
 void GC_MarkObject(GC* gc, Object* object)
 {
-    if (!object || object->marked) {
+    if (!object) {
+        return;
+    }
+
+    HeapPage* page = HEAP_PAGE_OF(object);
+    size_t bit = HEAP_INDEX_OF(page, object);
+    atomic_uint_least64_t* word = MARK_WORD(page, bit);
+
+    uint64_t marks = atomic_load_explicit(word, memory_order_relaxed);
+    if (marks & HEAP_BIT(bit)) {
+        return;
+    }
+
+    //Minor collections assume that every old object is still alive, while incremental steps leave young ones to them
+    if ((gc->tracing == TRACE_YOUNG && object->old) || (gc->tracing == TRACE_OLD && !object->old)) {
+        return;
+    }
+
+    //Several workers may reach the same object, and only the one that flips its mark goes on to trace it
+    if (gc->parallel) {
+        if (!(atomic_fetch_or_explicit(word, HEAP_BIT(bit), memory_order_relaxed) & HEAP_BIT(bit))) {
+            Marker_Push(object);
+        }
+
         return;
     }
 
-    object->marked = true;
+    atomic_store_explicit(word, marks | HEAP_BIT(bit), memory_order_relaxed);
 
 #if DEBUG_LOG_GC
     printf("%p mark ", (void*)object);
@@ -81,8 +304,7 @@ void GC_MarkObject(GC* gc, Object* object)
     printf("\n");
 #endif
 
-    ensure_graylist_capacity(gc);
-    gc->grayStack[gc->grayCount++] = object;
+    push_gray(gc, object);
 }
 
 void GC_MarkValue(GC* gc, Value value)
@@ -139,83 +361,515 @@ static void mark_roots(GC* gc)
     Compiler_MarkRoots(gc->vm);
 }
 
-static void trace_references(GC* gc)
+static void mark_remembered(GC* gc)
 {
-    VM* vm = gc->vm;
-    while (gc->grayCount > 0) {
+    for (size_t i = 0; i < gc->rememberedCount; i++) {
+        Object_Traverse(gc->remembered[i], gc);
+    }
+}
+
+//Remembered objects that the current cycle has already marked may have been given references it has not seen
+static void regray_remembered(GC* gc)
+{
+    for (size_t i = 0; i < gc->rememberedCount; i++) {
+        if (is_marked(gc->remembered[i])) {
+            push_gray(gc, gc->remembered[i]);
+        }
+    }
+}
+
+static void forget_remembered(GC* gc)
+{
+    for (size_t i = 0; i < gc->rememberedCount; i++) {
+        gc->remembered[i]->remembered = false;
+    }
+
+    gc->rememberedCount = 0;
+}
+
+//The running coroutine's stack is written without barriers
+static void remember_running_coroutine(GC* gc)
+{
+    if (gc->vm->coroutine) {
+        GC_WRITE_BARRIER(gc, gc->vm->coroutine);
+    }
+}
+
+//Traces gray objects until the stack drops to the given base or the budget runs out
+static void trace_references(GC* gc, size_t base, size_t budget)
+{
+    size_t work = 0;
+    while (gc->grayCount > base && work < budget) {
         Object* object = gc->grayStack[--gc->grayCount];
         Object_Traverse(object, gc);
+        work++;
     }
 }
 
-void table_remove_white_strings(Table* table)
+static void trace_all_references(GC* gc, size_t base)
 {
-    for (int i = 0; i <= table->capacityMask; i++) {
-        Entry* entry = &table->entries[i];
-        if (!IS_UNDEFINED(entry->key) && !VAL_AS_STRING(entry->key)->base.marked) {
-            Table_Remove(table, entry->key);
-        }
+    if (gc->marker.workerCount == 1) {
+        trace_references(gc, base, SIZE_MAX);
+        return;
+    }
+
+    //Tracing that has to run to completion is shared out among the marking threads
+    gc->parallel = true;
+    Marker_Trace(&gc->marker, gc->grayStack + base, gc->grayCount - base);
+    gc->parallel = false;
+    gc->grayCount = base;
+}
+
+static void dispose(GC* gc, Object* unreached)
+{
+#ifdef ARCHER_GC_THREAD
+    //Unreached objects are collected into a batch and freed by the sweeper thread once the sweep hands it over
+    push_object(&gc->unreached, &gc->unreachedCount, &gc->unreachedCapacity, unreached);
+#else
+    Object_Free(unreached, gc);
+#endif
+}
+
+static void free_unreached(GC* gc, Object* unreached)
+{
+    //Interned strings are weakly referenced, so they are only removed from the table as they are freed
+    if (unreached->type == gc->vm->stringType) {
+        Table_Remove(&gc->vm->strings, OBJ_VAL(unreached));
+    }
+
+    Heap_Forget(&gc->heap, unreached);
+
+    //Pages are not swept in the order their objects were allocated, so types wait until their instances are gone
+    if (Object_IsType(unreached)) {
+        push_object(&gc->deadTypes, &gc->deadTypeCount, &gc->deadTypeCapacity, unreached);
+    } else {
+        dispose(gc, unreached);
     }
 }
 
-static void sweep(GC* gc)
+static void free_dead_types(GC* gc)
 {
-    Object* previous = NULL;
-    Object* current = gc->allocatedObjects;
+    order_dead_types(gc);
+    for (size_t i = 0; i < gc->deadTypeCount; i++) {
+        dispose(gc, gc->deadTypes[i]);
+    }
+
+    gc->deadTypeCount = 0;
+}
+
+static void release_unreached(GC* gc)
+{
+#ifdef ARCHER_GC_THREAD
+    size_t freed = Sweeper_Submit(&gc->sweeper, &gc->pool, &gc->heap, gc->unreached, gc->unreachedCount);
+    GC_DeallocateBytes(gc, freed);
+    gc->unreachedCount = 0;
+#endif
+}
 
-    while (current) {
-        if (current->marked) {
-            current->marked = false;
-            previous = current;
-            current = current->next;
+//Frees every unmarked young object and makes the survivors old
+static void sweep_young(GC* gc, bool survivorsMarked)
+{
+    for (size_t i = 0; i < gc->youngCount; i++) {
+        Object* object = gc->young[i];
+        if (is_marked(object)) {
+            object->old = true;
+            if (!survivorsMarked) {
+                set_mark(object, false);
+            }
         } else {
-            Object* unreached = current;
+            free_unreached(gc, object);
+        }
+    }
+
+    gc->youngCount = 0;
+
+    //Types that died while the old generation is being swept may still have instances on pages it has not reached
+    if (gc->phase != GC_SWEEPING) {
+        free_dead_types(gc);
+    }
+
+    release_unreached(gc);
+}
 
-            current = current->next;
-            if (previous) {
-                previous->next = current;
-            } else {
-                gc->allocatedObjects = current;
+//Only visits the objects that are left unmarked, and returns how many of them there were
+static size_t sweep_page(GC* gc, HeapPage* page)
+{
+    size_t work = 0;
+
+    size_t words = page->live ? HEAP_BITMAP_WORDS : 1;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t live = page->live ? page->live[i] : 1;
+        uint64_t unmarked = live & ~atomic_load_explicit(&page->marks[i], memory_order_relaxed);
+
+        while (unmarked) {
+            size_t bit = i * HEAP_WORD_BITS + lowest_bit(unmarked);
+            unmarked &= unmarked - 1;
+
+            //Objects allocated since the cycle finished marking are young, and left to minor collections.
+            //Pages swept in parallel only have their unreached objects found, which are freed on this thread afterwards.
+            Object* object = (Object*)(page->blocks + bit * HEAP_GRANULARITY);
+            if (object->old && gc->parallel) {
+                Marker_Push(object);
+            } else if (object->old) {
+                free_unreached(gc, object);
             }
 
-            Object_Free(unreached, gc);
+            work++;
         }
     }
+
+    return work;
 }
 
-static void perform_collection(GC* gc)
+static void collect_young(GC* gc)
 {
 #if DEBUG_LOG_GC
-    printf("-- GC Begin\n");
+    printf("-- GC Begin (minor)\n");
     size_t before = gc->bytesAllocated;
 #endif
 
+    gc->tracing = TRACE_YOUNG;
+    gc->collections++;
+
+    //Gray objects below the base belong to the incremental cycle and are left to its steps
+    size_t base = gc->grayCount;
     mark_roots(gc);
-    trace_references(gc);
-    table_remove_white_strings(&gc->vm->strings);
-    sweep(gc);
+    mark_remembered(gc);
+    trace_all_references(gc, base);
+
+    //While the old generation is being marked, survivors start out unmarked so that the cycle traces them
+    bool marking = gc->phase == GC_MARKING;
+    if (marking) {
+        regray_remembered(gc);
+    }
+
+    forget_remembered(gc);
+    sweep_young(gc, !marking);
+
+    gc->bytesSinceCollection = 0;
+    remember_running_coroutine(gc);
+
+#if DEBUG_LOG_GC
+    printf("-- GC End (minor)\n");
+    printf("-- Collected %zu bytes (from %zu to %zu)\n", before - gc->bytesAllocated, before, gc->bytesAllocated);
+#endif
+}
 
-    gc->threshold = gc->bytesAllocated * GC_THRESHOLD_GROW_FACTOR;
+static void begin_cycle(GC* gc)
+{
+    //Starting with an empty young generation means that every object the cycle considers is old
+    collect_young(gc);
 
 #if DEBUG_LOG_GC
-    printf("-- GC End\n");
-    printf("-- Collected %zu bytes (from %zu to %zu), next at %zu\n", before - gc->bytesAllocated, before, gc->bytesAllocated, gc->threshold);
+    printf("-- GC Cycle Begin (%zu bytes)\n", gc->bytesAllocated);
+#endif
+
+    Heap_ClearMarks(&gc->heap);
+    gc->cycleStartBytes = gc->bytesAllocated;
+    gc->phase = GC_MARKING;
+    gc->tracing = TRACE_OLD;
+    gc->bytesSinceStep = 0;
+    mark_roots(gc);
+}
+
+static void finish_marking(GC* gc)
+{
+    //The roots and the remembered objects were modified without being traced again, so they are rescanned in one go
+    gc->tracing = TRACE_ALL;
+    mark_roots(gc);
+    regray_remembered(gc);
+    trace_all_references(gc, 0);
+    forget_remembered(gc);
+
+    sweep_young(gc, true);
+    gc->bytesSinceCollection = 0;
+
+    Heap_BeginSweep(&gc->heap);
+    gc->phase = GC_SWEEPING;
+
+    remember_running_coroutine(gc);
+
+#if DEBUG_LOG_GC
+    printf("-- GC Marking End\n");
+#endif
+}
+
+//Returns whether every page has been swept
+static bool sweep_old(GC* gc, size_t budget)
+{
+    size_t work = 0;
+    HeapPage* page = NULL;
+
+    while (work < budget && (page = Heap_TakeAnyUnswept(&gc->heap))) {
+        //Pages full of survivors are still worth a little work, since their bitmaps are scanned all the same
+        work += sweep_page(gc, page) + 1;
+    }
+
+    release_unreached(gc);
+    return page == NULL;
+}
+
+//Cycles that find most of the heap still alive reclaim little for their work, so the heap gets more room before the next
+static size_t next_threshold(GC* gc)
+{
+    double survival = 1.0;
+    if (gc->cycleStartBytes > 0 && gc->bytesAllocated < gc->cycleStartBytes) {
+        survival = (double)gc->bytesAllocated / (double)gc->cycleStartBytes;
+    }
+
+    double growth = gc->options.growthFactor;
+    double threshold = (double)gc->bytesAllocated * (growth + (growth - 1.0) * survival);
+
+    if (threshold < (double)gc->options.initialHeap) {
+        threshold = (double)gc->options.initialHeap;
+    }
+
+    if (gc->options.maxHeap > 0 && threshold > (double)gc->options.maxHeap) {
+        threshold = (double)gc->options.maxHeap;
+    }
+
+    //SIZE_MAX itself rounds up when turned into a double, so anything that reaches it saturates before the conversion
+    if (threshold >= (double)SIZE_MAX) {
+        return SIZE_MAX;
+    }
+
+    return (size_t)threshold;
+}
+
+static void finish_sweeping(GC* gc)
+{
+    free_dead_types(gc);
+    release_unreached(gc);
+    Heap_ReleasePages(&gc->heap);
+
+    gc->phase = GC_IDLE;
+    gc->threshold = next_threshold(gc);
+
+#if DEBUG_LOG_GC
+    printf("-- GC Cycle End (%zu bytes), next at %zu\n", gc->bytesAllocated, gc->threshold);
+#endif
+}
+
+static double current_time()
+{
+    struct timespec time;
+    timespec_get(&time, TIME_UTC);
+    return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+//Steps that use up their budget tell how long the work takes, which sizes the next ones to fit the target pause
+static void adjust_step_work(GC* gc, double elapsed)
+{
+#if DEBUG_STRESS_GC
+    //Stress runs keep their steps as small as they are
+    return;
+#endif
+
+    if (gc->options.targetPause <= 0.0 || elapsed <= 0.0) {
+        return;
+    }
+
+    //A single step is a noisy measurement, so the work only goes halfway towards what it suggests
+    double work = (double)gc->stepWork * gc->options.targetPause / elapsed;
+    work = ((double)gc->stepWork + work) / 2.0;
+
+    if (work < GC_MIN_STEP_WORK) {
+        work = GC_MIN_STEP_WORK;
+    } else if (work > GC_MAX_STEP_WORK) {
+        work = GC_MAX_STEP_WORK;
+    }
+
+    gc->stepWork = (size_t)work;
+}
+
+static void perform_step(GC* gc)
+{
+    gc->bytesSinceStep = 0;
+
+    double start = current_time();
+    bool budgetUsed = false;
+
+    if (gc->phase == GC_MARKING) {
+        //The final rescan gets a step of its own
+        if (gc->grayCount == 0) {
+            finish_marking(gc);
+        } else {
+            gc->tracing = TRACE_OLD;
+            trace_references(gc, 0, gc->stepWork);
+            budgetUsed = gc->grayCount > 0;
+        }
+    } else if (gc->phase == GC_SWEEPING) {
+        if (sweep_old(gc, gc->stepWork)) {
+            finish_sweeping(gc);
+        } else {
+            budgetUsed = true;
+        }
+    }
+
+    if (budgetUsed) {
+        adjust_step_work(gc, current_time() - start);
+    }
+}
+
+static void sweep_shared_pages(MarkerWorker* worker)
+{
+    Marker* marker = worker->marker;
+    GC* gc = marker->gc;
+
+    while (true) {
+        mtx_lock(&marker->lock);
+        HeapPage* page = Heap_TakeAnyUnswept(&gc->heap);
+        mtx_unlock(&marker->lock);
+
+        if (!page) {
+            break;
+        }
+
+        sweep_page(gc, page);
+    }
+}
+
+//Sweeping that has to run to completion has the pages shared out among the marking threads
+static void sweep_all(GC* gc)
+{
+    if (gc->marker.workerCount > 1) {
+        gc->parallel = true;
+        Marker_Run(&gc->marker, sweep_shared_pages);
+        gc->parallel = false;
+
+        for (int i = 0; i < gc->marker.workerCount; i++) {
+            MarkerWorker* worker = &gc->marker.workers[i];
+            for (size_t j = 0; j < worker->count; j++) {
+                free_unreached(gc, worker->stack[j]);
+            }
+
+            worker->count = 0;
+        }
+    }
+
+    sweep_old(gc, SIZE_MAX);
+}
+
+static void finish_cycle(GC* gc)
+{
+    if (gc->phase == GC_MARKING) {
+        finish_marking(gc);
+    }
+
+    sweep_all(gc);
+    finish_sweeping(gc);
+}
+
+//Finishes the cycle in progress and runs one more from the start, so that every object unreachable by now is freed
+static void collect_fully(GC* gc)
+{
+    if (gc->phase != GC_IDLE) {
+        finish_cycle(gc);
+    }
+
+    begin_cycle(gc);
+    finish_cycle(gc);
+
+#ifdef ARCHER_GC_THREAD
+    GC_DeallocateBytes(gc, Sweeper_Drain(&gc->sweeper, &gc->pool, &gc->heap));
 #endif
 }
 
 void GC_AttemptCollection(GC* gc)
 {
+    //Allocations still go through once the heap is exhausted, since it is up to the VM to stop the program safely
+    if (gc->options.maxHeap > 0 && gc->bytesAllocated > gc->options.maxHeap) {
+        if (!gc->exhausted) {
+            collect_fully(gc);
+            gc->exhausted = gc->bytesAllocated > gc->options.maxHeap;
+        }
+
+        return;
+    }
+
+    //If the program allocates faster than the steps can keep up with, the cycle is completed in a single pause
+    if (gc->phase != GC_IDLE && gc->bytesAllocated > gc->threshold * gc->options.growthFactor) {
+        finish_cycle(gc);
+        return;
+    }
+
 #if DEBUG_STRESS_GC
-    perform_collection(gc);
+    if (gc->phase == GC_IDLE && gc->collections % GC_STRESS_MAJOR_INTERVAL == 0) {
+        begin_cycle(gc);
+    } else {
+        collect_young(gc);
+        perform_step(gc);
+    }
 #else
-    if (gc->bytesAllocated > gc->threshold) {
-        perform_collection(gc);
+    if (gc->phase == GC_IDLE) {
+        if (gc->bytesAllocated > gc->threshold) {
+            begin_cycle(gc);
+        } else if (gc->bytesSinceCollection > GC_NURSERY_SIZE) {
+            collect_young(gc);
+        }
+    } else {
+        if (gc->bytesSinceCollection > GC_NURSERY_SIZE) {
+            collect_young(gc);
+        }
+
+        if (gc->bytesSinceStep > GC_STEP_BYTES) {
+            perform_step(gc);
+        }
     }
 #endif
 }
 
+void* GC_AllocateObject(GC* gc, size_t size)
+{
+    GC_AllocateBytes(gc, size);
+    GC_AttemptCollection(gc);
+
+    void* object = Heap_Allocate(&gc->heap, size, false);
+    if (!object) {
+        //Garbage is swept lazily, so a size class only takes a new page once the next of its old ones has been swept
+        HeapPage* page = Heap_TakeUnswept(&gc->heap, size);
+        if (page) {
+            sweep_page(gc, page);
+            release_unreached(gc);
+        }
+
+        object = Heap_Allocate(&gc->heap, size, true);
+    }
+
+    return object;
+}
+
+void GC_DeallocateObject(GC* gc, void* object, size_t size)
+{
+    GC_DeallocateBytes(gc, size);
+    Heap_Deallocate(&gc->heap, object, size);
+}
+
+//Frees the object allocated last, which must not have been handed out to anything else
+void GC_DiscardObject(GC* gc, Object* object)
+{
+    gc->youngCount--;
+    Heap_Forget(&gc->heap, object);
+    Object_Free(object, gc);
+}
+
 void GC_AppendObject(GC* gc, Object* object)
 {
-    object->next = gc->allocatedObjects;
-    gc->allocatedObjects = object;
+    object->old = false;
+    object->remembered = false;
+    push_object(&gc->young, &gc->youngCount, &gc->youngCapacity, object);
+}
+
+void GC_Remember(GC* gc, Object* object)
+{
+    object->remembered = true;
+    push_object(&gc->remembered, &gc->rememberedCount, &gc->rememberedCapacity, object);
+}
+
+void GC_KeepAlive(GC* gc, Object* object)
+{
+    //A weak table may hand out an unreachable old object before the sweep gets to it
+    if (gc->phase == GC_SWEEPING && object->old) {
+        set_mark(object, true);
+    }
 }
@@ -2,38 +2,130 @@
 #define GC_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "value.h"
+#include "pool.h"
+#include "heap.h"
+#include "marker.h"
+
+#ifdef ARCHER_GC_THREAD
+#include "sweeper.h"
+#endif
 
 typedef struct VM VM;
 typedef struct Object Object;
 typedef struct Table Table;
 
+//Objects are born into the young generation and promoted to the old one once they survive a collection.
+//Minor collections only trace from the roots and the remembered set, which holds every old object that
+//may have been given a reference to a young one since the last collection. The old generation is marked
+//and swept incrementally, and the same set tells which of its already marked objects have to be rescanned.
+//Marks are kept in the bitmaps of the heap's pages, and its pages are swept as allocation comes back to them.
+#define GC_WRITE_BARRIER(gc, object)                                \
+    do {                                                            \
+        Object* barrierObject_ = (Object*)(object);                 \
+        if (barrierObject_->old && !barrierObject_->remembered) {   \
+            GC_Remember((gc), barrierObject_);                      \
+        }                                                           \
+    } while (0)                                                     \
+
+typedef enum {
+    GC_IDLE,
+    GC_MARKING,
+    GC_SWEEPING
+} GCPhase;
+
+typedef enum {
+    TRACE_ALL,
+    TRACE_YOUNG,
+    TRACE_OLD
+} GCTrace;
+
+//The most threads that may share the work of a single collection pause
+#define GC_MAX_MARK_THREADS 64
+
+//Knobs the host may set from the command line or the environment. A maximum heap of zero leaves the heap unbounded,
+//and a target pause of zero keeps the work of incremental steps fixed.
+typedef struct GCOptions {
+    size_t initialHeap;
+    size_t maxHeap;
+    double targetPause;
+    double growthFactor;
+    int markThreads;
+} GCOptions;
+
 typedef struct GC {
     VM* vm;
+    GCOptions options;
+
+    size_t youngCount;
+    size_t youngCapacity;
+    Object** young;
+
+    Heap heap;
 
-    Object* allocatedObjects;
-    
     size_t bytesAllocated;
+    size_t bytesSinceCollection;
     size_t threshold;
+    size_t cycleStartBytes;
+
+    //Set once a full collection could not bring the heap back under its maximum, until the VM reports it
+    bool exhausted;
+
+    GCPhase phase;
+    GCTrace tracing;
+    bool parallel;
+    size_t collections;
+
+    size_t stepWork;
+    size_t bytesSinceStep;
+
+    size_t deadTypeCount;
+    size_t deadTypeCapacity;
+    Object** deadTypes;
 
     size_t grayCount;
     size_t grayCapacity;
     Object** grayStack;
+
+    size_t rememberedCount;
+    size_t rememberedCapacity;
+    Object** remembered;
+
+    Pool pool;
+
+    Marker marker;
+
+#ifdef ARCHER_GC_THREAD
+    Sweeper sweeper;
+    size_t unreachedCount;
+    size_t unreachedCapacity;
+    Object** unreached;
+#endif
 } GC;
 
 void GC_Init(GC* gc);
 void GC_Free(GC* gc);
 
+void GC_DefaultOptions(GCOptions* options);
+void GC_Configure(GC* gc, const GCOptions* options);
+
 void GC_AllocateBytes(GC* gc, size_t size);
 void GC_DeallocateBytes(GC* gc, size_t size);
 void GC_AttemptCollection(GC* gc);
 
+void* GC_AllocateObject(GC* gc, size_t size);
+void GC_DeallocateObject(GC* gc, void* object, size_t size);
+void GC_DiscardObject(GC* gc, Object* object);
+
 void GC_MarkObject(GC* gc, Object* object);
 void GC_MarkValue(GC* gc, Value value);
 void GC_MarkArray(GC* gc, ValueArray* array);
 void GC_MarkTable(GC* gc, Table* table);
 
 void GC_AppendObject(GC* gc, Object* object);
+void GC_Remember(GC* gc, Object* object);
+void GC_KeepAlive(GC* gc, Object* object);
 
 #endif
@@ -0,0 +1,464 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "heap.h"
+
+struct HeapBlock {
+    HeapBlock* next;
+};
+
+#define SMALL_HEADER_SIZE                                                                           \
+    ((sizeof(HeapPage) + sizeof(atomic_uint_least64_t) * HEAP_BITMAP_WORDS + sizeof(uint64_t) * HEAP_BITMAP_WORDS  \
+        + HEAP_GRANULARITY - 1) / HEAP_GRANULARITY * HEAP_GRANULARITY)                             \
+
+#define LARGE_HEADER_SIZE                                                                           \
+    ((sizeof(HeapPage) + sizeof(atomic_uint_least64_t) + HEAP_GRANULARITY - 1) / HEAP_GRANULARITY * HEAP_GRANULARITY) \
+
+static HeapPage* allocate_large_page(size_t size)
+{
+    if (size >= MEM_LARGE_SIZE) {
+        return Mem_MapPages(MEM_MAPPED_SIZE(size));
+    }
+
+#ifdef _WIN32
+    void* page = _aligned_malloc(size, HEAP_PAGE_SIZE);
+#else
+    void* page = NULL;
+    if (posix_memalign(&page, HEAP_PAGE_SIZE, size) != 0) {
+        page = NULL;
+    }
+#endif
+
+    if (page == NULL) {
+        fprintf(stderr, "Could not allocate memory!\n");
+        abort();
+    }
+
+    return (HeapPage*)page;
+}
+
+static void free_large_page(HeapPage* page)
+{
+    size_t size = LARGE_HEADER_SIZE + page->blockSize;
+    if (size >= MEM_LARGE_SIZE) {
+        Mem_UnmapPages(page, MEM_MAPPED_SIZE(size));
+        return;
+    }
+
+#ifdef _WIN32
+    _aligned_free(page);
+#else
+    free(page);
+#endif
+}
+
+static void free_pages(HeapPage* page)
+{
+    while (page) {
+        HeapPage* next = page->next;
+        if (page->live) {
+            Mem_UnmapPages(page, HEAP_PAGE_SIZE);
+        } else {
+            free_large_page(page);
+        }
+
+        page = next;
+    }
+}
+
+void Heap_Init(Heap* heap)
+{
+    for (size_t i = 0; i < HEAP_CLASS_COUNT; i++) {
+        HeapClass* sizeClass = &heap->classes[i];
+        sizeClass->current = NULL;
+        sizeClass->cursor = NULL;
+        sizeClass->limit = NULL;
+        sizeClass->available = NULL;
+        sizeClass->pages = NULL;
+        sizeClass->unswept = NULL;
+    }
+
+    heap->largePages = NULL;
+    heap->unsweptLarge = NULL;
+    heap->sweepClass = 0;
+
+    heap->ownsPages = true;
+    heap->freedHead = NULL;
+    heap->freedTail = NULL;
+}
+
+void Heap_InitDetached(Heap* heap)
+{
+    Heap_Init(heap);
+    heap->ownsPages = false;
+}
+
+void Heap_Free(Heap* heap)
+{
+    for (size_t i = 0; i < HEAP_CLASS_COUNT; i++) {
+        free_pages(heap->classes[i].pages);
+        free_pages(heap->classes[i].unswept);
+    }
+
+    free_pages(heap->largePages);
+    free_pages(heap->unsweptLarge);
+
+    bool ownsPages = heap->ownsPages;
+    Heap_Init(heap);
+    heap->ownsPages = ownsPages;
+}
+
+static void push_page(HeapPage** list, HeapPage* page)
+{
+    page->previous = NULL;
+    page->next = *list;
+    if (*list) {
+        (*list)->previous = page;
+    }
+
+    *list = page;
+}
+
+static void unlink_page(HeapPage** list, HeapPage* page)
+{
+    if (page->previous) {
+        page->previous->next = page->next;
+    } else {
+        *list = page->next;
+    }
+
+    if (page->next) {
+        page->next->previous = page->previous;
+    }
+}
+
+static void add_available(HeapClass* sizeClass, HeapPage* page)
+{
+    page->available = true;
+    page->previousAvailable = NULL;
+    page->nextAvailable = sizeClass->available;
+    if (sizeClass->available) {
+        sizeClass->available->previousAvailable = page;
+    }
+
+    sizeClass->available = page;
+}
+
+static void remove_available(HeapClass* sizeClass, HeapPage* page)
+{
+    if (page->previousAvailable) {
+        page->previousAvailable->nextAvailable = page->nextAvailable;
+    } else {
+        sizeClass->available = page->nextAvailable;
+    }
+
+    if (page->nextAvailable) {
+        page->nextAvailable->previousAvailable = page->previousAvailable;
+    }
+
+    page->available = false;
+}
+
+static void add_small_page(HeapClass* sizeClass, size_t blockSize)
+{
+    HeapPage* page = Mem_MapPages(HEAP_PAGE_SIZE);
+    page->available = false;
+    page->free = NULL;
+    page->used = 0;
+    page->blocks = (char*)page + SMALL_HEADER_SIZE;
+    page->blockSize = blockSize;
+    page->live = (uint64_t*)(page->marks + HEAP_BITMAP_WORDS);
+
+    for (size_t i = 0; i < HEAP_BITMAP_WORDS; i++) {
+        atomic_init(&page->marks[i], 0);
+        page->live[i] = 0;
+    }
+
+    push_page(&sizeClass->pages, page);
+    sizeClass->current = page;
+    sizeClass->cursor = page->blocks;
+    sizeClass->limit = (char*)page + HEAP_PAGE_SIZE;
+}
+
+static void* allocate_large(Heap* heap, size_t size)
+{
+    HeapPage* page = allocate_large_page(LARGE_HEADER_SIZE + size);
+    page->blocks = (char*)page + LARGE_HEADER_SIZE;
+    page->blockSize = size;
+    page->live = NULL;
+    atomic_init(&page->marks[0], 0);
+
+    push_page(&heap->largePages, page);
+    return page->blocks;
+}
+
+//Unless asked to grow, returns NULL once the size class has run out of space on the pages it already has
+void* Heap_Allocate(Heap* heap, size_t size, bool grow)
+{
+    if (size > HEAP_MAX_SMALL_SIZE) {
+        return allocate_large(heap, size);
+    }
+
+    size_t index = HEAP_CLASS(size);
+    HeapClass* sizeClass = &heap->classes[index];
+    size_t blockSize = (index + 1) * HEAP_GRANULARITY;
+
+    char* block = NULL;
+    HeapPage* page = NULL;
+
+    while (!block) {
+        page = sizeClass->current;
+        if (page && page->free) {
+            block = (char*)page->free;
+            page->free = page->free->next;
+        } else if (page && sizeClass->cursor + blockSize <= sizeClass->limit) {
+            block = sizeClass->cursor;
+            sizeClass->cursor += blockSize;
+        } else if (sizeClass->available) {
+            page = sizeClass->available;
+            remove_available(sizeClass, page);
+
+            sizeClass->current = page;
+            sizeClass->cursor = NULL;
+            sizeClass->limit = NULL;
+        } else if (grow) {
+            add_small_page(sizeClass, blockSize);
+        } else {
+            return NULL;
+        }
+    }
+
+    page->used++;
+    size_t bit = HEAP_INDEX_OF(page, block);
+    atomic_uint_least64_t* marks = &page->marks[bit / HEAP_WORD_BITS];
+
+    page->live[bit / HEAP_WORD_BITS] |= HEAP_BIT(bit);
+    atomic_store_explicit(marks, atomic_load_explicit(marks, memory_order_relaxed) & ~HEAP_BIT(bit), memory_order_relaxed);
+    return block;
+}
+
+//Empty pages are not given back here, since they may be in the middle of being swept
+static void return_block(Heap* heap, HeapBlock* block)
+{
+    HeapPage* page = HEAP_PAGE_OF(block);
+    HeapClass* sizeClass = &heap->classes[HEAP_CLASS(page->blockSize)];
+
+    block->next = page->free;
+    page->free = block;
+    page->used--;
+
+    if (page != sizeClass->current && !page->available) {
+        add_available(sizeClass, page);
+    }
+}
+
+//Detached heaps only touch their own lists, so that one can be used to free objects on another thread
+void Heap_Deallocate(Heap* heap, void* object, size_t size)
+{
+    if (size > HEAP_MAX_SMALL_SIZE) {
+        free_large_page(HEAP_PAGE_OF(object));
+        return;
+    }
+
+    HeapBlock* block = (HeapBlock*)object;
+    if (heap->ownsPages) {
+        return_block(heap, block);
+        return;
+    }
+
+    block->next = heap->freedHead;
+    heap->freedHead = block;
+    if (!heap->freedTail) {
+        heap->freedTail = block;
+    }
+}
+
+//Takes an object that is about to be freed out of the heap's bookkeeping, which is only ever done by the VM thread
+void Heap_Forget(Heap* heap, void* object)
+{
+    HeapPage* page = HEAP_PAGE_OF(object);
+
+    if (page->live) {
+        size_t bit = HEAP_INDEX_OF(page, object);
+        page->live[bit / HEAP_WORD_BITS] &= ~HEAP_BIT(bit);
+        return;
+    }
+
+    unlink_page(heap->largePages == page ? &heap->largePages : &heap->unsweptLarge, page);
+}
+
+//Moves every block freed into the other heap into this one, returning them to their pages if it owns them
+void Heap_Reclaim(Heap* heap, Heap* other)
+{
+    HeapBlock* block = other->freedHead;
+    if (!block) {
+        return;
+    }
+
+    if (heap->ownsPages) {
+        while (block) {
+            HeapBlock* next = block->next;
+            return_block(heap, block);
+            block = next;
+        }
+    } else {
+        other->freedTail->next = heap->freedHead;
+        if (!heap->freedTail) {
+            heap->freedTail = other->freedTail;
+        }
+
+        heap->freedHead = other->freedHead;
+    }
+
+    other->freedHead = NULL;
+    other->freedTail = NULL;
+}
+
+static void clear_marks(HeapPage* page, size_t words)
+{
+    for (; page; page = page->next) {
+        for (size_t i = 0; i < words; i++) {
+            atomic_store_explicit(&page->marks[i], 0, memory_order_relaxed);
+        }
+    }
+}
+
+void Heap_ClearMarks(Heap* heap)
+{
+    for (size_t i = 0; i < HEAP_CLASS_COUNT; i++) {
+        clear_marks(heap->classes[i].pages, HEAP_BITMAP_WORDS);
+        clear_marks(heap->classes[i].unswept, HEAP_BITMAP_WORDS);
+    }
+
+    clear_marks(heap->largePages, 1);
+    clear_marks(heap->unsweptLarge, 1);
+}
+
+static void append_pages(HeapPage** list, HeapPage* pages)
+{
+    if (!pages) {
+        return;
+    }
+
+    HeapPage* last = pages;
+    while (last->next) {
+        last = last->next;
+    }
+
+    last->next = *list;
+    if (*list) {
+        (*list)->previous = last;
+    }
+
+    *list = pages;
+}
+
+//Every page becomes due for sweeping, while the objects allocated from now on are never swept by this cycle
+void Heap_BeginSweep(Heap* heap)
+{
+    for (size_t i = 0; i < HEAP_CLASS_COUNT; i++) {
+        HeapClass* sizeClass = &heap->classes[i];
+        append_pages(&sizeClass->unswept, sizeClass->pages);
+        sizeClass->pages = NULL;
+    }
+
+    append_pages(&heap->unsweptLarge, heap->largePages);
+    heap->largePages = NULL;
+    heap->sweepClass = 0;
+}
+
+static HeapPage* take_page(HeapPage** from, HeapPage** into)
+{
+    HeapPage* page = *from;
+    if (page) {
+        *from = page->next;
+        if (*from) {
+            (*from)->previous = NULL;
+        }
+
+        push_page(into, page);
+    }
+
+    return page;
+}
+
+//Hands out the next page of the size class that still has to be swept, already moved back among the swept ones
+HeapPage* Heap_TakeUnswept(Heap* heap, size_t size)
+{
+    if (size > HEAP_MAX_SMALL_SIZE) {
+        return NULL;
+    }
+
+    HeapClass* sizeClass = &heap->classes[HEAP_CLASS(size)];
+    return take_page(&sizeClass->unswept, &sizeClass->pages);
+}
+
+HeapPage* Heap_TakeAnyUnswept(Heap* heap)
+{
+    for (; heap->sweepClass < HEAP_CLASS_COUNT; heap->sweepClass++) {
+        HeapClass* sizeClass = &heap->classes[heap->sweepClass];
+        if (sizeClass->unswept) {
+            return take_page(&sizeClass->unswept, &sizeClass->pages);
+        }
+    }
+
+    return take_page(&heap->unsweptLarge, &heap->largePages);
+}
+
+static int compare_used(const void* a, const void* b)
+{
+    size_t usedA = (*(HeapPage* const*)a)->used;
+    size_t usedB = (*(HeapPage* const*)b)->used;
+    return (usedA < usedB) - (usedA > usedB);
+}
+
+//Gives every empty page back to the system once the heap has been swept, and has the fullest pages filled first, so
+//that the objects left on sparse ones get the chance to die out and free their pages as well
+void Heap_ReleasePages(Heap* heap)
+{
+    HeapPage** available = NULL;
+    size_t capacity = 0;
+
+    for (size_t i = 0; i < HEAP_CLASS_COUNT; i++) {
+        HeapClass* sizeClass = &heap->classes[i];
+        size_t count = 0;
+
+        HeapPage* page = sizeClass->pages;
+        while (page) {
+            HeapPage* next = page->next;
+
+            if (page->used == 0 && page != sizeClass->current) {
+                if (page->available) {
+                    remove_available(sizeClass, page);
+                }
+
+                unlink_page(&sizeClass->pages, page);
+                Mem_UnmapPages(page, HEAP_PAGE_SIZE);
+            } else if (page->available) {
+                if (count == capacity) {
+                    capacity = capacity < 8 ? 8 : capacity * 2;
+                    available = xrealloc(available, sizeof(HeapPage*) * capacity);
+                }
+
+                available[count++] = page;
+            }
+
+            page = next;
+        }
+
+        if (count > 1) {
+            qsort(available, count, sizeof(HeapPage*), compare_used);
+        }
+
+        sizeClass->available = NULL;
+        for (size_t j = count; j > 0; j--) {
+            add_available(sizeClass, available[j - 1]);
+        }
+    }
+
+    free(available);
+}
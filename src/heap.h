@@ -0,0 +1,87 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdatomic.h>
+
+#include "common.h"
+#include "memory.h"
+
+//Objects live in aligned pages, so the page that holds an object is found by masking its address. Small objects
+//share pages of a single size class, whose headers keep one bit per granule for the blocks that hold objects and
+//another for the ones that are marked. Larger objects each get a page of their own.
+#define HEAP_PAGE_SIZE MEM_PAGE_ALIGNMENT
+#define HEAP_GRANULARITY 16
+#define HEAP_MAX_SMALL_SIZE 512
+#define HEAP_CLASS_COUNT (HEAP_MAX_SMALL_SIZE / HEAP_GRANULARITY)
+
+#define HEAP_WORD_BITS 64
+#define HEAP_BITMAP_WORDS (HEAP_PAGE_SIZE / HEAP_GRANULARITY / HEAP_WORD_BITS)
+
+#define HEAP_CLASS(size) ((size) == 0 ? 0 : ((size) - 1) / HEAP_GRANULARITY)
+
+#define HEAP_PAGE_OF(object) ((HeapPage*)((uintptr_t)(object) & ~(uintptr_t)(HEAP_PAGE_SIZE - 1)))
+#define HEAP_INDEX_OF(page, object) ((size_t)((char*)(object) - (page)->blocks) / HEAP_GRANULARITY)
+#define HEAP_BIT(index) ((uint64_t)1 << ((index) % HEAP_WORD_BITS))
+
+typedef struct HeapBlock HeapBlock;
+
+typedef struct HeapPage {
+    struct HeapPage* next;
+    struct HeapPage* previous;
+
+    struct HeapPage* nextAvailable;
+    struct HeapPage* previousAvailable;
+    bool available;
+
+    //Blocks that wait on another thread to be freed still count as used, so the page stays until they are back
+    HeapBlock* free;
+    size_t used;
+
+    char* blocks;
+    size_t blockSize;
+
+    //Large pages hold a single object, so only small ones keep track of which blocks are in use
+    uint64_t* live;
+    atomic_uint_least64_t marks[];
+} HeapPage;
+
+typedef struct HeapClass {
+    HeapPage* current;
+    char* cursor;
+    char* limit;
+
+    //Pages other than the current one that have free blocks
+    HeapPage* available;
+
+    HeapPage* pages;
+    HeapPage* unswept;
+} HeapClass;
+
+typedef struct Heap {
+    HeapClass classes[HEAP_CLASS_COUNT];
+    HeapPage* largePages;
+    HeapPage* unsweptLarge;
+    size_t sweepClass;
+
+    //Detached heaps have no pages, and only gather the blocks freed into them until another heap reclaims them
+    bool ownsPages;
+    HeapBlock* freedHead;
+    HeapBlock* freedTail;
+} Heap;
+
+void Heap_Init(Heap* heap);
+void Heap_InitDetached(Heap* heap);
+void Heap_Free(Heap* heap);
+
+void* Heap_Allocate(Heap* heap, size_t size, bool grow);
+void Heap_Deallocate(Heap* heap, void* object, size_t size);
+void Heap_Forget(Heap* heap, void* object);
+void Heap_Reclaim(Heap* heap, Heap* other);
+
+void Heap_ClearMarks(Heap* heap);
+void Heap_BeginSweep(Heap* heap);
+HeapPage* Heap_TakeUnswept(Heap* heap, size_t size);
+HeapPage* Heap_TakeAnyUnswept(Heap* heap);
+void Heap_ReleasePages(Heap* heap);
+
+#endif
@@ -126,6 +126,7 @@ void Library_DefineTypeMethod(ObjectType* type, VM* vm, const char* name, Native
     Vm_PushTemporary(vm, OBJ_VAL(String_FromCString(vm, name)));
     Vm_PushTemporary(vm, OBJ_VAL(Native_New(vm, function, arity)));
     Table_Put(vm, &type->methods, Vm_PeekTemporary(vm, 1), Vm_PeekTemporary(vm, 0));
+    GC_WRITE_BARRIER(&vm->gc, type);
     Vm_PopTemporary(vm);
     Vm_PopTemporary(vm);
 }
@@ -0,0 +1,357 @@
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "loader.h"
+#include "memory.h"
+#include "scanner.h"
+#include "file_reader.h"
+
+typedef enum { JOB_PENDING, JOB_RUNNING, JOB_DONE, JOB_TAKEN } JobState;
+
+struct LoaderJob {
+    LoaderJob* next;
+    LoaderJob* nextQueued;
+
+    char* fileName;
+    JobState state;
+
+    //Set when the VM has read the module itself while a worker was still on it
+    bool forgotten;
+
+    char* source;
+};
+
+static int processor_count()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+void Loader_Init(Loader* loader)
+{
+    loader->jobs = NULL;
+    loader->queueHead = NULL;
+    loader->queueTail = NULL;
+
+    mtx_init(&loader->lock, mtx_plain);
+    cnd_init(&loader->jobQueued);
+    cnd_init(&loader->jobFinished);
+
+    //One processor is left for the VM thread, which compiles whatever the workers have read, unless the
+    //environment asks for a particular number of workers
+    loader->threadCount = 0;
+    loader->threadLimit = processor_count() - 1;
+
+    const char* threads = getenv("ARCHER_LOADER_THREADS");
+    if (threads) {
+        char* end;
+        long count = strtol(threads, &end, 10);
+        if (end != threads && *end == '\0' && count >= 0) {
+            loader->threadLimit = count < LOADER_THREAD_COUNT ? (int)count : LOADER_THREAD_COUNT;
+        }
+    }
+
+    if (loader->threadLimit > LOADER_THREAD_COUNT) {
+        loader->threadLimit = LOADER_THREAD_COUNT;
+    }
+
+    loader->shutdown = false;
+}
+
+void Loader_Free(Loader* loader)
+{
+    mtx_lock(&loader->lock);
+    loader->shutdown = true;
+    cnd_broadcast(&loader->jobQueued);
+    mtx_unlock(&loader->lock);
+
+    for (int i = 0; i < loader->threadCount; i++) {
+        thrd_join(loader->threads[i], NULL);
+    }
+
+    LoaderJob* job = loader->jobs;
+    while (job) {
+        LoaderJob* next = job->next;
+        free(job->source);
+        free(job->fileName);
+        free(job);
+        job = next;
+    }
+
+    cnd_destroy(&loader->jobFinished);
+    cnd_destroy(&loader->jobQueued);
+    mtx_destroy(&loader->lock);
+}
+
+static char* directory_of(const char* fileName)
+{
+    const char* separator = strrchr(fileName, '/');
+    size_t length = separator ? (size_t)(separator - fileName) + 1 : 0;
+
+    char* directory = xmalloc(length + 1);
+    memcpy(directory, fileName, length);
+    directory[length] = '\0';
+    return directory;
+}
+
+//Workers only read modules and queue up their dependencies. Parsing is left to the VM thread, which compiles one
+//declaration at a time and so never has to hold a module's whole tree.
+static char* load(Loader* loader, LoaderJob* job)
+{
+    char* source = Reader_TryReadFile(job->fileName);
+    if (!source) {
+        return NULL;
+    }
+
+    char* directory = directory_of(job->fileName);
+    Loader_Prefetch(loader, source, directory);
+    free(directory);
+
+    return source;
+}
+
+static int worker(void* arg)
+{
+    Loader* loader = (Loader*)arg;
+
+    mtx_lock(&loader->lock);
+    while (true) {
+        while (!loader->queueHead && !loader->shutdown) {
+            cnd_wait(&loader->jobQueued, &loader->lock);
+        }
+
+        if (loader->shutdown) {
+            break;
+        }
+
+        LoaderJob* job = loader->queueHead;
+        loader->queueHead = job->nextQueued;
+        if (!loader->queueHead) {
+            loader->queueTail = NULL;
+        }
+
+        job->state = JOB_RUNNING;
+        mtx_unlock(&loader->lock);
+
+        char* source = load(loader, job);
+
+        mtx_lock(&loader->lock);
+        if (job->forgotten) {
+            free(source);
+            job->state = JOB_TAKEN;
+        } else {
+            job->source = source;
+            job->state = JOB_DONE;
+        }
+
+        cnd_broadcast(&loader->jobFinished);
+    }
+    mtx_unlock(&loader->lock);
+
+    return 0;
+}
+
+static LoaderJob* find_job(Loader* loader, const char* fileName)
+{
+    for (LoaderJob* job = loader->jobs; job; job = job->next) {
+        if (strcmp(job->fileName, fileName) == 0) {
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+static void start_workers(Loader* loader)
+{
+    while (loader->threadCount < loader->threadLimit) {
+        if (thrd_create(&loader->threads[loader->threadCount], worker, loader) != thrd_success) {
+            break;
+        }
+
+        loader->threadCount++;
+    }
+}
+
+static LoaderJob* new_job(Loader* loader, char* fileName, JobState state)
+{
+    LoaderJob* job = (LoaderJob*)xmalloc(sizeof(LoaderJob));
+    job->fileName = fileName;
+    job->state = state;
+    job->forgotten = false;
+    job->source = NULL;
+    job->nextQueued = NULL;
+
+    job->next = loader->jobs;
+    loader->jobs = job;
+    return job;
+}
+
+static void unqueue(Loader* loader, LoaderJob* job)
+{
+    LoaderJob** current = &loader->queueHead;
+    LoaderJob* previous = NULL;
+    while (*current != job) {
+        previous = *current;
+        current = &(*current)->nextQueued;
+    }
+
+    *current = job->nextQueued;
+    if (loader->queueTail == job) {
+        loader->queueTail = previous;
+    }
+}
+
+static void submit(Loader* loader, char* fileName)
+{
+    mtx_lock(&loader->lock);
+
+    if (loader->shutdown || find_job(loader, fileName)) {
+        mtx_unlock(&loader->lock);
+        free(fileName);
+        return;
+    }
+
+    if (loader->threadCount == 0) {
+        start_workers(loader);
+    }
+
+    LoaderJob* job = new_job(loader, fileName, JOB_PENDING);
+
+    if (loader->queueTail) {
+        loader->queueTail->nextQueued = job;
+    } else {
+        loader->queueHead = job;
+    }
+    loader->queueTail = job;
+
+    cnd_signal(&loader->jobQueued);
+    mtx_unlock(&loader->lock);
+}
+
+static char* make_file_name(const char* path, Token literal)
+{
+    size_t pathLength = strlen(path);
+    size_t extensionLength = strlen(FILE_EXTENSION);
+    size_t length = pathLength + literal.length + extensionLength + 1;
+
+    char* fileName = (char*)xmalloc(length);
+    memcpy(fileName,                                 path,            pathLength);
+    memcpy(fileName + pathLength,                    literal.start,   literal.length);
+    memcpy(fileName + pathLength + literal.length,   FILE_EXTENSION,  extensionLength);
+    fileName[length - 1] = '\0';
+
+    Reader_NormalizePath(fileName);
+    return fileName;
+}
+
+static bool is_plain_literal(Token literal)
+{
+    return memchr(literal.start, '\\', literal.length) == NULL;
+}
+
+void Loader_Prefetch(Loader* loader, const char* source, const char* path)
+{
+    if (loader->threadLimit <= 0) {
+        return;
+    }
+
+    Scanner scanner;
+    Scanner_Init(&scanner, source);
+
+    //Only unconditional imports, i.e. those at the top level of the module, are worth loading ahead of time.
+    //Namespaced imports are deferred until first use, so they might never be needed at all.
+    int depth = 0;
+    Token previous[2] = { { .type = TOKEN_EOF }, { .type = TOKEN_EOF } };
+
+    for (Token token = Scanner_ScanToken(&scanner); token.type != TOKEN_EOF; token = Scanner_ScanToken(&scanner)) {
+        switch (token.type) {
+            case TOKEN_L_BRACE:
+            case TOKEN_AT_L_BRACE: depth++; break;
+            case TOKEN_R_BRACE: depth--; break;
+            case TOKEN_FOR:
+            case TOKEN_SEMICOLON: {
+                if (depth == 0 && previous[0].type == TOKEN_IMPORT && previous[1].type == TOKEN_STRING && is_plain_literal(previous[1])) {
+                    submit(loader, make_file_name(path, previous[1]));
+                }
+                break;
+            }
+            default: break;
+        }
+
+        previous[0] = previous[1];
+        previous[1] = token;
+    }
+}
+
+//Hands over the source of a module read ahead of time, or returns NULL if the caller has to read it itself.
+//Modules that could not be read are read again by the caller, which reports the error as usual.
+char* Loader_Take(Loader* loader, const char* fileName)
+{
+    mtx_lock(&loader->lock);
+
+    LoaderJob* job = find_job(loader, fileName);
+    if (!job) {
+        mtx_unlock(&loader->lock);
+        return NULL;
+    }
+
+    //Nobody has picked the module up yet, so it is quicker to let the caller load it directly
+    if (job->state == JOB_PENDING) {
+        unqueue(loader, job);
+        job->state = JOB_TAKEN;
+        mtx_unlock(&loader->lock);
+        return NULL;
+    }
+
+    while (job->state == JOB_RUNNING) {
+        cnd_wait(&loader->jobFinished, &loader->lock);
+    }
+
+    char* source = job->source;
+    job->source = NULL;
+    job->state = JOB_TAKEN;
+    mtx_unlock(&loader->lock);
+
+    return source;
+}
+
+//Tells the loader that the VM has read a module itself, so that workers neither read it again nor keep a copy
+void Loader_Forget(Loader* loader, const char* fileName)
+{
+    if (loader->threadLimit <= 0) {
+        return;
+    }
+
+    mtx_lock(&loader->lock);
+
+    LoaderJob* job = find_job(loader, fileName);
+    if (!job) {
+        char* name = xmalloc(strlen(fileName) + 1);
+        strcpy(name, fileName);
+        new_job(loader, name, JOB_TAKEN);
+    } else if (job->state == JOB_PENDING) {
+        unqueue(loader, job);
+        job->state = JOB_TAKEN;
+    } else if (job->state == JOB_RUNNING) {
+        job->forgotten = true;
+    } else if (job->state == JOB_DONE) {
+        free(job->source);
+        job->source = NULL;
+        job->state = JOB_TAKEN;
+    }
+
+    mtx_unlock(&loader->lock);
+}
@@ -0,0 +1,37 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <threads.h>
+
+#include "common.h"
+
+#define LOADER_THREAD_COUNT 4
+
+typedef struct LoaderJob LoaderJob;
+
+typedef struct Loader {
+    LoaderJob* jobs;
+
+    LoaderJob* queueHead;
+    LoaderJob* queueTail;
+
+    mtx_t lock;
+    cnd_t jobQueued;
+    cnd_t jobFinished;
+
+    thrd_t threads[LOADER_THREAD_COUNT];
+    int threadCount;
+    int threadLimit;
+
+    bool shutdown;
+} Loader;
+
+void Loader_Init(Loader* loader);
+void Loader_Free(Loader* loader);
+
+void Loader_Prefetch(Loader* loader, const char* source, const char* path);
+
+char* Loader_Take(Loader* loader, const char* fileName);
+void Loader_Forget(Loader* loader, const char* fileName);
+
+#endif
@@ -1,36 +1,287 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
 
 #include "common.h"
 #include "vm.h"
 #include "file_reader.h"
 
-static void run_file(const char* fileName);
-static void run_prompt();
+typedef enum {
+    GC_OPTION_INITIAL_HEAP,
+    GC_OPTION_MAX_HEAP,
+    GC_OPTION_TARGET_PAUSE,
+    GC_OPTION_GROWTH_FACTOR,
+    GC_OPTION_MARK_THREADS,
+    GC_OPTION_COUNT
+} GCOption;
+
+//Every knob of the collector may be set from the environment, and the flags given on the command line take precedence
+static const char* gcFlags[GC_OPTION_COUNT] = {
+    "--gc-initial-heap=",
+    "--gc-max-heap=",
+    "--gc-target-pause=",
+    "--gc-growth-factor=",
+    "--gc-mark-threads="
+};
+
+static const char* gcVariables[GC_OPTION_COUNT] = {
+    "ARCHER_GC_INITIAL_HEAP",
+    "ARCHER_GC_MAX_HEAP",
+    "ARCHER_GC_TARGET_PAUSE",
+    "ARCHER_GC_GROWTH_FACTOR",
+    "ARCHER_GC_MARK_THREADS"
+};
+
+//Files that a run records its profile to and takes an earlier one from, if it was asked to
+typedef struct ProfileFiles {
+    const char* recorded;
+    const char* used;
+} ProfileFiles;
+
+static void print_usage();
+static void read_environment(GCOptions* options);
+static bool read_flag(GCOptions* options, ProfileFiles* profiles, const char* arg);
+static bool set_option(GCOptions* options, GCOption option, const char* value);
+
+static void run_file(const char* fileName, const GCOptions* options, const ProfileFiles* profiles);
+static void run_prompt(const GCOptions* options);
 
 int main(int argc, const char* argv[])
 {
-    if (argc > 2) {
-        fprintf(stderr, "Usage: archer [script]\n");
-        exit(ERR_USAGE);
-    } else if (argc == 2) {
-        run_file(argv[1]);
+    GCOptions options;
+    GC_DefaultOptions(&options);
+    read_environment(&options);
+
+    ProfileFiles profiles = { NULL, NULL };
+
+    const char* fileName = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0) {
+            if (!read_flag(&options, &profiles, argv[i])) {
+                print_usage();
+                exit(ERR_USAGE);
+            }
+        } else if (!fileName) {
+            fileName = argv[i];
+        } else {
+            print_usage();
+            exit(ERR_USAGE);
+        }
+    }
+
+    if (fileName) {
+        run_file(fileName, &options, &profiles);
     } else {
-        run_prompt();
+        run_prompt(&options);
     }
 
     return 0;
 }
 
-void run_file(const char* fileName)
+void print_usage()
+{
+    fprintf(stderr, "Usage: archer [options] [script]\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --gc-initial-heap=SIZE    Heap size that triggers the first full collection (%s)\n", gcVariables[GC_OPTION_INITIAL_HEAP]);
+    fprintf(stderr, "  --gc-max-heap=SIZE        Heap size past which the program runs out of memory (%s)\n", gcVariables[GC_OPTION_MAX_HEAP]);
+    fprintf(stderr, "  --gc-target-pause=MS      Pause that incremental collection steps aim for (%s)\n", gcVariables[GC_OPTION_TARGET_PAUSE]);
+    fprintf(stderr, "  --gc-growth-factor=X      Least growth of the heap between full collections (%s)\n", gcVariables[GC_OPTION_GROWTH_FACTOR]);
+    fprintf(stderr, "  --gc-mark-threads=N       Threads that share the marking and sweeping of a pause (%s)\n", gcVariables[GC_OPTION_MARK_THREADS]);
+    fprintf(stderr, "  --emit-profile=FILE       Record how the script runs to a profile, or to the output if FILE is '-'\n");
+    fprintf(stderr, "  --use-profile=FILE        Compile the script for the way that a recorded profile found it to run\n");
+    fprintf(stderr, "Sizes are in bytes, unless followed by K, M or G.\n");
+}
+
+void read_environment(GCOptions* options)
+{
+    for (int i = 0; i < GC_OPTION_COUNT; i++) {
+        const char* value = getenv(gcVariables[i]);
+        if (value && !set_option(options, (GCOption)i, value)) {
+            fprintf(stderr, "Invalid value '%s' of %s.\n", value, gcVariables[i]);
+            exit(ERR_USAGE);
+        }
+    }
+}
+
+static const char* flag_value(const char* arg, const char* flag)
+{
+    size_t length = strlen(flag);
+    return strncmp(arg, flag, length) == 0 ? arg + length : NULL;
+}
+
+bool read_flag(GCOptions* options, ProfileFiles* profiles, const char* arg)
+{
+    const char* file = NULL;
+    if ((file = flag_value(arg, "--emit-profile=")) != NULL) {
+        profiles->recorded = file;
+    } else if ((file = flag_value(arg, "--use-profile=")) != NULL) {
+        profiles->used = file;
+    }
+
+    if (file) {
+        if (*file == '\0') {
+            fprintf(stderr, "Missing file of %.*s.\n", (int)(strchr(arg, '=') - arg), arg);
+            return false;
+        }
+
+        return true;
+    }
+
+    for (int i = 0; i < GC_OPTION_COUNT; i++) {
+        size_t length = strlen(gcFlags[i]);
+        if (strncmp(arg, gcFlags[i], length) != 0) {
+            continue;
+        }
+
+        if (!set_option(options, (GCOption)i, arg + length)) {
+            fprintf(stderr, "Invalid value '%s' of %.*s.\n", arg + length, (int)(length - 1), gcFlags[i]);
+            return false;
+        }
+
+        return true;
+    }
+
+    fprintf(stderr, "Unknown option '%s'.\n", arg);
+    return false;
+}
+
+//The growth factor is capped well short of where the thresholds it produces would stop being meaningful
+#define MAX_GROWTH_FACTOR 1000.0
+
+static bool parse_number(const char* text, double* result, const char** end)
+{
+    char* last;
+    *result = strtod(text, &last);
+    *end = last;
+    return last != text && isfinite(*result) && *result >= 0.0;
+}
+
+static bool parse_size(const char* text, size_t* result)
+{
+    double number;
+    const char* end;
+    if (!parse_number(text, &number, &end)) {
+        return false;
+    }
+
+    switch (toupper((unsigned char)*end)) {
+        case 'K': number *= 1024.0; end++; break;
+        case 'M': number *= 1024.0 * 1024.0; end++; break;
+        case 'G': number *= 1024.0 * 1024.0 * 1024.0; end++; break;
+    }
+
+    if (*end != '\0' || number >= (double)SIZE_MAX) {
+        return false;
+    }
+
+    *result = (size_t)number;
+    return true;
+}
+
+bool set_option(GCOptions* options, GCOption option, const char* value)
+{
+    double number;
+    const char* end;
+
+    switch (option) {
+        case GC_OPTION_INITIAL_HEAP:
+            return parse_size(value, &options->initialHeap) && options->initialHeap > 0;
+        case GC_OPTION_MAX_HEAP:
+            return parse_size(value, &options->maxHeap);
+        case GC_OPTION_TARGET_PAUSE:
+            if (!parse_number(value, &number, &end) || *end != '\0') {
+                return false;
+            }
+
+            options->targetPause = number / 1000.0;
+            return true;
+        case GC_OPTION_GROWTH_FACTOR:
+            if (!parse_number(value, &number, &end) || *end != '\0' || number <= 1.0) {
+                return false;
+            }
+
+            options->growthFactor = number < MAX_GROWTH_FACTOR ? number : MAX_GROWTH_FACTOR;
+            return true;
+        case GC_OPTION_MARK_THREADS:
+            if (!parse_number(value, &number, &end) || *end != '\0' || number < 1.0 || number != floor(number)) {
+                return false;
+            }
+
+            options->markThreads = number < GC_MAX_MARK_THREADS ? (int)number : GC_MAX_MARK_THREADS;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void read_profile(Profile* profile, const char* fileName)
+{
+    Profile_Init(profile);
+
+    char* source = Reader_ReadFile(fileName);
+    int line;
+    bool valid = Profile_Read(profile, source, &line);
+    free(source);
+
+    if (!valid) {
+        fprintf(stderr, "Invalid profile '%s' on line %d.\n", fileName, line);
+        exit(ERR_DATA);
+    }
+}
+
+static void write_profile(Profile* profile, const char* fileName)
+{
+    bool toOutput = strcmp(fileName, "-") == 0;
+
+    FILE* file = toOutput ? stdout : fopen(fileName, "w");
+    bool written = file != NULL && Profile_Write(profile, file);
+    if (file != NULL && !toOutput) {
+        written = fclose(file) == 0 && written;
+    }
+
+    if (!written) {
+        fprintf(stderr, "Could not write profile '%s'.\n", fileName);
+        exit(ERR_IO);
+    }
+}
+
+void run_file(const char* fileName, const GCOptions* options, const ProfileFiles* profiles)
 {
     VM vm;
     Vm_Init(&vm);
+    GC_Configure(&vm.gc, options);
+
+    Profile used;
+    if (profiles->used) {
+        read_profile(&used, profiles->used);
+        vm.usedProfile = &used;
+    }
+
+    Profile recorded;
+    if (profiles->recorded) {
+        Profile_Init(&recorded);
+        vm.recordedProfile = &recorded;
+    }
 
     char* source = Reader_ReadFile(fileName);
     InterpretStatus status = Vm_Interpret(&vm, source, fileName);
     free(source);
 
+    //A run that stops at an error still records what it got to do
+    if (profiles->recorded) {
+        write_profile(&recorded, profiles->recorded);
+        Profile_Free(&recorded);
+    }
+
+    if (profiles->used) {
+        Profile_Free(&used);
+    }
+
+    vm.recordedProfile = NULL;
+    vm.usedProfile = NULL;
+
     if (status == INTERPRET_COMPILE_ERROR) {
         exit(ERR_DATA);
     }
@@ -41,10 +292,11 @@ void run_file(const char* fileName)
     Vm_Free(&vm);
 }
 
-void run_prompt()
+void run_prompt(const GCOptions* options)
 {
     VM vm;
     Vm_Init(&vm);
+    GC_Configure(&vm.gc, options);
 
     char line[1024];
     while (true) {
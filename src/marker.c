@@ -0,0 +1,238 @@
+#include <string.h>
+
+#include "marker.h"
+#include "object.h"
+#include "memory.h"
+
+//Workers keep their gray objects to themselves and only share some once another worker runs out
+#define MARKER_SHARE_MIN 32
+#define MARKER_TAKE_MAX 256
+
+static thread_local MarkerWorker* current = NULL;
+
+void Marker_Init(Marker* marker, GC* gc, int workerCount)
+{
+    marker->gc = gc;
+
+    marker->workers = xmalloc(sizeof(MarkerWorker) * workerCount);
+    marker->threads = xmalloc(sizeof(thrd_t) * workerCount);
+    marker->workerCount = workerCount;
+
+    for (int i = 0; i < workerCount; i++) {
+        marker->workers[i].marker = marker;
+        marker->workers[i].stack = NULL;
+        marker->workers[i].count = 0;
+        marker->workers[i].capacity = 0;
+    }
+
+    marker->threadCount = 0;
+    marker->started = false;
+
+    marker->pool = NULL;
+    marker->poolCount = 0;
+    marker->poolCapacity = 0;
+
+    mtx_init(&marker->lock, mtx_plain);
+    cnd_init(&marker->workShared);
+    cnd_init(&marker->phaseStarted);
+    cnd_init(&marker->phaseFinished);
+
+    atomic_init(&marker->idleCount, 0);
+    marker->finishedCount = 0;
+    marker->job = NULL;
+    marker->phase = 0;
+    marker->done = false;
+    marker->shutdown = false;
+}
+
+void Marker_Free(Marker* marker)
+{
+    mtx_lock(&marker->lock);
+    marker->shutdown = true;
+    cnd_broadcast(&marker->phaseStarted);
+    mtx_unlock(&marker->lock);
+
+    for (int i = 0; i < marker->threadCount; i++) {
+        thrd_join(marker->threads[i], NULL);
+    }
+
+    for (int i = 0; i < marker->workerCount; i++) {
+        free(marker->workers[i].stack);
+    }
+
+    free(marker->workers);
+    free(marker->threads);
+    free(marker->pool);
+
+    cnd_destroy(&marker->phaseFinished);
+    cnd_destroy(&marker->phaseStarted);
+    cnd_destroy(&marker->workShared);
+    mtx_destroy(&marker->lock);
+}
+
+static void push(MarkerWorker* worker, Object* object)
+{
+    if (worker->capacity < worker->count + 1) {
+        worker->capacity = GROW_CAPACITY(worker->capacity);
+        worker->stack = xrealloc(worker->stack, sizeof(Object*) * worker->capacity);
+    }
+
+    worker->stack[worker->count++] = object;
+}
+
+void Marker_Push(Object* object)
+{
+    push(current, object);
+}
+
+static void share_work(Marker* marker, MarkerWorker* worker)
+{
+    mtx_lock(&marker->lock);
+
+    size_t shared = worker->count / 2;
+    if (marker->poolCapacity < marker->poolCount + shared) {
+        marker->poolCapacity = marker->poolCount + shared;
+        marker->pool = xrealloc(marker->pool, sizeof(Object*) * marker->poolCapacity);
+    }
+
+    worker->count -= shared;
+    memcpy(marker->pool + marker->poolCount, worker->stack + worker->count, sizeof(Object*) * shared);
+    marker->poolCount += shared;
+
+    cnd_broadcast(&marker->workShared);
+    mtx_unlock(&marker->lock);
+}
+
+//Waits until there is shared work to take, or returns false once every worker has run out
+static bool take_work(Marker* marker, MarkerWorker* worker)
+{
+    mtx_lock(&marker->lock);
+    while (true) {
+        if (marker->poolCount > 0) {
+            size_t taken = marker->poolCount < MARKER_TAKE_MAX ? marker->poolCount : MARKER_TAKE_MAX;
+            marker->poolCount -= taken;
+            for (size_t i = 0; i < taken; i++) {
+                push(worker, marker->pool[marker->poolCount + i]);
+            }
+
+            mtx_unlock(&marker->lock);
+            return true;
+        }
+
+        if (marker->done) {
+            mtx_unlock(&marker->lock);
+            return false;
+        }
+
+        //Idle workers have nothing left to share, so once all of them are idle the marking is complete
+        int idle = atomic_fetch_add(&marker->idleCount, 1) + 1;
+        if (idle == marker->threadCount + 1) {
+            marker->done = true;
+            cnd_broadcast(&marker->workShared);
+        } else {
+            cnd_wait(&marker->workShared, &marker->lock);
+        }
+
+        atomic_fetch_sub(&marker->idleCount, 1);
+    }
+}
+
+static void drain(MarkerWorker* worker)
+{
+    Marker* marker = worker->marker;
+
+    do {
+        while (worker->count > 0) {
+            Object* object = worker->stack[--worker->count];
+            Object_Traverse(object, marker->gc);
+
+            if (worker->count >= MARKER_SHARE_MIN && atomic_load_explicit(&marker->idleCount, memory_order_relaxed) > 0) {
+                share_work(marker, worker);
+            }
+        }
+    } while (take_work(marker, worker));
+}
+
+static int worker_main(void* arg)
+{
+    MarkerWorker* worker = (MarkerWorker*)arg;
+    Marker* marker = worker->marker;
+    current = worker;
+
+    size_t phase = 0;
+
+    mtx_lock(&marker->lock);
+    while (true) {
+        while (marker->phase == phase && !marker->shutdown) {
+            cnd_wait(&marker->phaseStarted, &marker->lock);
+        }
+
+        if (marker->shutdown) {
+            break;
+        }
+
+        phase = marker->phase;
+        MarkerJob job = marker->job;
+        mtx_unlock(&marker->lock);
+
+        job(worker);
+
+        mtx_lock(&marker->lock);
+        marker->finishedCount++;
+        cnd_signal(&marker->phaseFinished);
+    }
+    mtx_unlock(&marker->lock);
+
+    return 0;
+}
+
+static void start_workers(Marker* marker)
+{
+    marker->started = true;
+
+    //The calling thread is the first worker, so one fewer thread is needed
+    while (marker->threadCount < marker->workerCount - 1) {
+        MarkerWorker* worker = &marker->workers[marker->threadCount + 1];
+        if (thrd_create(&marker->threads[marker->threadCount], worker_main, worker) != thrd_success) {
+            break;
+        }
+
+        marker->threadCount++;
+    }
+}
+
+void Marker_Run(Marker* marker, MarkerJob job)
+{
+    if (!marker->started) {
+        start_workers(marker);
+    }
+
+    MarkerWorker* worker = &marker->workers[0];
+    current = worker;
+
+    mtx_lock(&marker->lock);
+    marker->done = false;
+    marker->finishedCount = 0;
+    marker->job = job;
+    marker->phase++;
+    cnd_broadcast(&marker->phaseStarted);
+    mtx_unlock(&marker->lock);
+
+    job(worker);
+
+    mtx_lock(&marker->lock);
+    while (marker->finishedCount < marker->threadCount) {
+        cnd_wait(&marker->phaseFinished, &marker->lock);
+    }
+    mtx_unlock(&marker->lock);
+}
+
+void Marker_Trace(Marker* marker, Object** objects, size_t count)
+{
+    MarkerWorker* worker = &marker->workers[0];
+    for (size_t i = 0; i < count; i++) {
+        push(worker, objects[i]);
+    }
+
+    Marker_Run(marker, drain);
+}
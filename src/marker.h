@@ -0,0 +1,58 @@
+#ifndef MARKER_H
+#define MARKER_H
+
+#include <threads.h>
+#include <stdatomic.h>
+
+#include "common.h"
+
+typedef struct Object Object;
+typedef struct GC GC;
+
+typedef struct Marker Marker;
+
+typedef struct MarkerWorker {
+    Marker* marker;
+
+    Object** stack;
+    size_t count;
+    size_t capacity;
+} MarkerWorker;
+
+//A job is run by every worker at once, and each one returns once there is nothing left for it to do
+typedef void (*MarkerJob)(MarkerWorker* worker);
+
+struct Marker {
+    GC* gc;
+
+    MarkerWorker* workers;
+    thrd_t* threads;
+    int workerCount;
+    int threadCount;
+    bool started;
+
+    Object** pool;
+    size_t poolCount;
+    size_t poolCapacity;
+
+    mtx_t lock;
+    cnd_t workShared;
+    cnd_t phaseStarted;
+    cnd_t phaseFinished;
+
+    atomic_int idleCount;
+    int finishedCount;
+    MarkerJob job;
+    size_t phase;
+    bool done;
+    bool shutdown;
+};
+
+void Marker_Init(Marker* marker, GC* gc, int workerCount);
+void Marker_Free(Marker* marker);
+
+void Marker_Run(Marker* marker, MarkerJob job);
+void Marker_Trace(Marker* marker, Object** objects, size_t count);
+void Marker_Push(Object* object);
+
+#endif
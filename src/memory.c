@@ -1,31 +1,140 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "memory.h"
 #include "gc.h"
 
 #include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+static void out_of_memory()
+{
+    fprintf(stderr, "Could not allocate memory!\n");
+    abort();
+}
 
 void* xmalloc(size_t size)
 {
     void* ptr = malloc(size);
     if (ptr == NULL) {
-        fprintf(stderr, "Could not allocate memory!\n");
-        abort();
+        out_of_memory();
+    }
+
+    return ptr;
+}
+
+void* xrealloc(void* pointer, size_t size)
+{
+    void* ptr = realloc(pointer, size);
+    if (ptr == NULL) {
+        out_of_memory();
     }
 
     return ptr;
 }
 
+static void* acquire(GC* gc, size_t size)
+{
+    if (size <= POOL_MAX_SIZE) {
+        return Pool_Allocate(&gc->pool, size);
+    } else if (size >= MEM_LARGE_SIZE) {
+        return Mem_MapPages(MEM_MAPPED_SIZE(size));
+    } else {
+        return xmalloc(size);
+    }
+}
+
+static void release(GC* gc, void* pointer, size_t size)
+{
+    if (size <= POOL_MAX_SIZE) {
+        Pool_Deallocate(&gc->pool, pointer, size);
+    } else if (size >= MEM_LARGE_SIZE) {
+        Mem_UnmapPages(pointer, MEM_MAPPED_SIZE(size));
+    } else {
+        free(pointer);
+    }
+}
+
+//Unlike memory from malloc, unmapped pages are given back to the system right away
+void* Mem_MapPages(size_t size)
+{
+#ifdef _WIN32
+    //Allocations made this way are always aligned to at least 64 KB
+    void* pages = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (pages == NULL) {
+        out_of_memory();
+    }
+
+    return pages;
+#else
+    //Mappings are only aligned to the system's page size, so a larger range is mapped and trimmed down to an aligned one
+    size_t mapped = size + MEM_PAGE_ALIGNMENT;
+    char* start = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (start == MAP_FAILED) {
+        out_of_memory();
+    }
+
+    char* pages = (char*)(((uintptr_t)start + MEM_PAGE_ALIGNMENT - 1) & ~(uintptr_t)(MEM_PAGE_ALIGNMENT - 1));
+    if (pages > start) {
+        munmap(start, pages - start);
+    }
+
+    if (start + mapped > pages + size) {
+        munmap(pages + size, start + mapped - (pages + size));
+    }
+
+    return pages;
+#endif
+}
+
+void Mem_UnmapPages(void* pages, size_t size)
+{
+#ifdef _WIN32
+    VirtualFree(pages, 0, MEM_RELEASE);
+#else
+    munmap(pages, size);
+#endif
+}
+
+//Keeps the contents of the pages, though unlike freshly mapped ones the result may only be aligned to a system page
+void* Mem_RemapPages(void* pages, size_t oldSize, size_t newSize)
+{
+#ifdef __linux__
+    void* result = mremap(pages, oldSize, newSize, MREMAP_MAYMOVE);
+    if (result == MAP_FAILED) {
+        out_of_memory();
+    }
+
+    return result;
+#else
+    void* result = Mem_MapPages(newSize);
+    memcpy(result, pages, oldSize < newSize ? oldSize : newSize);
+    Mem_UnmapPages(pages, oldSize);
+    return result;
+#endif
+}
+
 void* Mem_Allocate(GC* gc, size_t size)
 {
     GC_AllocateBytes(gc, size);
     GC_AttemptCollection(gc);
 
-    return xmalloc(size);
+    return acquire(gc, size);
 }
 
 void Mem_Deallocate(GC* gc, void* pointer, size_t size)
 {
     GC_DeallocateBytes(gc, size);
-    free(pointer);
+    if (pointer) {
+        release(gc, pointer, size);
+    }
 }
 
 void* Mem_Reallocate(GC* gc, void* pointer, size_t oldSize, size_t newSize)
@@ -37,5 +146,37 @@ void* Mem_Reallocate(GC* gc, void* pointer, size_t oldSize, size_t newSize)
         GC_DeallocateBytes(gc, oldSize - newSize);
     }
 
-    return realloc(pointer, newSize);
+    //Large blocks are moved by the system, which only has to remap their pages instead of copying them
+    if (pointer && oldSize >= MEM_LARGE_SIZE && newSize >= MEM_LARGE_SIZE) {
+        if (MEM_MAPPED_SIZE(oldSize) == MEM_MAPPED_SIZE(newSize)) {
+            return pointer;
+        }
+
+        return Mem_RemapPages(pointer, MEM_MAPPED_SIZE(oldSize), MEM_MAPPED_SIZE(newSize));
+    }
+
+    if (oldSize > POOL_MAX_SIZE && oldSize < MEM_LARGE_SIZE && newSize > POOL_MAX_SIZE && newSize < MEM_LARGE_SIZE) {
+        return xrealloc(pointer, newSize);
+    }
+
+    if (newSize == 0) {
+        if (pointer) {
+            release(gc, pointer, oldSize);
+        }
+
+        return NULL;
+    }
+
+    //Blocks of the same size class already have room for the new size
+    if (pointer && oldSize <= POOL_MAX_SIZE && POOL_CLASS(oldSize) == POOL_CLASS(newSize)) {
+        return pointer;
+    }
+
+    void* result = acquire(gc, newSize);
+    if (pointer) {
+        memcpy(result, pointer, oldSize < newSize ? oldSize : newSize);
+        release(gc, pointer, oldSize);
+    }
+
+    return result;
 }
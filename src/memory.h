@@ -6,6 +6,14 @@
 
 typedef struct GC GC;
 
+//Pages mapped straight from the system are aligned to this, so that the page holding an address is found by masking it
+#define MEM_PAGE_ALIGNMENT (64 * 1024)
+
+//Allocations at least this large get mappings of their own, which grow without copying and are given back once freed
+#define MEM_LARGE_SIZE (128 * 1024)
+
+#define MEM_MAPPED_SIZE(size) (((size) + MEM_PAGE_ALIGNMENT - 1) & ~(size_t)(MEM_PAGE_ALIGNMENT - 1))
+
 #define ALLOCATE(gc, type, length)                                                                  \
     (type*)Mem_Allocate(gc, sizeof(type) * (length))                                                \
 
@@ -19,9 +27,14 @@ typedef struct GC GC;
     (type*)Mem_Reallocate(gc, pointer, sizeof(type) * (oldCapacity), sizeof(type) * (newCapacity))  \
 
 #define FREE_ARRAY(gc, type, pointer, capacity)                                                     \
-    Mem_Deallocate(gc, pointer, sizeof(type) * capacity)                                            \
+    Mem_Deallocate(gc, pointer, sizeof(type) * (capacity))                                          \
 
 void* xmalloc(size_t size);
+void* xrealloc(void* pointer, size_t size);
+
+void* Mem_MapPages(size_t size);
+void Mem_UnmapPages(void* pages, size_t size);
+void* Mem_RemapPages(void* pages, size_t oldSize, size_t newSize);
 
 void* Mem_Allocate(GC* gc, size_t size);
 void Mem_Deallocate(GC* gc, void* pointer, size_t size);
@@ -104,12 +104,29 @@ static Value coroutine_pop(ObjectCoroutine* coroutine)
     return *coroutine->stackTop;
 }
 
+static bool has_number_arguments(Value* slots, uint32_t parameters)
+{
+    for (int slot = 1; (parameters >> slot) != 0; slot++) {
+        if ((parameters >> slot & 1) && !IS_NUMBER(slots[slot])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 static void push_call_frame(ObjectCoroutine* coroutine, ObjectClosure* closure, uint8_t argCount)
 {
     CallFrame* frame = &coroutine->frames[coroutine->frameCount++];
     frame->closure = closure;
-    frame->ip = closure->function->chunk.code;
     frame->slots = coroutine->stackTop - argCount - 1;
+
+    //Functions specialised from a profile are entered at the copy that takes the arguments to be numbers if they are
+    ObjectFunction* function = closure->function;
+    frame->ip = function->chunk.code;
+    if (function->numberParameters != 0 && argCount == function->arity && has_number_arguments(frame->slots, function->numberParameters)) {
+        frame->ip += function->specialisedEntry;
+    }
 }
 
 static bool call_routine(VM* vm, ObjectCoroutine* coroutine, ObjectClosure* closure, uint8_t argCount)
@@ -170,6 +187,7 @@ static bool coroutine_call(Object* callee, uint8_t argCount, VM* vm)
 
     coroutine->transfer = vm->coroutine;
     vm->coroutine = coroutine;
+    GC_WRITE_BARRIER(&vm->gc, coroutine);
 
     if (coroutine->started) {
         Vm_Push(vm, value);
@@ -303,4 +321,5 @@ void Coroutine_Run(VM* vm, ObjectCoroutine* coroutine)
     coroutine->transfer = vm->coroutine;
     coroutine->started = true;
     vm->coroutine = coroutine;
+    GC_WRITE_BARRIER(&vm->gc, coroutine);
 }
\ No newline at end of file
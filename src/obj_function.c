@@ -37,6 +37,7 @@ static void function_traverse(Object* object, GC* gc)
     ObjectFunction* function = AS_FUNCTION(object);
     GC_MarkObject(gc, (Object*)function->mod);
     GC_MarkObject(gc, (Object*)function->name);
+    GC_MarkObject(gc, (Object*)function->closure);
     GC_MarkArray(gc, &function->chunk.constants);
     Object_GenericTraverse(object, gc);
 }
@@ -77,7 +78,11 @@ ObjectFunction* Function_New(VM* vm)
 {
     ObjectFunction* function = ALLOCATE_FUNCTION(vm);
     function->arity = 0;
+    function->numberParameters = 0;
+    function->specialisedEntry = 0;
     function->upvalueCount = 0;
+    function->captureCount = 0;
+    function->closure = NULL;
     function->name = NULL;
     Chunk_Init(&function->chunk);
     return function;
@@ -157,14 +162,17 @@ static void closure_traverse(Object* object, GC* gc)
         GC_MarkObject(gc, (Object*)closure->upvalues[i]);
     }
 
+    for (size_t i = 0; i < closure->captureCount; i++) {
+        GC_MarkValue(gc, closure->captures[i]);
+    }
+
     Object_GenericTraverse(object, gc);
 }
 
 static void closure_free(Object* object, GC* gc)
 {
     ObjectClosure* closure = AS_CLOSURE(object);
-    FREE_ARRAY(gc, ObjectUpvalue*, closure->upvalues, closure->upvalueCount);
-    Object_Deallocate(gc, object);
+    GC_DeallocateObject(gc, closure, CLOSURE_SIZE(closure->upvalueCount, closure->captureCount));
 }
 
 ObjectType* Closure_NewType(VM* vm)
@@ -195,15 +203,22 @@ void Closure_PrepareType(ObjectType* type, VM* vm)
 
 ObjectClosure* Closure_New(VM* vm, ObjectFunction* function)
 {
-    ObjectUpvalue** upvalues = ALLOCATE(&vm->gc, ObjectUpvalue*, function->upvalueCount);
+    //Upvalues and captured values are laid out right after the closure in a single allocation
+    ObjectClosure* closure = ALLOCATE_CLOSURE(vm, function->upvalueCount, function->captureCount);
+    closure->base.type = vm->closureType;
+    closure->function = function;
+    closure->upvalueCount = function->upvalueCount;
+    closure->captureCount = function->captureCount;
+    closure->captures = (Value*)((char*)closure->upvalues + CLOSURE_UPVALUES_SIZE(function->upvalueCount));
+
     for (size_t i = 0; i < function->upvalueCount; i++) {
-        upvalues[i] = NULL;
+        closure->upvalues[i] = NULL;
+    }
+
+    for (size_t i = 0; i < function->captureCount; i++) {
+        closure->captures[i] = NIL_VAL();
     }
 
-    ObjectClosure* closure = ALLOCATE_CLOSURE(vm);
-    closure->function = function;
-    closure->upvalues = upvalues;
-    closure->upvalueCount = function->upvalueCount;
     return closure;
 }
 
@@ -15,6 +15,7 @@
 
 typedef struct ObjectString ObjectString;
 typedef struct ObjectModule ObjectModule;
+typedef struct ObjectClosure ObjectClosure;
 
 typedef struct ObjectFunction {
     Object base;
@@ -22,8 +23,17 @@ typedef struct ObjectFunction {
     ObjectModule* mod;
 
     size_t upvalueCount;
+    size_t captureCount;
     Chunk chunk;
     int arity;
+
+    //Parameters that a profile found to always be numbers, as a mask of their slots, and where the copy of the
+    //code that takes them to be numbers begins
+    uint32_t numberParameters;
+    size_t specialisedEntry;
+
+    //Functions that capture nothing share a single closure
+    ObjectClosure* closure;
 } ObjectFunction;
 
 ObjectType* Function_NewType(VM* vm);
@@ -57,13 +67,22 @@ ObjectUpvalue* Upvalue_New(VM* vm, Value* slot);
 #define VAL_AS_CLOSURE(value) (AS_CLOSURE(AS_OBJ(value)))
 #define VAL_IS_CLOSURE(value, vm) (Object_ValueHasType(value, vm->closureType))
 
-#define ALLOCATE_CLOSURE(vm) (AS_CLOSURE(ALLOCATE_OBJ(vm, vm->closureType)))
+#define CLOSURE_UPVALUES_SIZE(upvalueCount)                                                         \
+    ((sizeof(ObjectUpvalue*) * (upvalueCount) + sizeof(Value) - 1) / sizeof(Value) * sizeof(Value)) \
+
+#define CLOSURE_SIZE(upvalueCount, captureCount)                                                    \
+    (sizeof(ObjectClosure) + CLOSURE_UPVALUES_SIZE(upvalueCount) + sizeof(Value) * (captureCount))  \
+
+#define ALLOCATE_CLOSURE(vm, upvalueCount, captureCount)                                            \
+    (AS_CLOSURE(Object_Allocate((vm), CLOSURE_SIZE(upvalueCount, captureCount))))                   \
 
 typedef struct ObjectClosure {
     Object base;
     ObjectFunction* function;
-    ObjectUpvalue** upvalues;
     size_t upvalueCount;
+    size_t captureCount;
+    Value* captures;
+    ObjectUpvalue* upvalues[];
 } ObjectClosure;
 
 ObjectType* Closure_NewType(VM* vm);
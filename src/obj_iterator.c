@@ -35,7 +35,7 @@ ObjectType* Iterator_NewType(VM* vm)
     type->ToString = iterator_to_string;
     type->Print = iterator_print;
     type->Hash = Object_GenericHash;
-    type->GetField = Object_GenericGetField;
+    type->GetField = NULL;
     type->SetField = NULL;
     type->GetSubscript = NULL;
     type->SetSubscript = NULL;
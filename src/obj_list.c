@@ -18,7 +18,7 @@ static bool iterator_reached_end(ObjectIterator* iterator)
 
 static void iterator_advance(ObjectIterator* iterator)
 {
-    ((Value*)iterator->ptr)++;
+    iterator->ptr = (Value*)iterator->ptr + 1;
 }
 
 static Value iterator_get_value(VM* vm, ObjectIterator* iterator)
@@ -40,7 +40,7 @@ static ObjectIterator* make_iterator(VM* vm, ObjectList* list)
 static bool method_append(VM* vm, Value* args)
 {
     ObjectList* list = VAL_AS_LIST(args[-1]);
-    VECTOR_PUSH(&vm->gc, ValueArray, &list->elements, Value, args[0]);
+    List_Append(list, args[0], vm);
     args[-1] = NIL_VAL();
     return true;
 }
@@ -124,6 +124,13 @@ static Value* list_at_index(ObjectList* list, int index, VM* vm)
     }
 }
 
+static void mark_dirty(ObjectList* list, size_t index)
+{
+    if (index < list->dirtyFrom) {
+        list->dirtyFrom = index;
+    }
+}
+
 static bool list_get_subscript(Object* object, Value index, VM* vm, Value* result)
 {
     if (!IS_NUMBER(index)) {
@@ -155,6 +162,7 @@ static bool list_set_subscript(Object* object, Value index, Value value, VM* vm)
     }
 
     *element = value;
+    mark_dirty(list, (size_t)(element - list->elements.data));
     return true;
 }
 
@@ -165,7 +173,18 @@ static ObjectIterator* list_make_iterator(Object* object, VM* vm)
 
 static void list_traverse(Object* object, GC* gc)
 {
-    GC_MarkArray(gc, &AS_LIST(object)->elements);
+    ObjectList* list = AS_LIST(object);
+
+    //Elements before the dirty index were already there during the previous collection, so they cannot be young
+    size_t first = gc->tracing == TRACE_YOUNG ? list->dirtyFrom : 0;
+    for (size_t i = first; i < list->elements.count; i++) {
+        GC_MarkValue(gc, list->elements.data[i]);
+    }
+
+    //Incremental steps skip young elements, so they cannot clean the list
+    if (gc->tracing != TRACE_OLD) {
+        list->dirtyFrom = list->elements.count;
+    }
     Object_GenericTraverse(object, gc);
 }
 
@@ -184,7 +203,7 @@ ObjectType* List_NewType(VM* vm)
     type->ToString = list_to_string;
     type->Print = list_print;
     type->Hash = Object_GenericHash;
-    type->GetField = Object_GenericGetField;
+    type->GetField = NULL;
     type->SetField = NULL;
     type->GetSubscript = list_get_subscript;
     type->SetSubscript = list_set_subscript;
@@ -208,10 +227,13 @@ ObjectList* List_New(VM* vm)
 {
     ObjectList* list = ALLOCATE_LIST(vm);
     VECTOR_INIT(ValueArray, &list->elements);
+    list->dirtyFrom = 0;
     return list;
 }
 
 void List_Append(ObjectList* list, Value value, VM* vm)
 {
     VECTOR_PUSH(&vm->gc, ValueArray, &list->elements, Value, value);
+    mark_dirty(list, list->elements.count - 1);
+    GC_WRITE_BARRIER(&vm->gc, list);
 }
@@ -14,6 +14,7 @@
 typedef struct ObjectList {
     Object base;
     ValueArray elements;
+    size_t dirtyFrom;
 } ObjectList;
 
 ObjectType* List_NewType(VM* vm);
@@ -54,6 +54,7 @@ static bool method_put_if_absent(VM* vm, Value* args)
         args[-1] = result;
     } else {
         Table_Put(vm, &map->table, args[0], args[1]);
+        GC_WRITE_BARRIER(&vm->gc, map);
         args[-1] = NIL_VAL();
     }
 
@@ -69,6 +70,7 @@ static bool method_put_all(VM* vm, Value* args)
     ObjectMap* map = VAL_AS_MAP(args[-1]);
     ObjectMap* other = VAL_AS_MAP(args[0]);
     Table_PutFrom(vm, &other->table, &map->table);
+    GC_WRITE_BARRIER(&vm->gc, map);
 
     args[-1] = NIL_VAL();
     return true;
@@ -110,7 +112,8 @@ static bool map_get_subscript(Object* object, Value index, VM* vm, Value* result
 
 static bool map_set_subscript(Object* object, Value index, Value value, VM* vm)
 {
-    return Table_Put(vm, &AS_MAP(object)->table, index, value);
+    Table_Put(vm, &AS_MAP(object)->table, index, value);
+    return true;
 }
 
 static void map_traverse(Object* object, GC* gc)
@@ -134,7 +137,7 @@ ObjectType* Map_NewType(VM* vm)
     type->ToString = map_to_string;
     type->Print = map_print;
     type->Hash = Object_GenericHash;
-    type->GetField = Object_GenericGetField;
+    type->GetField = NULL;
     type->SetField = NULL;
     type->GetSubscript = map_get_subscript;
     type->SetSubscript = map_set_subscript;
@@ -169,4 +172,5 @@ ObjectMap* Map_New(VM* vm)
 void Map_Insert(ObjectMap* map, Value key, Value value, VM* vm)
 {
     Table_Put(vm, &map->table, key, value);
+    GC_WRITE_BARRIER(&vm->gc, map);
 }
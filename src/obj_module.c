@@ -28,15 +28,22 @@ static void module_traverse(Object* object, GC* gc)
     ObjectModule* mod = AS_MODULE(object);
     GC_MarkObject(gc, (Object*)mod->path);
     GC_MarkObject(gc, (Object*)mod->name);
+    GC_MarkTable(gc, &mod->imports);
     Object_GenericTraverse(object, gc);
 }
 
+static void module_free(Object* object, GC* gc)
+{
+    Table_Free(gc, &AS_MODULE(object)->imports);
+    Object_GenericFree(object, gc);
+}
+
 ObjectType* Module_NewType(VM* vm)
 {
     ObjectType* type = Type_New(vm);
     type->name = "Module";
     type->size = sizeof(ObjectModule);
-    type->flags = 0x0;
+    type->flags = TF_HAS_FIELDS;
     type->ToString = module_to_string;
     type->Print = module_print;
     type->Hash = Object_GenericHash;
@@ -49,7 +56,7 @@ ObjectType* Module_NewType(VM* vm)
     type->MakeIterator = NULL;
     type->Call = NULL;
     type->Traverse = module_traverse;
-    type->Free = Object_GenericFree;
+    type->Free = module_free;
     return type;
 }
 
@@ -62,6 +69,7 @@ ObjectModule* Module_New(VM* vm, ObjectString* path, ObjectString* name)
     ObjectModule* mod = ALLOCATE_MODULE(vm);
     mod->path = path;
     mod->name = name;
+    Table_Init(&mod->imports);
     mod->imported = false;
     return mod;
 }
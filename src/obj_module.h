@@ -2,6 +2,7 @@
 #define OBJMODULE_H
 
 #include "object.h"
+#include "table.h"
 
 #define AS_MODULE(object) ((ObjectModule*)object)
 #define IS_MODULE(object, vm) (OBJ_TYPE(object) == vm->moduleType)
@@ -15,8 +16,10 @@ typedef struct ObjectString ObjectString;
 
 typedef struct ObjectModule {
     Object base;
+    Table fields;
     ObjectString* path;
     ObjectString* name;
+    Table imports;
     bool imported;
 } ObjectModule;
 
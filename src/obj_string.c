@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include <ctype.h>
 
 #include "vm.h"
@@ -18,7 +19,7 @@ static bool iterator_reached_end(ObjectIterator* iterator)
 
 static void iterator_advance(ObjectIterator* iterator)
 {
-    ((char*)iterator->ptr)++;
+    iterator->ptr = (char*)iterator->ptr + 1;
 }
 
 static Value iterator_get_value(VM* vm, ObjectIterator* iterator)
@@ -60,7 +61,8 @@ static bool method_to_lower(VM* vm, Value* args)
 {
     ObjectString* object = VAL_AS_STRING(args[-1]);
 
-    char* cstring = _strdup(object->chars);
+    char* cstring = xmalloc(object->length + 1);
+    memcpy(cstring, object->chars, object->length + 1);
     for (char* current = cstring; *current != '\0'; current++) {
         *current = tolower(*current);
     }
@@ -74,7 +76,8 @@ static bool method_to_upper(VM* vm, Value* args)
 {
     ObjectString* object = VAL_AS_STRING(args[-1]);
 
-    char* cstring = _strdup(object->chars);
+    char* cstring = xmalloc(object->length + 1);
+    memcpy(cstring, object->chars, object->length + 1);
     for (char* current = cstring; *current != '\0'; current++) {
         *current = toupper(*current);
     }
@@ -167,20 +170,21 @@ static ObjectIterator* string_make_iterator(Object* object, VM* vm)
 static void string_free(Object* object, GC* gc)
 {
     ObjectString* string = AS_STRING(object);
-    Table_Free(gc, &string->base.fields);
-    Mem_Deallocate(gc, string, sizeof(ObjectString) + string->length + 1);
+    GC_DeallocateObject(gc, string, sizeof(ObjectString) + string->length + 1);
 }
 
 ObjectType* String_NewType(VM* vm)
 {
     ObjectType* type = Type_New(vm);
     type->name = "String";
-    type->size = sizeof(ObjectString);
+
+    //Strings made by the constructor are empty until initialized, which still takes the terminator
+    type->size = sizeof(ObjectString) + 1;
     type->flags = 0x0;
     type->ToString = string_to_string;
     type->Print = string_print;
     type->Hash = string_hash;
-    type->GetField = Object_GenericGetField;
+    type->GetField = NULL;
     type->SetField = NULL;
     type->GetSubscript = NULL;
     type->SetSubscript = NULL;
@@ -219,6 +223,7 @@ ObjectString* String_Copy(VM* vm, const char* chars, size_t length)
     uint32_t hash = hash_cstring(chars, length);
     ObjectString* interned = Table_FindString(&vm->strings, chars, length, hash);
     if (interned != NULL) {
+        GC_KeepAlive(&vm->gc, (Object*)interned);
         return interned;
     }
 
@@ -274,9 +279,9 @@ ObjectString* String_Concatenate(VM* vm, ObjectString* a, ObjectString* b)
 
     ObjectString* interned = Table_FindString(&vm->strings, string->chars, length, string->hash);
     if (interned != NULL) {
-        vm->gc.allocatedObjects = vm->gc.allocatedObjects->next;
-        Mem_Deallocate(&vm->gc, string, sizeof(ObjectString) + string->length + 1);
+        GC_DiscardObject(&vm->gc, (Object*)string);
 
+        GC_KeepAlive(&vm->gc, (Object*)interned);
         return interned;
     } else {
         Vm_PushTemporary(vm, OBJ_VAL(string));
@@ -18,7 +18,7 @@ static bool iterator_reached_end(ObjectIterator* iterator)
 
 static void iterator_advance(ObjectIterator* iterator)
 {
-    ((Value*)iterator->ptr)++;
+    iterator->ptr = (Value*)iterator->ptr + 1;
 }
 
 static Value iterator_get_value(VM* vm, ObjectIterator* iterator)
@@ -155,8 +155,7 @@ static void tuple_traverse(Object* object, GC* gc)
 static void tuple_free(Object* object, GC* gc)
 {
     ObjectTuple* tuple = AS_TUPLE(object);
-    Table_Free(gc, &tuple->base.fields);
-    Mem_Deallocate(gc, tuple, sizeof(ObjectTuple) + sizeof(Value) * tuple->length);
+    GC_DeallocateObject(gc, tuple, sizeof(ObjectTuple) + sizeof(Value) * tuple->length);
 }
 
 ObjectType* Tuple_NewType(VM* vm)
@@ -168,7 +167,7 @@ ObjectType* Tuple_NewType(VM* vm)
     type->ToString = tuple_to_string;
     type->Print = tuple_print;
     type->Hash = Object_GenericHash;
-    type->GetField = Object_GenericGetField;
+    type->GetField = NULL;
     type->SetField = NULL;
     type->GetSubscript = tuple_get_subscript;
     type->SetSubscript = tuple_set_subscript;
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 
 #include "object.h"
 #include "obj_function.h"
@@ -14,9 +15,7 @@
 
 Object* Object_Allocate(VM* vm, size_t size)
 {
-    Object* object = (Object*)Mem_Allocate(&vm->gc, size);
-    object->marked = false;
-    Table_Init(&object->fields);
+    Object* object = (Object*)GC_AllocateObject(&vm->gc, size);
 
     GC_AppendObject(&vm->gc, object);
 
@@ -29,8 +28,11 @@ Object* Object_Allocate(VM* vm, size_t size)
 
 void Object_Deallocate(GC* gc, Object* object)
 {
-    Table_Free(gc, &object->fields);
-    Mem_Deallocate(gc, object, object->type->size);
+    if (OBJ_HAS_FIELDS(object)) {
+        Table_Free(gc, &AS_INSTANCE(object)->fields);
+    }
+
+    GC_DeallocateObject(gc, object, object->type->size);
 }
 
 Object* Object_New(VM* vm, ObjectType* type)
@@ -38,6 +40,13 @@ Object* Object_New(VM* vm, ObjectType* type)
     Vm_PushTemporary(vm, OBJ_VAL(type));
     Object* object = Object_Allocate(vm, type->size);
     object->type = type;
+
+    //Instances of built-in types are only set up by their initializers, but must be safe to free before that
+    memset((char*)object + sizeof(Object), 0, type->size - sizeof(Object));
+    if (type->flags & TF_HAS_FIELDS) {
+        Table_Init(&AS_INSTANCE(object)->fields);
+    }
+
     Vm_PopTemporary(vm);
     return object;
 }
@@ -80,7 +89,9 @@ bool Object_GetField(Object* object, Value key, VM* vm, Value* result)
 
 bool Object_SetField(Object* object, Value key, Value value, VM* vm)
 {
-    return object->type->SetField(object, key, value, vm);
+    bool result = object->type->SetField(object, key, value, vm);
+    GC_WRITE_BARRIER(&vm->gc, object);
+    return result;
 }
 
 bool Object_GetSubscript(Object* object, Value index, VM* vm, Value* result)
@@ -90,7 +101,9 @@ bool Object_GetSubscript(Object* object, Value index, VM* vm, Value* result)
 
 bool Object_SetSubscript(Object* object, Value index, Value value, VM* vm)
 {
-    return object->type->SetSubscript(object, index, value, vm);
+    bool result = object->type->SetSubscript(object, index, value, vm);
+    GC_WRITE_BARRIER(&vm->gc, object);
+    return result;
 }
 
 bool Object_GetMethod(Object* object, Value key, VM* vm, Value* result)
@@ -110,12 +123,16 @@ bool Object_GetMethodDirectly(Object* object, Value key, VM* vm, Value* result)
 
 bool Object_SetMethod(Object* object, Value key, Value value, VM* vm)
 {
-    return object->type->SetMethod(object->type, key, value, vm);
+    bool result = object->type->SetMethod(object->type, key, value, vm);
+    GC_WRITE_BARRIER(&vm->gc, object->type);
+    return result;
 }
 
 bool Object_SetMethodDirectly(Object* object, Value key, Value value, VM* vm)
 {
-    return AS_TYPE(object)->SetMethod(AS_TYPE(object), key, value, vm);
+    bool result = AS_TYPE(object)->SetMethod(AS_TYPE(object), key, value, vm);
+    GC_WRITE_BARRIER(&vm->gc, object);
+    return result;
 }
 
 ObjectIterator* Object_MakeIterator(Object* object, VM* vm)
@@ -151,12 +168,12 @@ uint32_t Object_GenericHash(Object* object)
 
 bool Object_GenericGetField(Object* object, Value key, VM* vm, Value* result)
 {
-    return Table_Get(&object->fields, key, result);
+    return Table_Get(&AS_INSTANCE(object)->fields, key, result);
 }
 
 bool Object_GenericSetField(Object* object, Value key, Value value, VM* vm)
 {
-    return Table_Put(vm, &object->fields, key, value);
+    return Table_Put(vm, &AS_INSTANCE(object)->fields, key, value);
 }
 
 bool Object_GenericGetMethod(ObjectType* type, Value key, VM* vm, Value* result)
@@ -171,7 +188,10 @@ bool Object_GenericSetMethod(ObjectType* type, Value key, Value value, VM* vm)
 
 void Object_GenericTraverse(Object* object, GC* gc)
 {
-    GC_MarkTable(gc, &object->fields);
+    if (OBJ_HAS_FIELDS(object)) {
+        GC_MarkTable(gc, &AS_INSTANCE(object)->fields);
+    }
+
     GC_MarkObject(gc, (Object*)object->type);
 }
 
@@ -183,6 +203,7 @@ void Object_GenericFree(Object* object, GC* gc)
 ObjectType* Type_Allocate(VM* vm)
 {
     ObjectType* type = (ObjectType*)Object_Allocate(vm, sizeof(ObjectType));
+    Table_Init(&type->fields);
     Table_Init(&type->methods);
     return type;
 }
@@ -228,7 +249,7 @@ static ObjectType* new_meta_type(VM* vm)
     ObjectType* meta = Type_Allocate(vm);
     meta->name = "MetaType";
     meta->size = sizeof(ObjectType);
-    meta->flags = 0x0,
+    meta->flags = TF_HAS_FIELDS,
     meta->ToString = type_to_string;
     meta->Print = type_print;
     meta->Hash = Object_GenericHash;
@@ -279,7 +300,7 @@ ObjectType* Type_NewClass(VM* vm, const char* name)
 {
     ObjectType* type = Type_New(vm);
     type->name = name;
-    type->size = sizeof(Object);
+    type->size = sizeof(ObjectInstance);
     type->flags = TF_DEFAULT,
     type->ToString = instance_to_string;
     type->Print = instance_print;
@@ -20,11 +20,18 @@ typedef struct ObjectType ObjectType;
 
 typedef struct Object {
     ObjectType* type;
-    Table fields;
-    struct Object* next;
-    bool marked;
+
+    //Bits kept for the garbage collector, packed into what would otherwise be padding
+    bool old : 1;
+    bool remembered : 1;
 } Object;
 
+//Only objects of types flagged with TF_HAS_FIELDS have fields, and they keep them right after the header
+typedef struct ObjectInstance {
+    Object base;
+    Table fields;
+} ObjectInstance;
+
 Object* Object_Allocate(VM* vm, size_t size);
 void Object_Deallocate(GC* gc, Object* object);
 
@@ -59,6 +66,9 @@ bool Object_GenericSetMethod(ObjectType* type, Value key, Value value, VM* vm);
 void Object_GenericTraverse(Object* object, GC* gc);
 void Object_GenericFree(Object* object, GC* gc);
 
+#define AS_INSTANCE(object) ((ObjectInstance*)object)
+#define OBJ_HAS_FIELDS(object) (((object)->type->flags & TF_HAS_FIELDS) != 0)
+
 #define AS_TYPE(object) ((ObjectType*)object)
 #define IS_TYPE(object) (Object_IsType(object))
 
@@ -67,7 +77,8 @@ void Object_GenericFree(Object* object, GC* gc);
 
 typedef enum {
     TF_ALLOW_INHERITANCE = 0x1,
-    TF_DEFAULT = TF_ALLOW_INHERITANCE
+    TF_HAS_FIELDS = 0x2,
+    TF_DEFAULT = TF_ALLOW_INHERITANCE | TF_HAS_FIELDS
 } TypeFlag;
 
 typedef ObjectString* (*ToStringFn)(Object* object, VM* vm);
@@ -86,6 +97,7 @@ typedef void (*FreeFn)(Object* object, GC* gc);
 
 typedef struct ObjectType {
     Object base;
+    Table fields;
     const char* name;
     size_t size;
     uint16_t flags;
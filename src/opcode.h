@@ -19,6 +19,7 @@ typedef enum {
 
     /* Control Flow */
     OP_JUMP, OP_JUMP_IF_FALSE, OP_POP_JUMP_IF_FALSE, OP_POP_JUMP_IF_EQUAL, OP_JUMP_IF_NOT_NIL, OP_LOOP, OP_POP_LOOP_IF_TRUE,
+    OP_JUMP_TABLE, OP_JUMP_HASH,
 
     /* Globals */
     OP_DEFINE_GLOBAL, OP_LOAD_GLOBAL, OP_STORE_GLOBAL,
@@ -27,7 +28,7 @@ typedef enum {
     OP_LOAD_LOCAL, OP_STORE_LOCAL,
 
     /* Functions */
-    OP_CALL, OP_RETURN, OP_CLOSURE, OP_CLOSE_UPVALUE, OP_LOAD_UPVALUE, OP_STORE_UPVALUE,
+    OP_CALL, OP_RETURN, OP_RETURN_TUPLE, OP_CLOSURE, OP_CLOSE_UPVALUE, OP_LOAD_UPVALUE, OP_STORE_UPVALUE, OP_LOAD_CAPTURE,
     OP_COROUTINE, OP_YIELD,
 
     /* Classes */
@@ -39,16 +40,32 @@ typedef enum {
     OP_LIST, OP_MAP, OP_TUPLE, OP_TUPLE_UNPACK,
 
     /* Iterators */
-    OP_ITERATOR, OP_FOR_ITERATOR,
+    OP_ITERATOR, OP_FOR_ITERATOR, OP_RANGE_COUNTER, OP_FOR_RANGE,
 
     /* Stack */
     OP_POP, OP_DUP, OP_DUP_TWO, OP_SWAP, OP_SWAP_THREE, OP_SWAP_FOUR,
 
     /* Modules */
-    OP_IMPORT_MODULE, OP_IMPORT_ALL, OP_SAVE_MODULE, OP_IMPORT_BY_NAME,
+    OP_IMPORT_MODULE, OP_IMPORT_LAZY, OP_IMPORT_ALL, OP_SAVE_MODULE, OP_IMPORT_BY_NAME,
     
     /* Miscellaneous */
-    OP_PRINT, OP_BUILD_STRING, OP_RANGE
+    OP_PRINT, OP_BUILD_STRING, OP_RANGE,
+
+    /* Numbers */
+    OP_CHECK_NUMBER, OP_CHECK_NUMBER_LOCAL, OP_GREATER_NUMBER, OP_GREATER_EQUAL_NUMBER, OP_LESS_NUMBER,
+    OP_LESS_EQUAL_NUMBER, OP_NEGATE_NUMBER, OP_INC_NUMBER, OP_DEC_NUMBER, OP_ADD_NUMBER, OP_SUBTRACT_NUMBER,
+    OP_MULTIPLY_NUMBER, OP_DIVIDE_NUMBER,
+
+    /* Profiling */
+    OP_PROFILE_CALL, OP_PROFILE_BRANCH, OP_PROFILE_OPERANDS,
+
+    /* Long Operands */
+    OP_LOAD_CONSTANT_LONG, OP_DEFINE_GLOBAL_LONG, OP_LOAD_GLOBAL_LONG, OP_STORE_GLOBAL_LONG, OP_CLOSURE_LONG,
+    OP_CLASS_LONG, OP_LOAD_PROPERTY_LONG, OP_LOAD_PROPERTY_SAFE_LONG, OP_STORE_PROPERTY_LONG, OP_STORE_PROPERTY_SAFE_LONG,
+    OP_METHOD_LONG, OP_STATIC_METHOD_LONG, OP_INVOKE_LONG, OP_INVOKE_SAFE_LONG, OP_GET_SUPER_LONG, OP_SUPER_INVOKE_LONG,
+    OP_IMPORT_BY_NAME_LONG
 } OpCode;
 
+#define OP_IS_LONG(instruction) ((instruction) >= OP_LOAD_CONSTANT_LONG)
+
 #endif
@@ -0,0 +1,704 @@
+#include <string.h>
+
+#include "optimizer.h"
+#include "object.h"
+#include "obj_function.h"
+
+#define MAX_OPTIMIZER_PASSES 4
+#define MAX_THREADING_DEPTH 16
+
+typedef enum {
+    MATCH_LOAD,
+    MATCH_POP,
+    MATCH_DUP,
+    MATCH_INC_DEC,
+    MATCH_STORE_VARIABLE,
+    MATCH_STORE_PROPERTY,
+    MATCH_STORE_SUBSCRIPT,
+    MATCH_SWAP,
+    MATCH_SWAP_THREE,
+    MATCH_SWAP_FOUR
+} MatchClass;
+
+typedef struct {
+    int length;
+    MatchClass classes[7];
+    uint8_t removed;
+} Pattern;
+
+static const Pattern patterns[] = {
+    //Values that are loaded only to be discarded
+    { 2, { MATCH_LOAD, MATCH_POP }, 0x03 },
+    { 2, { MATCH_DUP, MATCH_POP }, 0x03 },
+
+    //Postfix increments and decrements whose result is discarded do not need to keep the old value around
+    { 5, { MATCH_DUP, MATCH_INC_DEC, MATCH_STORE_VARIABLE, MATCH_POP, MATCH_POP }, 0x11 },
+    { 7, { MATCH_DUP, MATCH_SWAP_THREE, MATCH_INC_DEC, MATCH_SWAP, MATCH_STORE_PROPERTY, MATCH_POP, MATCH_POP }, 0x43 },
+    { 7, { MATCH_DUP, MATCH_SWAP_FOUR, MATCH_INC_DEC, MATCH_SWAP_THREE, MATCH_STORE_SUBSCRIPT, MATCH_POP, MATCH_POP }, 0x43 },
+};
+
+typedef struct Optimizer {
+    Chunk* chunk;
+    ChunkLayout* layout;
+
+    //Indexed by the offset at which an instruction begins
+    uint32_t* lengths;
+    bool* removed;
+    bool* targets;
+} Optimizer;
+
+static uint16_t read_short(uint8_t* code)
+{
+    return (uint16_t)(code[0] << 0) | (uint16_t)(code[1] << 8);
+}
+
+static void write_short(uint8_t* code, uint16_t value)
+{
+    code[0] = (value >> 0) & 0xFF;
+    code[1] = (value >> 8) & 0xFF;
+}
+
+static uint32_t instruction_length(Chunk* chunk, uint32_t offset)
+{
+    uint8_t instruction = chunk->code[offset];
+    uint32_t width = OP_IS_LONG(instruction) ? 2 : 1;
+
+    switch (instruction) {
+        case OP_LOAD_LOCAL:
+        case OP_STORE_LOCAL:
+        case OP_LOAD_UPVALUE:
+        case OP_STORE_UPVALUE:
+        case OP_LOAD_CAPTURE:
+        case OP_CALL:
+        case OP_RETURN_TUPLE:
+        case OP_LIST:
+        case OP_MAP:
+        case OP_TUPLE:
+        case OP_TUPLE_UNPACK:
+        case OP_BUILD_STRING:
+        case OP_CHECK_NUMBER_LOCAL:
+            return 2;
+        case OP_LOAD_CONSTANT:
+        case OP_DEFINE_GLOBAL:
+        case OP_LOAD_GLOBAL:
+        case OP_STORE_GLOBAL:
+        case OP_CLASS:
+        case OP_LOAD_PROPERTY:
+        case OP_LOAD_PROPERTY_SAFE:
+        case OP_STORE_PROPERTY:
+        case OP_STORE_PROPERTY_SAFE:
+        case OP_METHOD:
+        case OP_STATIC_METHOD:
+        case OP_GET_SUPER:
+        case OP_IMPORT_BY_NAME:
+        case OP_LOAD_CONSTANT_LONG:
+        case OP_DEFINE_GLOBAL_LONG:
+        case OP_LOAD_GLOBAL_LONG:
+        case OP_STORE_GLOBAL_LONG:
+        case OP_CLASS_LONG:
+        case OP_LOAD_PROPERTY_LONG:
+        case OP_LOAD_PROPERTY_SAFE_LONG:
+        case OP_STORE_PROPERTY_LONG:
+        case OP_STORE_PROPERTY_SAFE_LONG:
+        case OP_METHOD_LONG:
+        case OP_STATIC_METHOD_LONG:
+        case OP_GET_SUPER_LONG:
+        case OP_IMPORT_BY_NAME_LONG:
+            return 1 + width;
+        case OP_INVOKE:
+        case OP_INVOKE_SAFE:
+        case OP_SUPER_INVOKE:
+        case OP_INVOKE_LONG:
+        case OP_INVOKE_SAFE_LONG:
+        case OP_SUPER_INVOKE_LONG:
+            return 2 + width;
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_POP_JUMP_IF_FALSE:
+        case OP_POP_JUMP_IF_EQUAL:
+        case OP_JUMP_IF_NOT_NIL:
+        case OP_LOOP:
+        case OP_POP_LOOP_IF_TRUE:
+        case OP_FOR_ITERATOR:
+        case OP_FOR_RANGE:
+            return 3;
+        case OP_PROFILE_CALL:
+        case OP_PROFILE_BRANCH:
+        case OP_PROFILE_OPERANDS:
+            return 3;
+        case OP_JUMP_TABLE:
+        case OP_JUMP_HASH:
+            return 7 + read_short(&chunk->code[offset + 3]) * 2;
+        case OP_CLOSURE:
+        case OP_CLOSURE_LONG: {
+            uint16_t constant = width == 2 ? read_short(&chunk->code[offset + 1]) : chunk->code[offset + 1];
+            ObjectFunction* function = VAL_AS_FUNCTION(chunk->constants.data[constant]);
+            return 1 + width + (function->upvalueCount + function->captureCount) * 2;
+        }
+        default:
+            return 1;
+    }
+}
+
+static bool is_backward_jump(uint8_t instruction)
+{
+    return instruction == OP_LOOP || instruction == OP_POP_LOOP_IF_TRUE;
+}
+
+static bool is_jump(uint8_t instruction)
+{
+    switch (instruction) {
+        case OP_JUMP:
+        case OP_JUMP_IF_FALSE:
+        case OP_POP_JUMP_IF_FALSE:
+        case OP_POP_JUMP_IF_EQUAL:
+        case OP_JUMP_IF_NOT_NIL:
+        case OP_LOOP:
+        case OP_POP_LOOP_IF_TRUE:
+        case OP_FOR_ITERATOR:
+        case OP_FOR_RANGE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_dispatch(uint8_t instruction)
+{
+    return instruction == OP_JUMP_TABLE || instruction == OP_JUMP_HASH;
+}
+
+static bool is_terminator(uint8_t instruction)
+{
+    switch (instruction) {
+        case OP_JUMP:
+        case OP_LOOP:
+        case OP_RETURN:
+        case OP_RETURN_TUPLE:
+        case OP_JUMP_TABLE:
+        case OP_JUMP_HASH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static uint32_t jump_target(uint8_t* code, uint32_t offset)
+{
+    uint16_t distance = read_short(&code[offset + 1]);
+    return is_backward_jump(code[offset]) ? offset + 3 - distance : offset + 3 + distance;
+}
+
+static bool encode_jump(uint8_t* code, uint32_t offset, uint8_t instruction, uint32_t target)
+{
+    uint32_t end = offset + 3;
+
+    //Unconditional jumps may change direction when threaded
+    if (instruction == OP_JUMP || instruction == OP_LOOP) {
+        instruction = target >= end ? OP_JUMP : OP_LOOP;
+    }
+
+    uint32_t distance;
+    if (is_backward_jump(instruction)) {
+        if (target > end) {
+            return false;
+        }
+        distance = end - target;
+    } else {
+        if (target < end) {
+            return false;
+        }
+        distance = target - end;
+    }
+
+    if (distance > UINT16_MAX) {
+        return false;
+    }
+
+    code[offset] = instruction;
+    write_short(&code[offset + 1], (uint16_t)distance);
+    return true;
+}
+
+static uint32_t dispatch_base(uint8_t* code, uint32_t offset)
+{
+    return offset + 7 + read_short(&code[offset + 3]) * 2;
+}
+
+static uint32_t skip_removed(Optimizer* optimizer, uint32_t offset)
+{
+    while (offset < optimizer->chunk->count && optimizer->removed[offset]) {
+        offset += optimizer->lengths[offset];
+    }
+
+    return offset;
+}
+
+static uint32_t next_instruction(Optimizer* optimizer, uint32_t offset)
+{
+    return skip_removed(optimizer, offset + optimizer->lengths[offset]);
+}
+
+#define FOR_EACH_INSTRUCTION(optimizer, offset)                                                     \
+    for (uint32_t offset = skip_removed(optimizer, 0);                                              \
+         offset < (optimizer)->chunk->count;                                                        \
+         offset = next_instruction(optimizer, offset))                                              \
+
+static void mark_targets(Optimizer* optimizer)
+{
+    uint8_t* code = optimizer->chunk->code;
+    memset(optimizer->targets, 0, optimizer->chunk->count + 1);
+
+    if (optimizer->layout->entry) {
+        optimizer->targets[skip_removed(optimizer, (uint32_t)*optimizer->layout->entry)] = true;
+    }
+
+    FOR_EACH_INSTRUCTION(optimizer, offset) {
+        if (is_jump(code[offset])) {
+            optimizer->targets[skip_removed(optimizer, jump_target(code, offset))] = true;
+        } else if (is_dispatch(code[offset])) {
+            uint32_t base = dispatch_base(code, offset);
+            optimizer->targets[skip_removed(optimizer, base + read_short(&code[offset + 5]))] = true;
+
+            for (uint32_t entry = offset + 7; entry < base; entry += 2) {
+                optimizer->targets[skip_removed(optimizer, base + read_short(&code[entry]))] = true;
+            }
+        }
+    }
+}
+
+static bool thread_jumps(Optimizer* optimizer)
+{
+    Chunk* chunk = optimizer->chunk;
+    uint8_t* code = chunk->code;
+    bool changed = false;
+
+    FOR_EACH_INSTRUCTION(optimizer, offset) {
+        uint8_t instruction = code[offset];
+        if (!is_jump(instruction)) {
+            continue;
+        }
+
+        uint32_t original = jump_target(code, offset);
+        uint32_t target = skip_removed(optimizer, original);
+
+        for (int depth = 0; depth < MAX_THREADING_DEPTH && target < chunk->count; depth++) {
+            uint8_t next = code[target];
+
+            if (next == OP_JUMP || next == OP_LOOP) {
+                target = skip_removed(optimizer, jump_target(code, target));
+            } else if (instruction == OP_JUMP_IF_FALSE && next == OP_JUMP_IF_FALSE) {
+                //The value that failed the first test is still on the stack and fails the second one too
+                target = skip_removed(optimizer, jump_target(code, target));
+            } else {
+                break;
+            }
+        }
+
+        if (target != original || instruction != code[offset]) {
+            changed |= encode_jump(code, offset, instruction, target);
+        }
+    }
+
+    return changed;
+}
+
+static bool fuse_conditional_pops(Optimizer* optimizer)
+{
+    Chunk* chunk = optimizer->chunk;
+    uint8_t* code = chunk->code;
+    bool changed = false;
+
+    //Both outcomes of a test that is followed by a pop on either path can pop as part of the jump
+    FOR_EACH_INSTRUCTION(optimizer, offset) {
+        if (code[offset] != OP_JUMP_IF_FALSE) {
+            continue;
+        }
+
+        uint32_t next = next_instruction(optimizer, offset);
+        uint32_t target = skip_removed(optimizer, jump_target(code, offset));
+
+        if (next >= chunk->count || code[next] != OP_POP || optimizer->targets[next]) {
+            continue;
+        }
+
+        if (target >= chunk->count) {
+            continue;
+        }
+
+        //A falsey value is either popped at the target or popped and tested again, which it fails
+        if (code[target] == OP_POP) {
+            target = next_instruction(optimizer, target);
+        } else if (code[target] == OP_POP_JUMP_IF_FALSE) {
+            target = skip_removed(optimizer, jump_target(code, target));
+        } else {
+            continue;
+        }
+
+        if (encode_jump(code, offset, OP_POP_JUMP_IF_FALSE, target)) {
+            optimizer->removed[next] = true;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+static bool matches(uint8_t instruction, MatchClass class)
+{
+    switch (class) {
+        case MATCH_LOAD:
+            return instruction == OP_LOAD_CONSTANT || instruction == OP_LOAD_CONSTANT_LONG ||
+                   instruction == OP_LOAD_TRUE || instruction == OP_LOAD_FALSE || instruction == OP_LOAD_NIL ||
+                   instruction == OP_LOAD_LOCAL || instruction == OP_LOAD_UPVALUE || instruction == OP_LOAD_CAPTURE;
+        case MATCH_POP:
+            return instruction == OP_POP;
+        case MATCH_DUP:
+            return instruction == OP_DUP;
+        case MATCH_INC_DEC:
+            return instruction == OP_INC || instruction == OP_DEC ||
+                   instruction == OP_INC_NUMBER || instruction == OP_DEC_NUMBER;
+        case MATCH_STORE_VARIABLE:
+            return instruction == OP_STORE_LOCAL || instruction == OP_STORE_UPVALUE ||
+                   instruction == OP_STORE_GLOBAL || instruction == OP_STORE_GLOBAL_LONG;
+        case MATCH_STORE_PROPERTY:
+            return instruction == OP_STORE_PROPERTY || instruction == OP_STORE_PROPERTY_LONG;
+        case MATCH_STORE_SUBSCRIPT:
+            return instruction == OP_STORE_SUBSCRIPT;
+        case MATCH_SWAP:
+            return instruction == OP_SWAP;
+        case MATCH_SWAP_THREE:
+            return instruction == OP_SWAP_THREE;
+        case MATCH_SWAP_FOUR:
+            return instruction == OP_SWAP_FOUR;
+    }
+
+    return false;
+}
+
+static bool match_pattern(Optimizer* optimizer, uint32_t offset, const Pattern* pattern, uint32_t* offsets)
+{
+    for (int i = 0; i < pattern->length; i++) {
+        //Only the first instruction of a sequence may be entered from elsewhere
+        if (offset >= optimizer->chunk->count || (i > 0 && optimizer->targets[offset])) {
+            return false;
+        }
+
+        if (!matches(optimizer->chunk->code[offset], pattern->classes[i])) {
+            return false;
+        }
+
+        offsets[i] = offset;
+        offset = next_instruction(optimizer, offset);
+    }
+
+    return true;
+}
+
+static bool apply_patterns(Optimizer* optimizer)
+{
+    bool changed = false;
+    uint32_t offsets[7];
+
+    FOR_EACH_INSTRUCTION(optimizer, offset) {
+        for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+            const Pattern* pattern = &patterns[i];
+            if (!match_pattern(optimizer, offset, pattern, offsets)) {
+                continue;
+            }
+
+            for (int j = 0; j < pattern->length; j++) {
+                if (pattern->removed & (1 << j)) {
+                    optimizer->removed[offsets[j]] = true;
+                }
+            }
+
+            changed = true;
+            break;
+        }
+    }
+
+    return changed;
+}
+
+static bool remove_unreachable_code(Optimizer* optimizer)
+{
+    Chunk* chunk = optimizer->chunk;
+    uint8_t* code = chunk->code;
+    bool changed = false;
+
+    FOR_EACH_INSTRUCTION(optimizer, offset) {
+        if (code[offset] == OP_JUMP && skip_removed(optimizer, jump_target(code, offset)) == next_instruction(optimizer, offset)) {
+            optimizer->removed[offset] = true;
+            changed = true;
+            continue;
+        }
+
+        if (!is_terminator(code[offset])) {
+            continue;
+        }
+
+        uint32_t next = next_instruction(optimizer, offset);
+        while (next < chunk->count && !optimizer->targets[next]) {
+            optimizer->removed[next] = true;
+            changed = true;
+            next = next_instruction(optimizer, next);
+        }
+    }
+
+    return changed;
+}
+
+static void relocate_dispatch(uint8_t* code, uint32_t offset, uint32_t position, uint32_t length, uint32_t* offsets)
+{
+    //The entries are relative to the end of the instruction, which moves along with it
+    uint32_t oldBase = offset + length;
+    uint32_t newBase = position + length;
+
+    for (uint32_t entry = position + 5; entry < newBase; entry += 2) {
+        write_short(&code[entry], (uint16_t)(offsets[oldBase + read_short(&code[entry])] - newBase));
+    }
+}
+
+static void append_line(LineArray* lines, int line)
+{
+    if (lines->count > 0 && lines->data[lines->count - 1].number == line) {
+        lines->data[lines->count - 1].count++;
+        return;
+    }
+
+    lines->data[lines->count++] = (Line) { .number = line, .count = 1 };
+}
+
+static int* expand_lines(Arena* arena, Chunk* chunk)
+{
+    int* lines = ARENA_ALLOCATE(arena, int, chunk->count);
+
+    uint32_t byte = 0;
+    for (size_t i = 0; i < chunk->lines.count; i++) {
+        for (int j = 0; j < chunk->lines.data[i].count; j++) {
+            lines[byte++] = chunk->lines.data[i].number;
+        }
+    }
+
+    return lines;
+}
+
+static void rewrite_chunk(Optimizer* optimizer, Arena* arena)
+{
+    Chunk* chunk = optimizer->chunk;
+    uint8_t* code = chunk->code;
+    uint32_t count = (uint32_t)chunk->count;
+
+    uint32_t* offsets = ARENA_ALLOCATE(arena, uint32_t, count + 1);
+    int* lines = expand_lines(arena, chunk);
+
+    uint32_t position = 0;
+    for (uint32_t offset = 0; offset < count; offset += optimizer->lengths[offset]) {
+        offsets[offset] = position;
+        if (!optimizer->removed[offset]) {
+            position += optimizer->lengths[offset];
+        }
+    }
+    offsets[count] = position;
+
+    //Instructions only ever move towards the start, so the chunk can be compacted in place
+    chunk->lines.count = 0;
+    for (uint32_t offset = 0; offset < count; offset += optimizer->lengths[offset]) {
+        if (optimizer->removed[offset]) {
+            continue;
+        }
+
+        uint8_t instruction = code[offset];
+        uint32_t length = optimizer->lengths[offset];
+        uint32_t position = offsets[offset];
+
+        if (is_jump(instruction)) {
+            uint32_t target = jump_target(code, offset);
+            memmove(&code[position], &code[offset], length);
+            encode_jump(code, position, instruction, offsets[target]);
+        } else if (is_dispatch(instruction)) {
+            memmove(&code[position], &code[offset], length);
+            relocate_dispatch(code, offset, position, length, offsets);
+        } else {
+            memmove(&code[position], &code[offset], length);
+        }
+
+        for (uint32_t i = 0; i < length; i++) {
+            append_line(&chunk->lines, lines[offset + i]);
+        }
+    }
+
+    chunk->count = offsets[count];
+
+    if (optimizer->layout->entry) {
+        *optimizer->layout->entry = offsets[*optimizer->layout->entry];
+    }
+}
+
+static size_t select_cold_blocks(Arena* arena, ChunkLayout* layout, uint32_t count, ColdBlock*** result)
+{
+    ColdBlock** selected = ARENA_ALLOCATE(arena, ColdBlock*, layout->coldBlockCount);
+    size_t selectedCount = 0;
+
+    //Blocks are listed in the order in which they were finished, so a block comes after any that it contains
+    for (size_t j = layout->coldBlockCount; j > 0; j--) {
+        ColdBlock* block = &layout->coldBlocks[j - 1];
+        bool overlaps = block->start >= block->end || block->end >= count;
+        for (size_t i = 0; i < selectedCount && !overlaps; i++) {
+            overlaps = block->start < selected[i]->end && selected[i]->start < block->end;
+        }
+
+        if (overlaps) {
+            continue;
+        }
+
+        //Blocks stay in the order in which they appear
+        size_t i = selectedCount++;
+        while (i > 0 && selected[i - 1]->start > block->start) {
+            selected[i] = selected[i - 1];
+            i--;
+        }
+        selected[i] = block;
+    }
+
+    *result = selected;
+    return selectedCount;
+}
+
+static void sink_cold_blocks(VM* vm, Arena* arena, Chunk* chunk, ChunkLayout* layout)
+{
+    uint8_t* code = chunk->code;
+    uint32_t count = (uint32_t)chunk->count;
+
+    ColdBlock** blocks;
+    size_t blockCount = select_cold_blocks(arena, layout, count, &blocks);
+    if (blockCount == 0) {
+        return;
+    }
+
+    uint32_t* lengths = ARENA_ALLOCATE(arena, uint32_t, count);
+    bool* moved = ARENA_ALLOCATE(arena, bool, count);
+    memset(moved, 0, sizeof(bool) * count);
+
+    for (uint32_t offset = 0; offset < count; offset += lengths[offset]) {
+        lengths[offset] = instruction_length(chunk, offset);
+    }
+
+    for (size_t i = 0; i < blockCount; i++) {
+        for (uint32_t offset = (uint32_t)blocks[i]->start; offset < blocks[i]->end; offset += lengths[offset]) {
+            moved[offset] = true;
+        }
+    }
+
+    //The rest of the chunk keeps its order, and each block follows it with a jump back to where it ended
+    uint32_t* offsets = ARENA_ALLOCATE(arena, uint32_t, count + 1);
+    uint32_t* returns = ARENA_ALLOCATE(arena, uint32_t, blockCount);
+    uint32_t position = 0;
+
+    for (uint32_t offset = 0; offset < count; offset += lengths[offset]) {
+        if (!moved[offset]) {
+            offsets[offset] = position;
+            position += lengths[offset];
+        }
+    }
+
+    for (size_t i = 0; i < blockCount; i++) {
+        for (uint32_t offset = (uint32_t)blocks[i]->start; offset < blocks[i]->end; offset += lengths[offset]) {
+            offsets[offset] = position;
+            position += lengths[offset];
+        }
+
+        returns[i] = position;
+        position += 3;
+    }
+
+    offsets[count] = position;
+
+    int* lines = expand_lines(arena, chunk);
+    uint8_t* sunk = ARENA_ALLOCATE(arena, uint8_t, position);
+    int* sunkLines = ARENA_ALLOCATE(arena, int, position);
+
+    for (uint32_t offset = 0; offset < count; offset += lengths[offset]) {
+        uint8_t instruction = code[offset];
+        uint32_t length = lengths[offset];
+        uint32_t target = offsets[offset];
+
+        memcpy(&sunk[target], &code[offset], length);
+        memcpy(&sunkLines[target], &lines[offset], sizeof(int) * length);
+
+        //A conditional jump that would have to change direction leaves the chunk as it was
+        if (is_jump(instruction) && !encode_jump(sunk, target, instruction, offsets[jump_target(code, offset)])) {
+            return;
+        } else if (is_dispatch(instruction)) {
+            relocate_dispatch(sunk, offset, target, length, offsets);
+        }
+    }
+
+    for (size_t i = 0; i < blockCount; i++) {
+        if (!encode_jump(sunk, returns[i], OP_JUMP, offsets[blocks[i]->end])) {
+            return;
+        }
+
+        int line = lines[blocks[i]->end - 1];
+        sunkLines[returns[i]] = sunkLines[returns[i] + 1] = sunkLines[returns[i] + 2] = line;
+    }
+
+    if (layout->entry) {
+        *layout->entry = offsets[*layout->entry];
+    }
+
+    chunk->count = 0;
+    chunk->lines.count = 0;
+    for (uint32_t i = 0; i < position; i++) {
+        Chunk_Write(vm, chunk, sunk[i], sunkLines[i]);
+    }
+}
+
+void Optimizer_OptimizeChunk(VM* vm, Arena* arena, Chunk* chunk, ChunkLayout* layout)
+{
+    if (chunk->count == 0) {
+        return;
+    }
+
+    ArenaMark mark = Arena_Mark(arena);
+
+    if (layout->coldBlockCount > 0) {
+        sink_cold_blocks(vm, arena, chunk, layout);
+    }
+
+    Optimizer optimizer;
+    optimizer.chunk = chunk;
+    optimizer.layout = layout;
+    optimizer.lengths = ARENA_ALLOCATE(arena, uint32_t, chunk->count);
+    optimizer.removed = ARENA_ALLOCATE(arena, bool, chunk->count + 1);
+    optimizer.targets = ARENA_ALLOCATE(arena, bool, chunk->count + 1);
+    memset(optimizer.removed, 0, chunk->count + 1);
+
+    for (uint32_t offset = 0; offset < chunk->count; offset += optimizer.lengths[offset]) {
+        optimizer.lengths[offset] = instruction_length(chunk, offset);
+    }
+
+    for (int pass = 0; pass < MAX_OPTIMIZER_PASSES; pass++) {
+        bool changed = false;
+
+        mark_targets(&optimizer);
+        changed |= thread_jumps(&optimizer);
+
+        mark_targets(&optimizer);
+        changed |= fuse_conditional_pops(&optimizer);
+
+        mark_targets(&optimizer);
+        changed |= apply_patterns(&optimizer);
+
+        mark_targets(&optimizer);
+        changed |= remove_unreachable_code(&optimizer);
+
+        if (!changed) {
+            break;
+        }
+    }
+
+    rewrite_chunk(&optimizer, arena);
+    Arena_Release(arena, mark);
+}
@@ -0,0 +1,23 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "chunk.h"
+#include "arena.h"
+
+//A block of code that a profile found to be rarely run, from its first instruction up to where it rejoins the code
+//after it. Such blocks are moved behind the rest of the chunk, so that the code around them runs without a jump.
+typedef struct ColdBlock {
+    size_t start;
+    size_t end;
+} ColdBlock;
+
+typedef struct ChunkLayout {
+    //Offset of a second entry point into the chunk, which is kept up to date as the code moves, if there is one
+    size_t* entry;
+    ColdBlock* coldBlocks;
+    size_t coldBlockCount;
+} ChunkLayout;
+
+void Optimizer_OptimizeChunk(VM* vm, Arena* arena, Chunk* chunk, ChunkLayout* layout);
+
+#endif
@@ -5,16 +5,6 @@
 #include "token.h"
 #include "common.h"
 
-typedef struct {
-    Scanner scanner;
-
-    Token current;
-    Token previous;
-
-    bool error;
-    bool panic;
-} Parser;
-
 typedef enum {
     PREC_NONE,
     PREC_ASSIGNMENT,
@@ -97,7 +87,8 @@ static Expression* binary_expr(Parser* parser, Expression* prefix);
 static WhenEntry* when_entry_rule(Parser* parser);
 static WhenEntryList* when_entries_rule(Parser* parser);
 static Block* block_rule(Parser* parser);
-static ParameterList* parameters_rule(Parser* parser);
+static ParameterList* parameters_rule(Parser* parser, bool annotated);
+static Token annotation_rule(Parser* parser);
 static NamedFunction* named_function_rule(Parser* parser, bool coroutine);
 static Method* method_rule(Parser* parser);
 static ArgumentList* arguments_rule(Parser* parser);
@@ -197,13 +188,6 @@ ParseRule rules[] = {
     [TOKEN_EOF]                 = { NULL,                   NULL,                     PREC_NONE,           ASSOC_NONE   },
 };
 
-static void parser_init(Parser* parser, const char* source)
-{
-    Scanner_Init(&parser->scanner, source);
-    parser->error = false;
-    parser->panic = false;
-}
-
 static void enter_error_mode(Parser* parser)
 {
     parser->error = true;
@@ -346,7 +330,7 @@ static Declaration* finish_coroutine(Parser* parser)
         return function_decl(parser, true);
     }
 
-    Declaration* coroutine = Ast_NewStatementDecl(Ast_NewExpressionStmt(coroutine_expr(parser)));
+    Declaration* coroutine = Ast_NewStatementDecl(parser->arena, Ast_NewExpressionStmt(parser->arena, coroutine_expr(parser)));
     consume(parser, TOKEN_SEMICOLON, "Expected ';' at the end of statement.");
     return coroutine;
 }
@@ -376,16 +360,16 @@ Declaration* import_decl(Parser* parser)
         Token alias = parser->previous;
 
         consume(parser, TOKEN_SEMICOLON, "Expected ';' after import.");
-        return Ast_NewImportAsDecl(moduleName, alias);
+        return Ast_NewImportAsDecl(parser->arena, moduleName, alias);
     } else if (match(parser, TOKEN_FOR)) {
-        ParameterList* names = parameters_rule(parser);
+        ParameterList* names = parameters_rule(parser, false);
 
         consume(parser, TOKEN_SEMICOLON, "Expected ';' after import.");
-        return Ast_NewImportForDecl(moduleName, names);
+        return Ast_NewImportForDecl(parser->arena, moduleName, names);
     }
 
     consume(parser, TOKEN_SEMICOLON, "Expected ';' after import.");
-    return Ast_NewImportAllDecl(moduleName);
+    return Ast_NewImportAllDecl(parser->arena, moduleName);
 }
 
 Declaration* class_decl(Parser* parser)
@@ -402,16 +386,16 @@ Declaration* class_decl(Parser* parser)
     MethodList* body = NULL;
     consume(parser, TOKEN_L_BRACE, "Expected '{' before class body in declaration.");
     while (!check(parser, TOKEN_R_BRACE) && !check(parser, TOKEN_EOF)) {
-        Ast_MethodListAppend(&body, method_rule(parser));
+        Ast_MethodListAppend(parser->arena, &body, method_rule(parser));
     }
     consume(parser, TOKEN_R_BRACE, "Expected '}' after class body in declaration.");
 
-    return Ast_NewClassDecl(identifier, superclass, body);
+    return Ast_NewClassDecl(parser->arena, identifier, superclass, body);
 }
 
 Declaration* function_decl(Parser* parser, bool coroutine)
 {
-    return Ast_NewFunctionDecl(named_function_rule(parser, coroutine));
+    return Ast_NewFunctionDecl(parser->arena, named_function_rule(parser, coroutine));
 }
 
 Declaration* variable_decl(Parser* parser)
@@ -426,18 +410,20 @@ Declaration* begin_variable_decl(Parser* parser)
         ParameterList* identifiers = NULL;
         do {
             consume(parser, TOKEN_IDENTIFIER, "Expected variable name in declaration.");
-            Ast_ParameterListAppend(&identifiers, parser->previous);
+            Token identifier = parser->previous;
+            Ast_ParameterListAppend(parser->arena, &identifiers, identifier, annotation_rule(parser));
         } while (match(parser, TOKEN_COMMA));
 
         consume(parser, TOKEN_PIPE, "Expected '|' at the end of unpacking declaration.");
 
-        VariableTarget* target = Ast_NewUnpackVariableTarget(identifiers);
-        return Ast_NewVariableDecl(target, NULL);
+        VariableTarget* target = Ast_NewUnpackVariableTarget(parser->arena, identifiers);
+        return Ast_NewVariableDecl(parser->arena, target, NULL);
     } else {
         consume(parser, TOKEN_IDENTIFIER, "Expected variable name in declaration.");
+        Token identifier = parser->previous;
 
-        VariableTarget* target = Ast_NewSingleVariableTarget(parser->previous);
-        return Ast_NewVariableDecl(target, NULL);
+        VariableTarget* target = Ast_NewSingleVariableTarget(parser->arena, identifier, annotation_rule(parser));
+        return Ast_NewVariableDecl(parser->arena, target, NULL);
     }
 
     return NULL;
@@ -455,7 +441,7 @@ Declaration* end_variable_decl(Parser* parser, Declaration* declaration)
 
 Declaration* statement_decl(Parser* parser)
 {
-    return Ast_NewStatementDecl(statement(parser));
+    return Ast_NewStatementDecl(parser->arena, statement(parser));
 }
 
 Statement* statement(Parser* parser)
@@ -477,6 +463,7 @@ Statement* statement(Parser* parser)
 
 Statement* for_stmt(Parser* parser)
 {
+    Token keyword = parser->previous;
     consume(parser, TOKEN_L_PAREN, "Expected '(' after 'for'.");
     Declaration* initializer = NULL;
     if (match(parser, TOKEN_VAR)) {
@@ -488,7 +475,7 @@ Statement* for_stmt(Parser* parser)
             initializer = end_variable_decl(parser, initializer);
         }
     } else if (!match(parser, TOKEN_SEMICOLON)) {
-        initializer = Ast_NewStatementDecl(expression_stmt(parser));
+        initializer = Ast_NewStatementDecl(parser->arena, expression_stmt(parser));
     }
 
     Expression* condition = NULL;
@@ -504,7 +491,7 @@ Statement* for_stmt(Parser* parser)
     }
 
     Statement* body = statement(parser);
-    return Ast_NewForStmt(initializer, condition, increment, body);
+    return Ast_NewForStmt(parser->arena, keyword, initializer, condition, increment, body);
 }
 
 Statement* for_in_stmt(Parser* parser, Declaration* declaration)
@@ -516,17 +503,18 @@ Statement* for_in_stmt(Parser* parser, Declaration* declaration)
     Expression* collection = expression(parser);
     consume(parser, TOKEN_R_PAREN, "Expected ')' after collection in 'for-in'.");
     Statement* body = statement(parser);
-    return Ast_NewForInStmt(declaration, collection, body);
+    return Ast_NewForInStmt(parser->arena, declaration, collection, body);
 }
 
 Statement* while_stmt(Parser* parser)
 {
+    Token keyword = parser->previous;
     consume(parser, TOKEN_L_PAREN, "Expected '(' before condition in 'while'.");
     Expression* condition = expression(parser);
     consume(parser, TOKEN_R_PAREN, "Expected ')' after condition in 'while'.");
 
     Statement* body = statement(parser);
-    return Ast_NewWhileStmt(condition, body);
+    return Ast_NewWhileStmt(parser->arena, keyword, condition, body);
 }
 
 Statement* do_while_stmt(Parser* parser)
@@ -539,19 +527,19 @@ Statement* do_while_stmt(Parser* parser)
     consume(parser, TOKEN_R_PAREN, "Expected ')' after condition in 'while'.");
     consume(parser, TOKEN_SEMICOLON, "Expected ';' after 'do-while' statement.");
 
-    return Ast_NewDoWhileStmt(body, condition);
+    return Ast_NewDoWhileStmt(parser->arena, body, condition);
 }
 
 Statement* break_stmt(Parser* parser)
 {
     consume(parser, TOKEN_SEMICOLON, "Expected ';' at the end of statement.");
-    return Ast_NewBreakStmt(parser->previous);
+    return Ast_NewBreakStmt(parser->arena, parser->previous);
 }
 
 Statement* continue_stmt(Parser* parser)
 {
     consume(parser, TOKEN_SEMICOLON, "Expected ';' at the end of statement.");
-    return Ast_NewContinueStmt(parser->previous);
+    return Ast_NewContinueStmt(parser->arena, parser->previous);
 }
 
 Statement* when_stmt(Parser* parser)
@@ -572,11 +560,12 @@ Statement* when_stmt(Parser* parser)
 
     consume(parser, TOKEN_R_BRACE, "Expected '}' after 'when' body.");
 
-    return Ast_NewWhenStmt(control, entries, elseBranch);
+    return Ast_NewWhenStmt(parser->arena, control, entries, elseBranch);
 }
 
 Statement* if_stmt(Parser* parser)
 {
+    Token keyword = parser->previous;
     consume(parser, TOKEN_L_PAREN, "Expected '(' before condition in 'if'.");
     Expression* condition = expression(parser);
     consume(parser, TOKEN_R_PAREN, "Expected ')' after condition in 'if'.");
@@ -587,7 +576,7 @@ Statement* if_stmt(Parser* parser)
         elseBranch = statement(parser);
     }
 
-    return Ast_NewIfStmt(condition, thenBranch, elseBranch);
+    return Ast_NewIfStmt(parser->arena, keyword, condition, thenBranch, elseBranch);
 }
 
 Statement* return_stmt(Parser* parser)
@@ -599,26 +588,26 @@ Statement* return_stmt(Parser* parser)
     }
 
     consume(parser, TOKEN_SEMICOLON, "Expected ';' at the end of 'return'.");
-    return Ast_NewReturnStmt(keyword, expr);
+    return Ast_NewReturnStmt(parser->arena, keyword, expr);
 }
 
 Statement* print_stmt(Parser* parser)
 {
     Expression* expr = expression(parser);
     consume(parser, TOKEN_SEMICOLON, "Expected ';' at the end of 'print'.");
-    return Ast_NewPrintStmt(expr);
+    return Ast_NewPrintStmt(parser->arena, expr);
 }
 
 Statement* block_stmt(Parser* parser)
 {
-    return Ast_NewBlockStmt(block_rule(parser));
+    return Ast_NewBlockStmt(parser->arena, block_rule(parser));
 }
 
 Statement* expression_stmt(Parser* parser)
 {
     Expression* expr = expression(parser);
     consume(parser, TOKEN_SEMICOLON, "Expected ';' at the end of statement.");
-    return Ast_NewExpressionStmt(expr);
+    return Ast_NewExpressionStmt(parser->arena, expr);
 }
 
 Expression* expression(Parser* parser)
@@ -628,7 +617,7 @@ Expression* expression(Parser* parser)
 
 Expression* literal_expr(Parser* parser)
 {
-    return Ast_NewLiteralExpr(parser->previous);
+    return Ast_NewLiteralExpr(parser->arena, parser->previous);
 }
 
 static void synchronize_interpolation(Parser* parser)
@@ -656,12 +645,12 @@ Expression* string_interp_expr(Parser* parser)
 {
     ExpressionList* values = NULL;
     if (parser->previous.length != 0) {
-        Ast_ExpressionListAppend(&values, Ast_NewLiteralExpr(parser->previous));
+        Ast_ExpressionListAppend(parser->arena, &values, Ast_NewLiteralExpr(parser->arena, parser->previous));
     }
 
     while (parser->previous.type != TOKEN_STRING_INTERP_END && !reached_end(parser)) {
         Expression* expr = expression(parser);
-        Ast_ExpressionListAppend(&values, expr);
+        Ast_ExpressionListAppend(parser->arena, &values, expr);
 
         if (expr) {
             advance(parser);
@@ -670,30 +659,30 @@ Expression* string_interp_expr(Parser* parser)
         synchronize_interpolation(parser);
 
         if (parser->previous.length != 0) {
-            Ast_ExpressionListAppend(&values, Ast_NewLiteralExpr(parser->previous));
+            Ast_ExpressionListAppend(parser->arena, &values, Ast_NewLiteralExpr(parser->arena, parser->previous));
         }
     }
 
-    return Ast_NewStringInterpExpr(values);
+    return Ast_NewStringInterpExpr(parser->arena, values);
 }
 
 Expression* lambda_expr(Parser* parser)
 {
     ParameterList* parameters = NULL;
     if (!check(parser, TOKEN_R_ARROW)) {
-        parameters = parameters_rule(parser);
+        parameters = parameters_rule(parser, true);
     }
     consume(parser, TOKEN_R_ARROW, "Expected '->' after lambda parameters.");
 
     FunctionBody* body = NULL;
     if (match(parser, TOKEN_L_BRACE)) {
-        body = Ast_NewBlockFunctionBody(block_rule(parser));
+        body = Ast_NewBlockFunctionBody(parser->arena, block_rule(parser));
     } else {
-        body = Ast_NewExpressionFunctionBody(expression(parser));
+        body = Ast_NewExpressionFunctionBody(parser->arena, expression(parser));
     }
 
-    Function* function = Ast_NewFunction(parameters, body);
-    return Ast_NewLambdaExpr(function);
+    Function* function = Ast_NewFunction(parser->arena, parameters, body);
+    return Ast_NewLambdaExpr(parser->arena, function);
 }
 
 Expression* list_expr(Parser* parser)
@@ -701,13 +690,13 @@ Expression* list_expr(Parser* parser)
     ExpressionList* elements = NULL;
     if (!check(parser, TOKEN_R_BRACKET)) {
         do {
-            Ast_ExpressionListAppend(&elements, expression(parser));
+            Ast_ExpressionListAppend(parser->arena, &elements, expression(parser));
         } while (match(parser, TOKEN_COMMA));
     }
 
     consume(parser, TOKEN_R_BRACKET, "Expected ']' after list expression.");
 
-    return Ast_NewListExpr(elements);
+    return Ast_NewListExpr(parser->arena, elements);
 }
 
 Expression* map_expr(Parser* parser)
@@ -718,17 +707,17 @@ Expression* map_expr(Parser* parser)
             Expression* key = expression(parser);
             consume(parser, TOKEN_COLON, "Expected ':' after map key.");
             Expression* value = expression(parser);
-            Ast_MapEntryListAppend(&entries, Ast_NewMapEntry(key, value));
+            Ast_MapEntryListAppend(parser->arena, &entries, Ast_NewMapEntry(parser->arena, key, value));
         } while (match(parser, TOKEN_COMMA));
     }
     consume(parser, TOKEN_R_BRACE, "Expected '}' after map.");
 
-    return Ast_NewMapExpr(entries);
+    return Ast_NewMapExpr(parser->arena, entries);
 }
 
 Expression* identifier_expr(Parser* parser)
 {
-    return Ast_NewIdentifierExpr(parser->previous, LOAD);
+    return Ast_NewIdentifierExpr(parser->arena, parser->previous, LOAD);
 }
 
 static void set_assignment_context(Parser* parser, Expression* expr)
@@ -749,14 +738,14 @@ Expression* prefix_inc_expr(Parser* parser)
     Token op = parser->previous;
     Expression* expr = parse_precedence(parser, PREC_UNARY);
     set_assignment_context(parser, expr);
-    return Ast_NewPrefixIncExpr(op, expr);
+    return Ast_NewPrefixIncExpr(parser->arena, op, expr);
 }
 
 Expression* unary_expr(Parser* parser)
 {
     Token op = parser->previous;
     Expression* expr = parse_precedence(parser, PREC_UNARY);
-    return Ast_NewUnaryExpr(op, expr);
+    return Ast_NewUnaryExpr(parser->arena, op, expr);
 }
 
 Expression* grouping_expr(Parser* parser)
@@ -764,14 +753,14 @@ Expression* grouping_expr(Parser* parser)
     Expression* expr = expression(parser);
     if (match(parser, TOKEN_COMMA)) {
         ExpressionList* elements = NULL;
-        Ast_ExpressionListAppend(&elements, expr);
+        Ast_ExpressionListAppend(parser->arena, &elements, expr);
 
         do {
-            Ast_ExpressionListAppend(&elements, expression(parser));
+            Ast_ExpressionListAppend(parser->arena, &elements, expression(parser));
         } while (match(parser, TOKEN_COMMA));
 
         consume(parser, TOKEN_R_PAREN, "Expected ')' after tuple expression.");
-        return Ast_NewTupleExpr(elements);
+        return Ast_NewTupleExpr(parser->arena, elements);
     }
 
     consume(parser, TOKEN_R_PAREN, "Expected ')' after grouping expression.");
@@ -784,14 +773,14 @@ Expression* super_expr(Parser* parser)
     consume(parser, TOKEN_DOT, "Expected '.' after 'super'.");
     consume(parser, TOKEN_IDENTIFIER, "Expected superclass method name in 'super'.");
     Token method = parser->previous;
-    return Ast_NewSuperExpr(keyword, method);
+    return Ast_NewSuperExpr(parser->arena, keyword, method);
 }
 
 Expression* coroutine_expr(Parser* parser)
 {
     Token keyword = parser->previous;
     Expression* expr = expression(parser);
-    return Ast_NewCoroutineExpr(keyword, expr);
+    return Ast_NewCoroutineExpr(parser->arena, keyword, expr);
 }
 
 Expression* yield_expr(Parser* parser)
@@ -802,7 +791,7 @@ Expression* yield_expr(Parser* parser)
         expr = expression(parser);
     }
 
-    return Ast_NewYieldExpr(keyword, expr);
+    return Ast_NewYieldExpr(parser->arena, keyword, expr);
 }
 
 Expression* unpack_assignment_expr(Parser* parser)
@@ -812,22 +801,22 @@ Expression* unpack_assignment_expr(Parser* parser)
         Expression* target = parse_precedence(parser, PREC_POSTFIX);
         set_assignment_context(parser, target);
 
-        Ast_ExpressionListAppend(&targets, target);
+        Ast_ExpressionListAppend(parser->arena, &targets, target);
     } while (match(parser, TOKEN_COMMA));
 
     consume(parser, TOKEN_PIPE, "Expected '|' at the end of unpacking assignment.");
-    AssignmentTarget* target = Ast_NewUnpackAssignmentTarget(targets);
+    AssignmentTarget* target = Ast_NewUnpackAssignmentTarget(parser->arena, targets);
 
     consume(parser, TOKEN_EQUAL, "Expected '=' in unpacking assignment.");
     Expression* value = expression(parser);
-    return Ast_NewAssignmentExpr(target, value);
+    return Ast_NewAssignmentExpr(parser->arena, target, value);
 }
 
 Expression* call_expr(Parser* parser, Expression* prefix)
 {
     ArgumentList* arguments = arguments_rule(parser);
     consume(parser, TOKEN_R_PAREN, "Expected ')' after call arguments.");
-    return Ast_NewCallExpr(prefix, arguments);
+    return Ast_NewCallExpr(parser->arena, prefix, arguments);
 }
 
 Expression* range_expr(Parser* parser, Expression* prefix)
@@ -839,14 +828,14 @@ Expression* range_expr(Parser* parser, Expression* prefix)
         step = parse_precedence(parser, PREC_CONDITIONAL);
     }
 
-    return Ast_NewRangeExpr(prefix, end, step);
+    return Ast_NewRangeExpr(parser->arena, prefix, end, step);
 }
 
 Expression* property_expr(Parser* parser, Expression* prefix)
 {
     bool safe = parser->previous.type == TOKEN_QUESTION_DOT;
     consume(parser, TOKEN_IDENTIFIER, "Expected property name.");
-    return Ast_NewPropertyExpr(prefix, parser->previous, LOAD, safe);
+    return Ast_NewPropertyExpr(parser->arena, prefix, parser->previous, LOAD, safe);
 }
 
 Expression* subscript_expr(Parser* parser, Expression* prefix)
@@ -854,14 +843,14 @@ Expression* subscript_expr(Parser* parser, Expression* prefix)
     bool safe = parser->previous.type == TOKEN_QUESTION_L_BRACKET;
     Expression* index = expression(parser);
     consume(parser, TOKEN_R_BRACKET, "Expected ']' after subscript.");
-    return Ast_NewSubscriptExpr(prefix, index, LOAD, safe);
+    return Ast_NewSubscriptExpr(parser->arena, prefix, index, LOAD, safe);
 }
 
 Expression* postfix_inc_expr(Parser* parser, Expression* prefix)
 {
     set_assignment_context(parser, prefix);
     Token op = parser->previous;
-    return Ast_NewPostfixIncExpr(op, prefix);
+    return Ast_NewPostfixIncExpr(parser->arena, op, prefix);
 }
 
 Expression* binary_expr(Parser* parser, Expression* prefix)
@@ -872,26 +861,26 @@ Expression* binary_expr(Parser* parser, Expression* prefix)
     Precedence precedence = (rule->associativity == ASSOC_RIGHT) ? rule->precedence : rule->precedence + 1;
 
     Expression* right = parse_precedence(parser, precedence);
-    return Ast_NewBinaryExpr(prefix, op, right);
+    return Ast_NewBinaryExpr(parser->arena, prefix, op, right);
 }
 
 Expression* assignment_expr(Parser* parser, Expression* prefix)
 {
     set_assignment_context(parser, prefix);
 
-    AssignmentTarget* target = Ast_NewSingleAssignmentTarget(prefix);
+    AssignmentTarget* target = Ast_NewSingleAssignmentTarget(parser->arena, prefix);
     Expression* value = parse_precedence(parser, PREC_ASSIGNMENT);
-    return Ast_NewAssignmentExpr(target, value);
+    return Ast_NewAssignmentExpr(parser->arena, target, value);
 }
 
 Expression* compound_assignment_expr(Parser* parser, Expression* prefix)
 {
     set_assignment_context(parser, prefix);
 
-    AssignmentTarget* target = Ast_NewSingleAssignmentTarget(prefix);
+    AssignmentTarget* target = Ast_NewSingleAssignmentTarget(parser->arena, prefix);
     Token op = parser->previous;
     Expression* value = parse_precedence(parser, PREC_ASSIGNMENT);
-    return Ast_NewCompoundAssignmentExpr(target, op, value);
+    return Ast_NewCompoundAssignmentExpr(parser->arena, target, op, value);
 }
 
 Expression* logical_expr(Parser* parser, Expression* prefix)
@@ -899,7 +888,7 @@ Expression* logical_expr(Parser* parser, Expression* prefix)
     Token op = parser->previous;
     ParseRule* rule = get_rule(op.type);
     Expression* right = parse_precedence(parser, rule->precedence);
-    return Ast_NewLogicalExpr(prefix, op, right);
+    return Ast_NewLogicalExpr(parser->arena, prefix, op, right);
 }
 
 Expression* conditional_expr(Parser* parser, Expression* prefix)
@@ -907,34 +896,34 @@ Expression* conditional_expr(Parser* parser, Expression* prefix)
     Expression* thenBranch = expression(parser);
     consume(parser, TOKEN_COLON, "Expected ':' in conditional expression.");
     Expression* elseBranch = parse_precedence(parser, PREC_CONDITIONAL);
-    return Ast_NewConditionalExpr(prefix, thenBranch, elseBranch);
+    return Ast_NewConditionalExpr(parser->arena, prefix, thenBranch, elseBranch);
 }
 
 Expression* elvis_expr(Parser* parser, Expression* prefix)
 {
     Expression* right = expression(parser);
-    return Ast_NewElvisExpr(prefix, right);
+    return Ast_NewElvisExpr(parser->arena, prefix, right);
 }
 
 WhenEntry* when_entry_rule(Parser* parser)
 {
     ExpressionList* cases = NULL;
     do {
-        Ast_ExpressionListAppend(&cases, expression(parser));
+        Ast_ExpressionListAppend(parser->arena, &cases, expression(parser));
     } while (match(parser, TOKEN_COMMA));
 
     consume(parser, TOKEN_R_ARROW, "Expected '->' after 'when' cases.");
 
     Statement* body = statement(parser);
 
-    return Ast_NewWhenEntry(cases, body);
+    return Ast_NewWhenEntry(parser->arena, cases, body);
 }
 
 WhenEntryList* when_entries_rule(Parser* parser)
 {
     WhenEntryList* entries = NULL;
     while (!check(parser, TOKEN_ELSE) && !check(parser, TOKEN_R_BRACE) && !check(parser, TOKEN_EOF)) {
-        Ast_WhenEntryListAppend(&entries, when_entry_rule(parser));
+        Ast_WhenEntryListAppend(parser->arena, &entries, when_entry_rule(parser));
     }
     return entries;
 }
@@ -943,10 +932,10 @@ Block* block_rule(Parser* parser)
 {
     DeclarationList* body = NULL;
     while (!check(parser, TOKEN_R_BRACE) && !check(parser, TOKEN_EOF)) {
-        Ast_DeclarationListAppend(&body, declaration(parser));
+        Ast_DeclarationListAppend(parser->arena, &body, declaration(parser));
     }
     consume(parser, TOKEN_R_BRACE, "Expected '}' after block.");
-    return Ast_NewBlock(body);
+    return Ast_NewBlock(parser->arena, body);
 }
 
 ArgumentList* arguments_rule(Parser* parser)
@@ -957,7 +946,7 @@ ArgumentList* arguments_rule(Parser* parser)
             if (Ast_ArgumentListLength(arguments) > 255) {
                 error(parser, "Cannot have more than 255 arguments.");
             }
-            Ast_ArgumentListAppend(&arguments, expression(parser));
+            Ast_ArgumentListAppend(parser->arena, &arguments, expression(parser));
         } while (match(parser, TOKEN_COMMA));
     }
 
@@ -970,20 +959,20 @@ NamedFunction* named_function_rule(Parser* parser, bool coroutine)
     Token identifier = parser->previous;
 
     consume(parser, TOKEN_L_PAREN, "Expected '(' after function name in declaration.");
-    ParameterList* parameters = parameters_rule(parser);
+    ParameterList* parameters = parameters_rule(parser, true);
     consume(parser, TOKEN_R_PAREN, "Expected ')' after function parameters in declaration.");
 
     FunctionBody* body = NULL;
     if (match(parser, TOKEN_EQUAL)) {
-        body = Ast_NewExpressionFunctionBody(expression(parser));
+        body = Ast_NewExpressionFunctionBody(parser->arena, expression(parser));
         consume(parser, TOKEN_SEMICOLON, "Expected ';' after expression function.");
     } else {
         consume(parser, TOKEN_L_BRACE, "Expected '{' before function body in declaration.");
-        body = Ast_NewBlockFunctionBody(block_rule(parser));
+        body = Ast_NewBlockFunctionBody(parser->arena, block_rule(parser));
     }
 
-    Function* function = Ast_NewFunction(parameters, body);
-    return Ast_NewNamedFunction(identifier, function, coroutine);
+    Function* function = Ast_NewFunction(parser->arena, parameters, body);
+    return Ast_NewNamedFunction(parser->arena, identifier, function, coroutine);
 }
 
 Method* method_rule(Parser* parser)
@@ -991,37 +980,68 @@ Method* method_rule(Parser* parser)
     bool isStatic = match(parser, TOKEN_STATIC);
     bool isCoroutine = match(parser, TOKEN_COROUTINE);
     NamedFunction* namedFunction = named_function_rule(parser, isCoroutine);
-    return Ast_NewMethod(isStatic, namedFunction);
+    return Ast_NewMethod(parser->arena, isStatic, namedFunction);
 }
 
-ParameterList* parameters_rule(Parser* parser)
+ParameterList* parameters_rule(Parser* parser, bool annotated)
 {
     ParameterList* parameters = NULL;
     if (!check(parser, TOKEN_R_PAREN)) {
         do {
             consume(parser, TOKEN_IDENTIFIER, "Expected parameter name.");
-            Ast_ParameterListAppend(&parameters, parser->previous);
+            Token parameter = parser->previous;
+            Token annotation = annotated ? annotation_rule(parser) : Token_Empty();
+            Ast_ParameterListAppend(parser->arena, &parameters, parameter, annotation);
         } while (match(parser, TOKEN_COMMA));
     }
     return parameters;
 }
 
-AST* Parser_Parse(const char* source)
+Token annotation_rule(Parser* parser)
 {
-    Parser parser;
-    parser_init(&parser, source);
+    if (!match(parser, TOKEN_COLON)) {
+        return Token_Empty();
+    }
+
+    consume(parser, TOKEN_IDENTIFIER, "Expected type name after ':'.");
+    return parser->previous;
+}
 
-    advance(&parser);
+void Parser_Init(Parser* parser, Arena* arena, const char* source)
+{
+    parser->arena = arena;
+    Scanner_Init(&parser->scanner, source);
+    parser->error = false;
+    parser->panic = false;
+
+    advance(parser);
+}
+
+bool Parser_AtEnd(Parser* parser)
+{
+    return match(parser, TOKEN_EOF);
+}
+
+Declaration* Parser_ParseDeclaration(Parser* parser)
+{
+    return declaration(parser);
+}
+
+AST* Parser_Parse(Arena* arena, const char* source)
+{
+    Parser parser;
+    Parser_Init(&parser, arena, source);
 
     DeclarationList* program = NULL;
-    while (!match(&parser, TOKEN_EOF)) {
-        Ast_DeclarationListAppend(&program, declaration(&parser));
+    DeclarationList** tail = &program;
+    while (!Parser_AtEnd(&parser)) {
+        *tail = Ast_NewDeclarationNode(arena, Parser_ParseDeclaration(&parser));
+        tail = &(*tail)->next;
     }
 
     if (parser.error) {
-        Ast_DeleteDeclarationList(program);
         return NULL;
     }
 
-    return Ast_NewTree(program);
+    return Ast_NewTree(arena, program);
 }
@@ -2,7 +2,23 @@
 #define PARSER_H
 
 #include "ast.h"
+#include "scanner.h"
 
-AST* Parser_Parse(const char* source);
+typedef struct Parser {
+    Arena* arena;
+    Scanner scanner;
+
+    Token current;
+    Token previous;
+
+    bool error;
+    bool panic;
+} Parser;
+
+void Parser_Init(Parser* parser, Arena* arena, const char* source);
+bool Parser_AtEnd(Parser* parser);
+Declaration* Parser_ParseDeclaration(Parser* parser);
+
+AST* Parser_Parse(Arena* arena, const char* source);
 
 #endif
@@ -0,0 +1,227 @@
+#include "pool.h"
+
+struct PoolBlock {
+    PoolBlock* next;
+};
+
+struct PoolPage {
+    PoolPage* next;
+    PoolPage* previous;
+
+    PoolPage* nextAvailable;
+    PoolPage* previousAvailable;
+    bool available;
+
+    PoolBlock* free;
+    size_t used;
+    size_t blockSize;
+};
+
+//Headers take up whole granules, so that every block stays as aligned as malloc would make it
+#define HEADER_SIZE ((sizeof(PoolPage) + POOL_GRANULARITY - 1) / POOL_GRANULARITY * POOL_GRANULARITY)
+
+#define PAGE_OF(block) ((PoolPage*)((uintptr_t)(block) & ~(uintptr_t)(POOL_PAGE_SIZE - 1)))
+
+void Pool_Init(Pool* pool)
+{
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        PoolClass* sizeClass = &pool->classes[i];
+        sizeClass->current = NULL;
+        sizeClass->cursor = NULL;
+        sizeClass->limit = NULL;
+        sizeClass->available = NULL;
+    }
+
+    pool->pages = NULL;
+    pool->ownsPages = true;
+    pool->freedHead = NULL;
+    pool->freedTail = NULL;
+}
+
+void Pool_InitDetached(Pool* pool)
+{
+    Pool_Init(pool);
+    pool->ownsPages = false;
+}
+
+void Pool_Free(Pool* pool)
+{
+    PoolPage* page = pool->pages;
+    while (page) {
+        PoolPage* next = page->next;
+        Mem_UnmapPages(page, POOL_PAGE_SIZE);
+        page = next;
+    }
+
+    bool ownsPages = pool->ownsPages;
+    Pool_Init(pool);
+    pool->ownsPages = ownsPages;
+}
+
+static void add_available(PoolClass* sizeClass, PoolPage* page)
+{
+    page->available = true;
+    page->previousAvailable = NULL;
+    page->nextAvailable = sizeClass->available;
+    if (sizeClass->available) {
+        sizeClass->available->previousAvailable = page;
+    }
+
+    sizeClass->available = page;
+}
+
+static void remove_available(PoolClass* sizeClass, PoolPage* page)
+{
+    if (page->previousAvailable) {
+        page->previousAvailable->nextAvailable = page->nextAvailable;
+    } else {
+        sizeClass->available = page->nextAvailable;
+    }
+
+    if (page->nextAvailable) {
+        page->nextAvailable->previousAvailable = page->previousAvailable;
+    }
+
+    page->available = false;
+}
+
+static void add_page(Pool* pool, PoolClass* sizeClass, size_t blockSize)
+{
+    PoolPage* page = Mem_MapPages(POOL_PAGE_SIZE);
+    page->available = false;
+    page->free = NULL;
+    page->used = 0;
+    page->blockSize = blockSize;
+
+    page->previous = NULL;
+    page->next = pool->pages;
+    if (pool->pages) {
+        pool->pages->previous = page;
+    }
+
+    pool->pages = page;
+
+    sizeClass->current = page;
+    sizeClass->cursor = (char*)page + HEADER_SIZE;
+    sizeClass->limit = (char*)page + POOL_PAGE_SIZE;
+}
+
+static void remove_page(Pool* pool, PoolPage* page)
+{
+    if (page->previous) {
+        page->previous->next = page->next;
+    } else {
+        pool->pages = page->next;
+    }
+
+    if (page->next) {
+        page->next->previous = page->previous;
+    }
+
+    Mem_UnmapPages(page, POOL_PAGE_SIZE);
+}
+
+void* Pool_Allocate(Pool* pool, size_t size)
+{
+    size_t index = POOL_CLASS(size);
+    PoolClass* sizeClass = &pool->classes[index];
+    size_t blockSize = (index + 1) * POOL_GRANULARITY;
+
+    while (true) {
+        PoolPage* page = sizeClass->current;
+        if (page && page->free) {
+            PoolBlock* block = page->free;
+            page->free = block->next;
+            page->used++;
+            return block;
+        }
+
+        //Fresh pages are handed out from front to back, so blocks allocated together also sit together
+        if (page && sizeClass->cursor + blockSize <= sizeClass->limit) {
+            void* block = sizeClass->cursor;
+            sizeClass->cursor += blockSize;
+            page->used++;
+            return block;
+        }
+
+        if (sizeClass->available) {
+            page = sizeClass->available;
+            remove_available(sizeClass, page);
+
+            sizeClass->current = page;
+            sizeClass->cursor = NULL;
+            sizeClass->limit = NULL;
+        } else {
+            add_page(pool, sizeClass, blockSize);
+        }
+    }
+}
+
+static void return_block(Pool* pool, PoolBlock* block)
+{
+    PoolPage* page = PAGE_OF(block);
+    PoolClass* sizeClass = &pool->classes[POOL_CLASS(page->blockSize)];
+
+    block->next = page->free;
+    page->free = block;
+    page->used--;
+
+    //The current page is kept even when empty, so that a block freed and allocated over and over does not map pages
+    if (page == sizeClass->current) {
+        return;
+    }
+
+    if (page->used == 0) {
+        if (page->available) {
+            remove_available(sizeClass, page);
+        }
+
+        remove_page(pool, page);
+    } else if (!page->available) {
+        add_available(sizeClass, page);
+    }
+}
+
+void Pool_Deallocate(Pool* pool, void* pointer, size_t size)
+{
+    PoolBlock* block = (PoolBlock*)pointer;
+
+    if (pool->ownsPages) {
+        return_block(pool, block);
+        return;
+    }
+
+    //Detached pools must not touch the pages, which belong to a pool on another thread
+    block->next = pool->freedHead;
+    pool->freedHead = block;
+    if (!pool->freedTail) {
+        pool->freedTail = block;
+    }
+}
+
+//Moves every block freed into the other pool into this one, returning them to their pages if it owns them
+void Pool_Reclaim(Pool* pool, Pool* other)
+{
+    PoolBlock* block = other->freedHead;
+    if (!block) {
+        return;
+    }
+
+    if (pool->ownsPages) {
+        while (block) {
+            PoolBlock* next = block->next;
+            return_block(pool, block);
+            block = next;
+        }
+    } else {
+        other->freedTail->next = pool->freedHead;
+        if (!pool->freedTail) {
+            pool->freedTail = other->freedTail;
+        }
+
+        pool->freedHead = other->freedHead;
+    }
+
+    other->freedHead = NULL;
+    other->freedTail = NULL;
+}
@@ -0,0 +1,46 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "common.h"
+#include "memory.h"
+
+//Small allocations are carved out of pages that hold blocks of a single size. Each page keeps its own free blocks and
+//is given back to the system as soon as none of them are in use.
+#define POOL_GRANULARITY 16
+#define POOL_MAX_SIZE 512
+#define POOL_CLASS_COUNT (POOL_MAX_SIZE / POOL_GRANULARITY)
+#define POOL_PAGE_SIZE MEM_PAGE_ALIGNMENT
+
+#define POOL_CLASS(size) ((size) == 0 ? 0 : ((size) - 1) / POOL_GRANULARITY)
+
+typedef struct PoolBlock PoolBlock;
+typedef struct PoolPage PoolPage;
+
+typedef struct PoolClass {
+    PoolPage* current;
+    char* cursor;
+    char* limit;
+
+    //Pages other than the current one that have free blocks
+    PoolPage* available;
+} PoolClass;
+
+typedef struct Pool {
+    PoolClass classes[POOL_CLASS_COUNT];
+    PoolPage* pages;
+
+    //Detached pools have no pages, and only gather the blocks freed into them until another pool reclaims them
+    bool ownsPages;
+    PoolBlock* freedHead;
+    PoolBlock* freedTail;
+} Pool;
+
+void Pool_Init(Pool* pool);
+void Pool_InitDetached(Pool* pool);
+void Pool_Free(Pool* pool);
+
+void* Pool_Allocate(Pool* pool, size_t size);
+void Pool_Deallocate(Pool* pool, void* pointer, size_t size);
+void Pool_Reclaim(Pool* pool, Pool* other);
+
+#endif
@@ -0,0 +1,248 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+#include "memory.h"
+
+#define PROFILE_MIN_CAPACITY 64
+
+static const char* siteNames[] = { "call", "branch", "operands" };
+
+void Profile_Init(Profile* profile)
+{
+    profile->sites = NULL;
+    profile->siteCount = 0;
+    profile->siteCapacity = 0;
+
+    profile->slots = NULL;
+    profile->slotCapacity = 0;
+
+    profile->files = NULL;
+    profile->fileCount = 0;
+}
+
+void Profile_Free(Profile* profile)
+{
+    for (size_t i = 0; i < profile->fileCount; i++) {
+        free(profile->files[i]);
+    }
+
+    free(profile->files);
+    free(profile->sites);
+    free(profile->slots);
+    Profile_Init(profile);
+}
+
+//Only a handful of modules make up a program, so they are simply looked up one after another
+static int find_file(Profile* profile, const char* file)
+{
+    for (size_t i = 0; i < profile->fileCount; i++) {
+        if (strcmp(profile->files[i], file) == 0) {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+static uint32_t add_file(Profile* profile, const char* file)
+{
+    int index = find_file(profile, file);
+    if (index >= 0) {
+        return (uint32_t)index;
+    }
+
+    size_t length = strlen(file);
+    char* copy = xmalloc(length + 1);
+    memcpy(copy, file, length + 1);
+
+    profile->files = xrealloc(profile->files, sizeof(char*) * (profile->fileCount + 1));
+    profile->files[profile->fileCount] = copy;
+    return (uint32_t)profile->fileCount++;
+}
+
+static uint32_t hash_site(uint32_t file, SiteKind kind, int line, int column)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t parts[] = { file, (uint32_t)kind, (uint32_t)line, (uint32_t)column };
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++) {
+        hash ^= parts[i];
+        hash *= 16777619;
+    }
+
+    return hash;
+}
+
+static uint32_t* find_slot(Profile* profile, uint32_t file, SiteKind kind, int line, int column)
+{
+    size_t index = hash_site(file, kind, line, column) & (profile->slotCapacity - 1);
+    for (;;) {
+        uint32_t* slot = &profile->slots[index];
+        if (*slot == 0) {
+            return slot;
+        }
+
+        ProfileSite* site = &profile->sites[*slot - 1];
+        if (site->file == file && site->kind == kind && site->line == line && site->column == column) {
+            return slot;
+        }
+
+        index = (index + 1) & (profile->slotCapacity - 1);
+    }
+}
+
+static void grow_slots(Profile* profile)
+{
+    size_t capacity = profile->slotCapacity < PROFILE_MIN_CAPACITY ? PROFILE_MIN_CAPACITY : profile->slotCapacity * 2;
+
+    free(profile->slots);
+    profile->slots = xmalloc(sizeof(uint32_t) * capacity);
+    profile->slotCapacity = capacity;
+    memset(profile->slots, 0, sizeof(uint32_t) * capacity);
+
+    for (size_t i = 0; i < profile->siteCount; i++) {
+        ProfileSite* site = &profile->sites[i];
+        *find_slot(profile, site->file, site->kind, site->line, site->column) = (uint32_t)i + 1;
+    }
+}
+
+static uint32_t add_site(Profile* profile, uint32_t file, SiteKind kind, int line, int column)
+{
+    if ((profile->siteCount + 1) * 4 > profile->slotCapacity * 3) {
+        grow_slots(profile);
+    }
+
+    uint32_t* slot = find_slot(profile, file, kind, line, column);
+    if (*slot != 0) {
+        return *slot - 1;
+    }
+
+    if (profile->siteCount >= profile->siteCapacity) {
+        profile->siteCapacity = profile->siteCapacity < PROFILE_MIN_CAPACITY ? PROFILE_MIN_CAPACITY : profile->siteCapacity * 2;
+        profile->sites = xrealloc(profile->sites, sizeof(ProfileSite) * profile->siteCapacity);
+    }
+
+    profile->sites[profile->siteCount] = (ProfileSite) {
+        .kind = kind,
+        .file = file,
+        .line = line,
+        .column = column,
+        .counts = { 0, 0 }
+    };
+
+    *slot = (uint32_t)profile->siteCount + 1;
+    return (uint32_t)profile->siteCount++;
+}
+
+uint32_t Profile_AddSite(Profile* profile, const char* file, SiteKind kind, int line, int column)
+{
+    return add_site(profile, add_file(profile, file), kind, line, column);
+}
+
+ProfileSite* Profile_FindSite(Profile* profile, const char* file, SiteKind kind, int line, int column)
+{
+    int index = find_file(profile, file);
+    if (index < 0 || profile->slotCapacity == 0) {
+        return NULL;
+    }
+
+    uint32_t slot = *find_slot(profile, (uint32_t)index, kind, line, column);
+    return slot != 0 ? &profile->sites[slot - 1] : NULL;
+}
+
+static bool read_site(Profile* profile, const char* line, size_t length)
+{
+    char name[16];
+    unsigned long long first;
+    unsigned long long second;
+    int number;
+    int column;
+    int consumed = 0;
+
+    if (sscanf(line, "%15s %llu %llu %d:%d %n", name, &first, &second, &number, &column, &consumed) != 5 || consumed == 0) {
+        return false;
+    }
+
+    int kind = -1;
+    for (int i = 0; i < (int)(sizeof(siteNames) / sizeof(siteNames[0])); i++) {
+        if (strcmp(name, siteNames[i]) == 0) {
+            kind = i;
+        }
+    }
+
+    //The rest of the line names the module, which may contain spaces of its own
+    size_t fileLength = length - (size_t)consumed;
+    if (kind < 0 || number <= 0 || column <= 0 || (size_t)consumed >= length) {
+        return false;
+    }
+
+    char* file = xmalloc(fileLength + 1);
+    memcpy(file, line + consumed, fileLength);
+    file[fileLength] = '\0';
+
+    uint32_t index = add_site(profile, add_file(profile, file), (SiteKind)kind, number, column);
+    profile->sites[index].counts[0] += first;
+    profile->sites[index].counts[1] += second;
+
+    free(file);
+    return true;
+}
+
+bool Profile_Read(Profile* profile, const char* source, int* errorLine)
+{
+    int number = 1;
+    const char* line = source;
+    while (*line != '\0') {
+        size_t length = strcspn(line, "\n");
+        const char* next = line[length] == '\n' ? line + length + 1 : line + length;
+
+        //Line endings and trailing whitespace are not part of the module's name
+        while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == ' ' || line[length - 1] == '\t')) {
+            length--;
+        }
+
+        //Empty lines and comments, which start with a '#', are skipped
+        size_t indent = strspn(line, " \t");
+        if (indent < length && line[indent] != '#') {
+            char* copy = xmalloc(length + 1);
+            memcpy(copy, line, length);
+            copy[length] = '\0';
+
+            bool valid = read_site(profile, copy, length);
+            free(copy);
+
+            if (!valid) {
+                *errorLine = number;
+                return false;
+            }
+        }
+
+        line = next;
+        number++;
+    }
+
+    return true;
+}
+
+bool Profile_Write(Profile* profile, FILE* file)
+{
+    fprintf(file, "# kind, counts, line:column, module\n");
+
+    //Sites that were never reached have nothing to say about the program
+    for (size_t i = 0; i < profile->siteCount; i++) {
+        ProfileSite* site = &profile->sites[i];
+        if (site->counts[0] == 0 && site->counts[1] == 0) {
+            continue;
+        }
+
+        fprintf(file, "%s %llu %llu %d:%d %s\n",
+                siteNames[site->kind],
+                (unsigned long long)site->counts[0],
+                (unsigned long long)site->counts[1],
+                site->line,
+                site->column,
+                profile->files[site->file]);
+    }
+
+    return fflush(file) == 0 && !ferror(file);
+}
@@ -0,0 +1,49 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+
+#include "common.h"
+
+//Sites that a training run reached fewer times than this are compiled as if there was no profile
+#define PROFILE_HOT_COUNT 16
+
+//Share of a branch's outcomes that must go one way for the other one to be moved out of line
+#define PROFILE_BIAS 0.9
+
+typedef enum { SITE_CALL, SITE_BRANCH, SITE_OPERANDS } SiteKind;
+
+//A place in a module's source, found by the line and column of its token, and what a run has seen happen there.
+//Calls count the times a function was entered, branches the times a condition was truthy and falsey, and operands
+//the times an operator was given only numbers and anything else.
+typedef struct ProfileSite {
+    SiteKind kind;
+    uint32_t file;
+    int line;
+    int column;
+    uint64_t counts[2];
+} ProfileSite;
+
+typedef struct Profile {
+    ProfileSite* sites;
+    size_t siteCount;
+    size_t siteCapacity;
+
+    //Indices of the sites plus one, hashed by where they are
+    uint32_t* slots;
+    size_t slotCapacity;
+
+    char** files;
+    size_t fileCount;
+} Profile;
+
+void Profile_Init(Profile* profile);
+void Profile_Free(Profile* profile);
+
+uint32_t Profile_AddSite(Profile* profile, const char* file, SiteKind kind, int line, int column);
+ProfileSite* Profile_FindSite(Profile* profile, const char* file, SiteKind kind, int line, int column);
+
+bool Profile_Read(Profile* profile, const char* source, int* errorLine);
+bool Profile_Write(Profile* profile, FILE* file);
+
+#endif
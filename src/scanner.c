@@ -4,10 +4,105 @@
 #include "scanner.h"
 #include "common.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#define SCANNER_SIMD 1
+#define BLOCK_SIZE 32
+#define BLOCK_ALL 0xFFFFFFFFu
+
+typedef __m256i Block;
+
+#define BLOCK_LOAD(pointer) _mm256_loadu_si256((const __m256i*)(pointer))
+#define BLOCK_SET(c) _mm256_set1_epi8(c)
+#define BLOCK_EQUAL(a, b) _mm256_cmpeq_epi8(a, b)
+#define BLOCK_GREATER(a, b) _mm256_cmpgt_epi8(a, b)
+#define BLOCK_AND(a, b) _mm256_and_si256(a, b)
+#define BLOCK_OR(a, b) _mm256_or_si256(a, b)
+#define BLOCK_MASK(a) ((uint32_t)_mm256_movemask_epi8(a))
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+#define SCANNER_SIMD 1
+#define BLOCK_SIZE 16
+#define BLOCK_ALL 0xFFFFu
+
+typedef __m128i Block;
+
+#define BLOCK_LOAD(pointer) _mm_loadu_si128((const __m128i*)(pointer))
+#define BLOCK_SET(c) _mm_set1_epi8(c)
+#define BLOCK_EQUAL(a, b) _mm_cmpeq_epi8(a, b)
+#define BLOCK_GREATER(a, b) _mm_cmpgt_epi8(a, b)
+#define BLOCK_AND(a, b) _mm_and_si128(a, b)
+#define BLOCK_OR(a, b) _mm_or_si128(a, b)
+#define BLOCK_MASK(a) ((uint32_t)_mm_movemask_epi8(a))
+#else
+#define SCANNER_SIMD 0
+#endif
+
+#if SCANNER_SIMD
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+static int count_trailing_zeros(uint32_t mask)
+{
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+}
+
+#define count_bits(mask) ((int)__popcnt(mask))
+#else
+#define count_trailing_zeros(mask) __builtin_ctz(mask)
+#define count_bits(mask) __builtin_popcount(mask)
+#endif
+
+//Bytes above 0x7F compare as negative, so they never fall into any of the ranges
+static Block block_in_range(Block block, char low, char high)
+{
+    return BLOCK_AND(BLOCK_GREATER(block, BLOCK_SET(low - 1)), BLOCK_GREATER(BLOCK_SET(high + 1), block));
+}
+
+static uint32_t newline_mask(Block block)
+{
+    return BLOCK_MASK(BLOCK_EQUAL(block, BLOCK_SET('\n')));
+}
+
+static uint32_t whitespace_mask(Block block)
+{
+    return BLOCK_MASK(BLOCK_OR(BLOCK_EQUAL(block, BLOCK_SET(' ')), block_in_range(block, '\t', '\r')));
+}
+
+static uint32_t identifier_mask(Block block)
+{
+    Block lower = BLOCK_OR(block, BLOCK_SET(0x20));
+    Block alpha = BLOCK_OR(block_in_range(lower, 'a', 'z'), BLOCK_EQUAL(block, BLOCK_SET('_')));
+    return BLOCK_MASK(BLOCK_OR(alpha, block_in_range(block, '0', '9')));
+}
+
+static uint32_t digit_mask(Block block)
+{
+    return BLOCK_MASK(block_in_range(block, '0', '9'));
+}
+
+static uint32_t string_stop_mask(Block block)
+{
+    Block quote = BLOCK_OR(BLOCK_EQUAL(block, BLOCK_SET('"')), BLOCK_EQUAL(block, BLOCK_SET('\\')));
+    Block special = BLOCK_OR(BLOCK_EQUAL(block, BLOCK_SET('$')), BLOCK_EQUAL(block, BLOCK_SET('\n')));
+    return BLOCK_MASK(BLOCK_OR(quote, special));
+}
+
+static uint32_t star_mask(Block block)
+{
+    return BLOCK_MASK(BLOCK_EQUAL(block, BLOCK_SET('*')));
+}
+#endif
+
 void Scanner_Init(Scanner* scanner, const char* source)
 {
     scanner->start = source;
     scanner->current = source;
+    scanner->end = source + strlen(source);
     scanner->line = 1;
 
     Scanner_Clear(scanner);
@@ -82,6 +177,98 @@ static bool is_alpha_num(char c)
     return is_alpha(c) || is_digit(c);
 }
 
+#if SCANNER_SIMD
+//Consumes whole blocks for as long as every byte in them is accepted, and stops at the first
+//byte that is not; whatever remains near the end of the source is left to the scalar loops
+#define SKIP_BLOCKS(scanner, accept, countLines)                                                    \
+    do {                                                                                            \
+        while ((scanner)->end - (scanner)->current >= BLOCK_SIZE) {                                 \
+            Block block = BLOCK_LOAD((scanner)->current);                                           \
+            uint32_t stop = (accept(block)) ^ BLOCK_ALL;                                            \
+            uint32_t lines = (countLines) ? newline_mask(block) : 0;                                \
+                                                                                                    \
+            if (stop) {                                                                             \
+                int offset = count_trailing_zeros(stop);                                            \
+                lines &= (1u << offset) - 1;                                                        \
+                (scanner)->line += lines ? count_bits(lines) : 0;                                   \
+                (scanner)->current += offset;                                                       \
+                break;                                                                              \
+            }                                                                                       \
+                                                                                                    \
+            (scanner)->line += lines ? count_bits(lines) : 0;                                       \
+            (scanner)->current += BLOCK_SIZE;                                                       \
+        }                                                                                           \
+    } while (false)
+
+#define NOT_NEWLINE(block) (newline_mask(block) ^ BLOCK_ALL)
+#define NOT_STAR(block) (star_mask(block) ^ BLOCK_ALL)
+#define NOT_STRING_STOP(block) (string_stop_mask(block) ^ BLOCK_ALL)
+#endif
+
+static void skip_spaces(Scanner* scanner)
+{
+#if SCANNER_SIMD
+    //Most tokens are followed by at most a single space, which is not worth a vector load
+    if (isspace(peek(scanner)) && isspace(peek_next(scanner))) {
+        SKIP_BLOCKS(scanner, whitespace_mask, true);
+    }
+#endif
+}
+
+static void skip_line_comment(Scanner* scanner)
+{
+#if SCANNER_SIMD
+    SKIP_BLOCKS(scanner, NOT_NEWLINE, false);
+#endif
+    while (peek(scanner) != '\n' && !reached_end(scanner)) {
+        advance(scanner);
+    }
+}
+
+static void skip_block_comment_body(Scanner* scanner)
+{
+#if SCANNER_SIMD
+    SKIP_BLOCKS(scanner, NOT_STAR, true);
+#endif
+    while (peek(scanner) != '*' && !reached_end(scanner)) {
+        if (advance(scanner) == '\n') {
+            scanner->line++;
+        }
+    }
+}
+
+static void skip_identifier_body(Scanner* scanner)
+{
+#if SCANNER_SIMD
+    if (is_alpha_num(peek(scanner))) {
+        SKIP_BLOCKS(scanner, identifier_mask, false);
+    }
+#endif
+    while (is_alpha_num(peek(scanner))) {
+        advance(scanner);
+    }
+}
+
+static void skip_digits(Scanner* scanner)
+{
+#if SCANNER_SIMD
+    if (is_digit(peek(scanner))) {
+        SKIP_BLOCKS(scanner, digit_mask, false);
+    }
+#endif
+    while (is_digit(peek(scanner))) {
+        advance(scanner);
+    }
+}
+
+//Skips the characters that do not need any special treatment inside a string literal
+static void skip_string_body(Scanner* scanner)
+{
+#if SCANNER_SIMD
+    SKIP_BLOCKS(scanner, NOT_STRING_STOP, false);
+#endif
+}
+
 static Token make_token_at(Scanner* scanner, TokenType type, const char* end)
 {
     return (Token) { .type = type, .start = scanner->start, .length = end - scanner->start, .line = scanner->line };
@@ -100,6 +287,7 @@ static Token error_token(const char* message, int line)
 static Token skip_whitespace(Scanner* scanner)
 {
     while (true) {
+        skip_spaces(scanner);
         char c = peek(scanner);
 
         if (c == '\n') {
@@ -115,9 +303,7 @@ static Token skip_whitespace(Scanner* scanner)
 
         if (c == '/') {
             if (peek_next(scanner) == '/') {
-                while (peek(scanner) != '\n' && !reached_end(scanner)) {
-                    advance(scanner);
-                }
+                skip_line_comment(scanner);
                 continue;
             }
 
@@ -125,15 +311,15 @@ static Token skip_whitespace(Scanner* scanner)
                 advance(scanner);
                 advance(scanner);
 
-                while (!match(scanner, '*') || !match(scanner, '/')) {
-                    if (peek(scanner) == '\n') {
-                        scanner->line++;
-                    }
-
-                    advance(scanner);
+                while (true) {
+                    skip_block_comment_body(scanner);
                     if (reached_end(scanner)) {
                         return error_token("Unterminated block comment.", scanner->line);
                     }
+
+                    if (match(scanner, '*') && match(scanner, '/')) {
+                        break;
+                    }
                 }
                 continue;
             }
@@ -182,7 +368,7 @@ static void end_identifier_interpolation(Scanner* scanner)
 
 static bool interpolated_identifier(Scanner* scanner)
 {
-    return scanner->unmatchedInterpolations[scanner->interpolationDepth] == -1;
+    return interpolating(scanner) && scanner->unmatchedInterpolations[scanner->interpolationDepth] == -1;
 }
 
 static char enter_interpolation(Scanner* scanner)
@@ -198,7 +384,12 @@ static char leave_interpolation(Scanner* scanner)
 
 static Token string(Scanner* scanner, bool interpolation)
 {
-    while (!match(scanner, '"')) {
+    while (true) {
+        skip_string_body(scanner);
+        if (match(scanner, '"')) {
+            break;
+        }
+
         if (peek(scanner) == '\n' || reached_end(scanner)) {
             return error_token("Unterminated string.", scanner->line);
         }
@@ -253,15 +444,11 @@ static Token continue_interpolated_string(Scanner* scanner)
 
 static Token number(Scanner* scanner)
 {
-    while (is_digit(peek(scanner))) {
-        advance(scanner);
-    }
+    skip_digits(scanner);
 
     if (peek(scanner) == '.' && peek_next(scanner) != '.') {
         advance(scanner);
-        while (is_digit(peek(scanner))) {
-            advance(scanner);
-        }
+        skip_digits(scanner);
     }
 
     return make_token(scanner, TOKEN_NUMBER);
@@ -385,9 +572,7 @@ static TokenType identifier_type(Scanner* scanner)
 
 static Token identifier(Scanner* scanner)
 {
-    while (is_alpha_num(peek(scanner))) {
-        advance(scanner);
-    }
+    skip_identifier_body(scanner);
 
     TokenType type = identifier_type(scanner);
     if (interpolating_identifier(scanner)) {
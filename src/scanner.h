@@ -8,6 +8,7 @@
 typedef struct {
     const char* start;
     const char* current;
+    const char* end;
     int line;
 
     int unmatchedInterpolations[MAX_INTERPOLATION_DEPTH];
@@ -0,0 +1,165 @@
+#include <string.h>
+
+#include "sweeper.h"
+#include "object.h"
+#include "memory.h"
+#include "gc.h"
+
+struct SweeperBatch {
+    SweeperBatch* next;
+    size_t count;
+    Object* objects[];
+};
+
+void Sweeper_Init(Sweeper* sweeper)
+{
+    sweeper->queueHead = NULL;
+    sweeper->queueTail = NULL;
+    sweeper->bytesFreed = 0;
+    Pool_InitDetached(&sweeper->freedBlocks);
+    Heap_InitDetached(&sweeper->freedObjects);
+
+    mtx_init(&sweeper->lock, mtx_plain);
+    cnd_init(&sweeper->batchQueued);
+    cnd_init(&sweeper->batchFreed);
+    sweeper->busy = false;
+
+    sweeper->started = false;
+    sweeper->failed = false;
+    sweeper->shutdown = false;
+}
+
+void Sweeper_Free(Sweeper* sweeper)
+{
+    if (sweeper->started) {
+        mtx_lock(&sweeper->lock);
+        sweeper->shutdown = true;
+        cnd_signal(&sweeper->batchQueued);
+        mtx_unlock(&sweeper->lock);
+
+        thrd_join(sweeper->thread, NULL);
+    }
+
+    cnd_destroy(&sweeper->batchQueued);
+    cnd_destroy(&sweeper->batchFreed);
+    mtx_destroy(&sweeper->lock);
+}
+
+//Returns the number of bytes released by freeing the objects, whose blocks are moved into the pool and the heap
+static size_t free_batch(Object** objects, size_t count, Pool* pool, Heap* heap)
+{
+    //Freeing only updates the byte count of the collector it is given, which starts at zero and wraps below it
+    GC counter = { 0 };
+
+    for (size_t i = 0; i < count; i++) {
+        Object_Free(objects[i], &counter);
+    }
+
+    Pool_Reclaim(pool, &counter.pool);
+    Heap_Reclaim(heap, &counter.heap);
+    return (size_t)0 - counter.bytesAllocated;
+}
+
+static int worker(void* arg)
+{
+    Sweeper* sweeper = (Sweeper*)arg;
+
+    mtx_lock(&sweeper->lock);
+    while (true) {
+        while (!sweeper->queueHead && !sweeper->shutdown) {
+            cnd_wait(&sweeper->batchQueued, &sweeper->lock);
+        }
+
+        //Whatever was queued before the shutdown is still freed, since the objects are already gone from the heap
+        if (!sweeper->queueHead) {
+            break;
+        }
+
+        SweeperBatch* batch = sweeper->queueHead;
+        sweeper->queueHead = NULL;
+        sweeper->queueTail = NULL;
+        sweeper->busy = true;
+        mtx_unlock(&sweeper->lock);
+
+        Pool freedBlocks;
+        Pool_InitDetached(&freedBlocks);
+        Heap freedObjects;
+        Heap_InitDetached(&freedObjects);
+
+        size_t freed = 0;
+        while (batch) {
+            SweeperBatch* next = batch->next;
+            freed += free_batch(batch->objects, batch->count, &freedBlocks, &freedObjects);
+            free(batch);
+            batch = next;
+        }
+
+        mtx_lock(&sweeper->lock);
+        sweeper->bytesFreed += freed;
+        Pool_Reclaim(&sweeper->freedBlocks, &freedBlocks);
+        Heap_Reclaim(&sweeper->freedObjects, &freedObjects);
+        sweeper->busy = false;
+        cnd_broadcast(&sweeper->batchFreed);
+    }
+    mtx_unlock(&sweeper->lock);
+
+    return 0;
+}
+
+size_t Sweeper_Submit(Sweeper* sweeper, Pool* pool, Heap* heap, Object** objects, size_t count)
+{
+    if (!sweeper->started && !sweeper->failed) {
+        sweeper->started = thrd_create(&sweeper->thread, worker, sweeper) == thrd_success;
+        sweeper->failed = !sweeper->started;
+    }
+
+    if (sweeper->failed) {
+        return free_batch(objects, count, pool, heap);
+    }
+
+    SweeperBatch* batch = NULL;
+    if (count > 0) {
+        batch = xmalloc(sizeof(SweeperBatch) + sizeof(Object*) * count);
+        batch->next = NULL;
+        batch->count = count;
+        memcpy(batch->objects, objects, sizeof(Object*) * count);
+    }
+
+    mtx_lock(&sweeper->lock);
+
+    //Batches are freed in the order they were queued, so that instances are still freed before their classes
+    if (batch) {
+        if (sweeper->queueTail) {
+            sweeper->queueTail->next = batch;
+        } else {
+            sweeper->queueHead = batch;
+        }
+
+        sweeper->queueTail = batch;
+        cnd_signal(&sweeper->batchQueued);
+    }
+
+    //Blocks freed on the sweeper's side only become available for allocation once handed back here
+    Pool_Reclaim(pool, &sweeper->freedBlocks);
+    Heap_Reclaim(heap, &sweeper->freedObjects);
+
+    size_t freed = sweeper->bytesFreed;
+    sweeper->bytesFreed = 0;
+
+    mtx_unlock(&sweeper->lock);
+    return freed;
+}
+
+//Waits until every queued object has been freed, so that the bytes they held are all accounted for
+size_t Sweeper_Drain(Sweeper* sweeper, Pool* pool, Heap* heap)
+{
+    if (sweeper->started) {
+        mtx_lock(&sweeper->lock);
+        while (sweeper->queueHead || sweeper->busy) {
+            cnd_wait(&sweeper->batchFreed, &sweeper->lock);
+        }
+        mtx_unlock(&sweeper->lock);
+    }
+
+    return Sweeper_Submit(sweeper, pool, heap, NULL, 0);
+}
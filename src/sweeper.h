@@ -0,0 +1,38 @@
+#ifndef SWEEPER_H
+#define SWEEPER_H
+
+#include <threads.h>
+
+#include "common.h"
+#include "pool.h"
+#include "heap.h"
+
+typedef struct Object Object;
+
+typedef struct SweeperBatch SweeperBatch;
+
+typedef struct Sweeper {
+    SweeperBatch* queueHead;
+    SweeperBatch* queueTail;
+    size_t bytesFreed;
+    Pool freedBlocks;
+    Heap freedObjects;
+
+    mtx_t lock;
+    cnd_t batchQueued;
+    cnd_t batchFreed;
+    bool busy;
+
+    thrd_t thread;
+    bool started;
+    bool failed;
+    bool shutdown;
+} Sweeper;
+
+void Sweeper_Init(Sweeper* sweeper);
+void Sweeper_Free(Sweeper* sweeper);
+
+size_t Sweeper_Submit(Sweeper* sweeper, Pool* pool, Heap* heap, Object** objects, size_t count);
+size_t Sweeper_Drain(Sweeper* sweeper, Pool* pool, Heap* heap);
+
+#endif
@@ -27,8 +27,6 @@
 #include "disassembler.h"
 #endif
 
-#define FILE_EXTENSION ".archer"
-
 void Vm_Init(VM* vm)
 {
     vm->compiler = NULL;
@@ -36,6 +34,9 @@ void Vm_Init(VM* vm)
 
     vm->mainModule = NULL;
 
+    vm->recordedProfile = NULL;
+    vm->usedProfile = NULL;
+
     vm->moduleRegister = NULL;
     vm->coroutine = NULL;
 
@@ -63,6 +64,8 @@ void Vm_Init(VM* vm)
     Table_Init(&vm->builtins);
     Table_Init(&vm->strings);
 
+    Loader_Init(&vm->loader);
+
     vm->temporaryCount = 0;
 
     Library_Init(vm);
@@ -72,6 +75,8 @@ void Vm_Free(VM* vm)
 {
     vm->initString = NULL;
 
+    Loader_Free(&vm->loader);
+
     Table_Free(&vm->gc, &vm->strings);
 
     GC_Free(&vm->gc);
@@ -146,6 +151,13 @@ InterpretStatus Vm_RuntimeError(VM* vm, const char* format, ...)
     return INTERPRET_RUNTIME_ERROR;
 }
 
+//The heap limit is only enforced where the program can be stopped safely, which any loop or call passes through
+static InterpretStatus heap_exhausted(VM* vm)
+{
+    vm->gc.exhausted = false;
+    return Vm_RuntimeError(vm, "Out of memory (the heap has exceeded its limit of %zu bytes).", vm->gc.options.maxHeap);
+}
+
 bool Vm_Call(VM* vm, ObjectClosure* closure, uint8_t argCount)
 {
     return Coroutine_Call(vm, vm->coroutine, closure, argCount);
@@ -156,6 +168,13 @@ static bool call_value(VM* vm, Value callee, uint8_t argCount)
     return Coroutine_CallValue(vm, vm->coroutine, callee, argCount);
 }
 
+static bool load_pending_module(VM* vm, ObjectModule* mod);
+
+static bool is_pending_module(VM* vm, Object* object)
+{
+    return object->type == vm->moduleType && !AS_MODULE(object)->imported;
+}
+
 static bool load_property(VM* vm, Object* object, ObjectString* name, Value* result)
 {
     Value key = OBJ_VAL(name);
@@ -166,6 +185,12 @@ static bool load_property(VM* vm, Object* object, ObjectString* name, Value* res
         }
     }
 
+    //Namespaced imports are only executed once something is looked up in them
+    if (is_pending_module(vm, object)) {
+        return load_pending_module(vm, AS_MODULE(object))
+            && load_property(vm, object, name, result);
+    }
+
     if (!object->type->GetMethod) {
         Vm_RuntimeError(vm, "Objects of type '%s' do not have methods.", object->type->name);
         return false;
@@ -257,10 +282,11 @@ static void close_upvalues(VM* vm, Value* last)
         upvalue->closed = *upvalue->location;
         upvalue->location = &upvalue->closed;
         vm->coroutine->openUpvalues = upvalue->next;
+        GC_WRITE_BARRIER(&vm->gc, upvalue);
     }
 }
 
-static char* obtain_source(VM* vm, ObjectModule* mod)
+static char* module_file_name(ObjectModule* mod)
 {
     size_t pathLength = strlen(AS_CSTRING(mod->path));
     size_t nameLength = strlen(AS_CSTRING(mod->name));
@@ -273,10 +299,26 @@ static char* obtain_source(VM* vm, ObjectModule* mod)
     memcpy(fullName + pathLength + nameLength, FILE_EXTENSION,        extensionLength);
     fullName[length - 1] = '\0';
 
-    char* source = Reader_ReadFile(fullName);
-    free(fullName);
+    return fullName;
+}
 
-    return source;
+static ObjectFunction* compile_module(VM* vm, ObjectModule* mod)
+{
+    char* fileName = module_file_name(mod);
+
+    //Modules read by a worker have already had their dependencies queued up
+    char* source = Loader_Take(&vm->loader, fileName);
+    if (!source) {
+        Loader_Forget(&vm->loader, fileName);
+        source = Reader_ReadFile(fileName);
+        Loader_Prefetch(&vm->loader, source, AS_CSTRING(mod->path));
+    }
+
+    ObjectFunction* function = Compiler_Compile(vm, source, mod);
+    free(source);
+
+    free(fileName);
+    return function;
 }
 
 static CallFrame* get_current_frame(VM* vm)
@@ -289,34 +331,56 @@ static ObjectModule* get_current_module(VM* vm)
     return get_current_frame(vm)->closure->function->mod;
 }
 
+static ObjectString* canonical_path(VM* vm, ObjectString* path, ObjectString* relativePath)
+{
+    char* fullPath = xmalloc(path->length + relativePath->length + 1);
+    memcpy(fullPath, path->chars, path->length);
+    memcpy(fullPath + path->length, relativePath->chars, relativePath->length);
+    fullPath[path->length + relativePath->length] = '\0';
+
+    size_t length = Reader_NormalizePath(fullPath);
+    ObjectString* result = String_Copy(vm, fullPath, length);
+    free(fullPath);
+    return result;
+}
+
 static ObjectModule* create_module(VM* vm, ObjectString* relativePath)
 {
-    ObjectString* fullPath = String_Concatenate(vm, get_current_module(vm)->path, relativePath);
-    Vm_PushTemporary(vm, OBJ_VAL(fullPath));
+    //Every importer remembers what its relative paths resolved to, so repeated imports avoid building the full path
+    ObjectModule* importer = get_current_module(vm);
 
     Value cached;
-    if (Table_Get(&vm->modules, OBJ_VAL(fullPath), &cached)) {
-        Vm_PopTemporary(vm);
+    if (Table_Get(&importer->imports, OBJ_VAL(relativePath), &cached)) {
         return VAL_AS_MODULE(cached);
     }
 
-    ObjectModule* mod = Module_FromFullPath(vm, AS_CSTRING(fullPath));
-    Vm_PopTemporary(vm);
+    ObjectString* fullPath = canonical_path(vm, importer->path, relativePath);
+    Vm_PushTemporary(vm, OBJ_VAL(fullPath));
 
-    Vm_PushTemporary(vm, OBJ_VAL(mod));
-    Table_Put(vm, &vm->modules, OBJ_VAL(fullPath), OBJ_VAL(mod));
+    ObjectModule* mod;
+    if (Table_Get(&vm->modules, OBJ_VAL(fullPath), &cached)) {
+        mod = VAL_AS_MODULE(cached);
+        Vm_PushTemporary(vm, cached);
+    } else {
+        mod = Module_FromFullPath(vm, AS_CSTRING(fullPath));
+        Vm_PushTemporary(vm, OBJ_VAL(mod));
+        Table_Put(vm, &vm->modules, OBJ_VAL(fullPath), OBJ_VAL(mod));
+    }
+
+    Table_Put(vm, &importer->imports, OBJ_VAL(relativePath), OBJ_VAL(mod));
+    GC_WRITE_BARRIER(&vm->gc, importer);
+    Vm_PopTemporary(vm);
     Vm_PopTemporary(vm);
 
     return mod;
 }
 
-static bool import_module(VM* vm, ObjectModule* mod)
+static ObjectCoroutine* module_coroutine(VM* vm, ObjectModule* mod)
 {
-    char* source = obtain_source(vm, mod);
-    ObjectFunction* function = Compiler_Compile(vm, source, mod);
+    ObjectFunction* function = compile_module(vm, mod);
     if (function == NULL) {
         Vm_RuntimeError(vm, "Could not compile module '%s'.", AS_CSTRING(mod->name));
-        return false;
+        return NULL;
     }
 
     Vm_PushTemporary(vm, OBJ_VAL(function));
@@ -324,13 +388,82 @@ static bool import_module(VM* vm, ObjectModule* mod)
     Vm_PopTemporary(vm);
 
     Vm_PushTemporary(vm, OBJ_VAL(closure));
-    Coroutine_Run(vm, Coroutine_New(vm, closure));
+    ObjectCoroutine* coroutine = Coroutine_New(vm, closure);
     Vm_PopTemporary(vm);
 
+    return coroutine;
+}
+
+static bool import_module(VM* vm, ObjectModule* mod)
+{
+    ObjectCoroutine* coroutine = module_coroutine(vm, mod);
+    if (coroutine == NULL) {
+        return false;
+    }
+
+    Coroutine_Run(vm, coroutine);
     mod->imported = true;
     return true;
 }
 
+static InterpretStatus run(VM* vm);
+
+static bool load_pending_module(VM* vm, ObjectModule* mod)
+{
+    ObjectCoroutine* importer = vm->coroutine;
+    Vm_PushTemporary(vm, OBJ_VAL(importer));
+
+    ObjectCoroutine* coroutine = module_coroutine(vm, mod);
+    if (coroutine == NULL) {
+        Vm_PopTemporary(vm);
+        return false;
+    }
+
+    //Unlike a regular import, the module runs to completion before the importer may continue
+    Coroutine_Run(vm, coroutine);
+    coroutine->transfer = NULL;
+    mod->imported = true;
+
+    InterpretStatus status = run(vm);
+    Vm_PopTemporary(vm);
+
+    if (status != INTERPRET_OK) {
+        return false;
+    }
+
+    vm->coroutine = importer;
+    GC_WRITE_BARRIER(&vm->gc, importer);
+    return true;
+}
+
+static bool sequence_element(VM* vm, Object* sequence, size_t index, Value* result)
+{
+    if (sequence->type == vm->listType) {
+        ObjectList* list = AS_LIST(sequence);
+        if (index >= list->elements.count) {
+            return false;
+        }
+
+        *result = list->elements.data[index];
+    } else if (sequence->type == vm->tupleType) {
+        ObjectTuple* tuple = AS_TUPLE(sequence);
+        if (index >= tuple->length) {
+            return false;
+        }
+
+        *result = tuple->elements[index];
+    } else {
+        ObjectString* string = AS_STRING(sequence);
+        if (index >= string->length) {
+            return false;
+        }
+
+        *result = OBJ_VAL(String_Copy(vm, string->chars + index, 1));
+    }
+
+    return true;
+}
+
 static InterpretStatus run(VM* vm)
 {
     register ObjectCoroutine* coroutine = vm->coroutine;
@@ -344,16 +477,28 @@ static InterpretStatus run(VM* vm)
         ip = frame->ip;                                         \
     } while (0)                                                 \
 
+#define CHECK_HEAP()                                            \
+    do {                                                        \
+        if (vm->gc.exhausted) {                                 \
+            frame->ip = ip;                                     \
+            return heap_exhausted(vm);                          \
+        }                                                       \
+    } while (0)                                                 \
+
 #define READ_BYTE() (*ip++)
 #define READ_SHORT() (ip += 2, (uint16_t)(ip[-2] << 0 | ip[-1] << 8))
 #define READ_CONSTANT() frame->closure->function->chunk.constants.data[READ_BYTE()]
-#define READ_STRING() VAL_AS_STRING(READ_CONSTANT())
+#define READ_CONSTANT_LONG() frame->closure->function->chunk.constants.data[READ_SHORT()]
+#define READ_OPERAND_CONSTANT() (OP_IS_LONG(instruction) ? READ_CONSTANT_LONG() : READ_CONSTANT())
+#define READ_STRING() VAL_AS_STRING(READ_OPERAND_CONSTANT())
 
 #define PEEK_BYTE() (*ip)
 #define PEEK_NEXT_BYTE() (*(ip + 1))
+#define PEEK_AFTER_OPERAND() (ip[OP_IS_LONG(instruction) ? 2 : 1])
 
 #define SKIP_BYTE() (ip++)
 #define SKIP_SHORT() (ip += 2)
+#define SKIP_OPERAND() (ip += OP_IS_LONG(instruction) ? 2 : 1)
 
 #define AS_COMPLEMENT(value) ((int64_t)AS_NUMBER(value))
 
@@ -387,6 +532,10 @@ static InterpretStatus run(VM* vm)
                 PUSH(READ_CONSTANT());
                 break;
             }
+            case OP_LOAD_CONSTANT_LONG: {
+                PUSH(READ_CONSTANT_LONG());
+                break;
+            }
             case OP_LOAD_TRUE: {
                 PUSH(BOOL_VAL(true));
                 break;
@@ -608,12 +757,14 @@ static InterpretStatus run(VM* vm)
             }
             case OP_LOOP: {
                 uint16_t offset = READ_SHORT();
+                CHECK_HEAP();
                 ip -= offset;
                 break;
             }
             case OP_POP_LOOP_IF_TRUE: {
                 uint16_t offset = READ_SHORT();
                 if (!Value_IsFalsey(POP())) {
+                    CHECK_HEAP();
                     ip -= offset;
                 }
                 break;
@@ -645,6 +796,47 @@ static InterpretStatus run(VM* vm)
                 POP();
                 break;
             }
+            case OP_JUMP_TABLE: {
+                double min = AS_NUMBER(READ_CONSTANT_LONG());
+                uint16_t length = READ_SHORT();
+                uint16_t offset = READ_SHORT();
+                uint8_t* offsets = ip;
+                ip += length * 2;
+
+                Value control = POP();
+                if (IS_NUMBER(control)) {
+                    double index = AS_NUMBER(control) - min;
+                    if (index >= 0.0 && index < length && index == (double)(size_t)index) {
+                        size_t slot = (size_t)index * 2;
+                        offset = (uint16_t)(offsets[slot] << 0 | offsets[slot + 1] << 8);
+                    }
+                }
+
+                ip += offset;
+                break;
+            }
+            case OP_JUMP_HASH: {
+                ObjectMap* map = VAL_AS_MAP(READ_CONSTANT_LONG());
+                uint16_t length = READ_SHORT();
+                uint16_t offset = READ_SHORT();
+                uint8_t* offsets = ip;
+                ip += length * 2;
+
+                //Only numbers and strings can match, and zero is looked up without its sign
+                Value control = POP();
+                if (IS_NUMBER(control) && AS_NUMBER(control) == 0.0) {
+                    control = NUMBER_VAL(0.0);
+                }
+
+                Value entry;
+                if ((IS_NUMBER(control) || VAL_IS_STRING(control, vm)) && Table_Get(&map->table, control, &entry)) {
+                    size_t slot = (size_t)AS_NUMBER(entry) * 2;
+                    offset = (uint16_t)(offsets[slot] << 0 | offsets[slot + 1] << 8);
+                }
+
+                ip += offset;
+                break;
+            }
             case OP_JUMP_IF_NOT_NIL: {
                 uint16_t offset = READ_SHORT();
                 if (!IS_NIL(TOP)) {
@@ -694,17 +886,21 @@ static InterpretStatus run(VM* vm)
                 TOP = second;
                 break;
             }
-            case OP_DEFINE_GLOBAL: {
+            case OP_DEFINE_GLOBAL:
+            case OP_DEFINE_GLOBAL_LONG: {
                 ObjectString* identifier = READ_STRING();
-                Table_Put(vm, &get_current_module(vm)->base.fields, OBJ_VAL(identifier), TOP);
+                ObjectModule* mod = get_current_module(vm);
+                Table_Put(vm, &mod->fields, OBJ_VAL(identifier), TOP);
+                GC_WRITE_BARRIER(&vm->gc, mod);
                 POP();
                 break;
             }
-            case OP_LOAD_GLOBAL: {
+            case OP_LOAD_GLOBAL:
+            case OP_LOAD_GLOBAL_LONG: {
                 ObjectString* identifier = READ_STRING();
                 Value key = OBJ_VAL(identifier);
                 Value value;
-                if (Table_Get(&get_current_module(vm)->base.fields, key, &value)) {
+                if (Table_Get(&get_current_module(vm)->fields, key, &value)) {
                     PUSH(value);
                     break;
                 }
@@ -715,15 +911,18 @@ static InterpretStatus run(VM* vm)
                 frame->ip = ip;
                 return Vm_RuntimeError(vm, "Undefined variable '%s'.", identifier->chars);
             }
-            case OP_STORE_GLOBAL: {
+            case OP_STORE_GLOBAL:
+            case OP_STORE_GLOBAL_LONG: {
                 ObjectString* identifier = READ_STRING();
                 Value key = OBJ_VAL(identifier);
                 ObjectModule* mod = get_current_module(vm);
-                if (Table_Put(vm, &mod->base.fields, key, TOP)) {
+                if (Table_Put(vm, &mod->fields, key, TOP)) {
                     frame->ip = ip;
-                    Table_Remove(&mod->base.fields, key);
+                    Table_Remove(&mod->fields, key);
                     return Vm_RuntimeError(vm, "Undefined variable '%s'.", identifier->chars);
                 }
+
+                GC_WRITE_BARRIER(&vm->gc, mod);
                 break;
             }
             case OP_LOAD_LOCAL: {
@@ -739,16 +938,24 @@ static InterpretStatus run(VM* vm)
                 break;
             }
             case OP_STORE_UPVALUE: {
-                *frame->closure->upvalues[READ_BYTE()]->location = TOP;
+                ObjectUpvalue* upvalue = frame->closure->upvalues[READ_BYTE()];
+                *upvalue->location = TOP;
+                GC_WRITE_BARRIER(&vm->gc, upvalue);
                 break;
             }
-            case OP_LOAD_PROPERTY_SAFE: {
+            case OP_LOAD_CAPTURE: {
+                PUSH(frame->closure->captures[READ_BYTE()]);
+                break;
+            }
+            case OP_LOAD_PROPERTY_SAFE:
+            case OP_LOAD_PROPERTY_SAFE_LONG: {
                 if (IS_NIL(TOP)) {
-                    SKIP_BYTE();
+                    SKIP_OPERAND();
                     break;
                 }
             }
-            case OP_LOAD_PROPERTY: {
+            case OP_LOAD_PROPERTY:
+            case OP_LOAD_PROPERTY_LONG: {
                 Object* object = AS_OBJ(TOP);
                 ObjectString* name = READ_STRING();
 
@@ -761,15 +968,17 @@ static InterpretStatus run(VM* vm)
                 TOP = property;
                 break;
             }
-            case OP_STORE_PROPERTY_SAFE: {
+            case OP_STORE_PROPERTY_SAFE:
+            case OP_STORE_PROPERTY_SAFE_LONG: {
                 if (IS_NIL(TOP)) {
-                    SKIP_BYTE();
+                    SKIP_OPERAND();
                     POP();
                     TOP = NIL_VAL();
                     break;
                 }
             }
-            case OP_STORE_PROPERTY: {
+            case OP_STORE_PROPERTY:
+            case OP_STORE_PROPERTY_LONG: {
                 if (!IS_OBJ(TOP)) {
                     frame->ip = ip;
                     return Vm_RuntimeError(vm, "Can only set properties of objects.");
@@ -781,6 +990,13 @@ static InterpretStatus run(VM* vm)
                     return Vm_RuntimeError(vm, "Properties on objects of type '%s' cannot be assigned.", object->type->name);
                 }
 
+                if (is_pending_module(vm, object)) {
+                    frame->ip = ip;
+                    if (!load_pending_module(vm, AS_MODULE(object))) {
+                        return INTERPRET_RUNTIME_ERROR;
+                    }
+                }
+
                 Object_SetField(object, OBJ_VAL(READ_STRING()), SECOND, vm);
                 POP();
                 break;
@@ -790,8 +1006,19 @@ static InterpretStatus run(VM* vm)
                 printf("\n");
                 break;
             }
-            case OP_CLOSURE: {
-                ObjectFunction* function = VAL_AS_FUNCTION(READ_CONSTANT());
+            case OP_CLOSURE:
+            case OP_CLOSURE_LONG: {
+                ObjectFunction* function = VAL_AS_FUNCTION(READ_OPERAND_CONSTANT());
+                if (function->upvalueCount == 0 && function->captureCount == 0) {
+                    if (!function->closure) {
+                        function->closure = Closure_New(vm, function);
+                        GC_WRITE_BARRIER(&vm->gc, function);
+                    }
+
+                    PUSH(OBJ_VAL(function->closure));
+                    break;
+                }
+
                 ObjectClosure* closure = Closure_New(vm, function);
                 PUSH(OBJ_VAL(closure));
                 for (size_t i = 0; i < closure->upvalueCount; i++) {
@@ -803,6 +1030,16 @@ static InterpretStatus run(VM* vm)
                         closure->upvalues[i] = frame->closure->upvalues[index];
                     }
                 }
+
+                //Values that never change after being captured are copied into the closure itself
+                for (size_t i = 0; i < closure->captureCount; i++) {
+                    uint8_t isLocal = READ_BYTE();
+                    uint8_t index = READ_BYTE();
+                    closure->captures[i] = isLocal ? frame->slots[index] : frame->closure->captures[index];
+                }
+
+                //Capturing upvalues allocates, so the closure may have been promoted in the meantime
+                GC_WRITE_BARRIER(&vm->gc, closure);
                 break;
             }
             case OP_CLOSE_UPVALUE: {
@@ -812,6 +1049,7 @@ static InterpretStatus run(VM* vm)
             }
             case OP_CALL: {
                 uint8_t argCount = READ_BYTE();
+                CHECK_HEAP();
 
                 frame->ip = ip;
                 if (!call_value(vm, PEEK(argCount), argCount)) {
@@ -821,16 +1059,19 @@ static InterpretStatus run(VM* vm)
                 UPDATE_POINTERS();
                 break;
             }
-            case OP_INVOKE_SAFE: {
-                if (IS_NIL(PEEK(PEEK_NEXT_BYTE()))) {
-                    SKIP_BYTE();
+            case OP_INVOKE_SAFE:
+            case OP_INVOKE_SAFE_LONG: {
+                if (IS_NIL(PEEK(PEEK_AFTER_OPERAND()))) {
+                    SKIP_OPERAND();
                     POP_N(READ_BYTE());
                     break;
                 }
             }
-            case OP_INVOKE: {
+            case OP_INVOKE:
+            case OP_INVOKE_LONG: {
                 ObjectString* method = READ_STRING();
                 uint8_t argCount = READ_BYTE();
+                CHECK_HEAP();
 
                 frame->ip = ip;
                 if (!invoke(vm, method, argCount)) {
@@ -840,6 +1081,34 @@ static InterpretStatus run(VM* vm)
                 UPDATE_POINTERS();
                 break;
             }
+            case OP_RETURN_TUPLE: {
+                uint8_t count = READ_BYTE();
+                Value* values = coroutine->stackTop - count;
+
+                //When the caller unpacks the result right away, the values are handed over without a tuple
+                if (coroutine->frameCount > 1) {
+                    CallFrame* caller = &coroutine->frames[coroutine->frameCount - 2];
+                    if (caller->ip[0] == OP_TUPLE_UNPACK && caller->ip[1] == count) {
+                        close_upvalues(vm, frame->slots);
+                        memmove(frame->slots, values, sizeof(Value) * count);
+                        coroutine->stackTop = frame->slots + count;
+
+                        caller->ip += 2;
+                        coroutine->frameCount--;
+
+                        UPDATE_POINTERS();
+                        break;
+                    }
+                }
+
+                ObjectTuple* tuple = Tuple_New(vm, count);
+                for (size_t i = 0; i < count; i++) {
+                    Tuple_SetElement(tuple, i, values[i]);
+                }
+
+                coroutine->stackTop = values;
+                PUSH(OBJ_VAL(tuple));
+            }
             case OP_RETURN: {
                 Value result = POP();
 
@@ -852,24 +1121,29 @@ static InterpretStatus run(VM* vm)
                     if (!vm->coroutine) {
                         return INTERPRET_OK;
                     }
+
+                    GC_WRITE_BARRIER(&vm->gc, vm->coroutine);
                 }
 
                 UPDATE_POINTERS();
                 PUSH(result);
                 break;
             }
-            case OP_CLASS: {
+            case OP_CLASS:
+            case OP_CLASS_LONG: {
                 PUSH(OBJ_VAL(Type_NewClass(vm, READ_STRING()->chars)));
                 break;
             }
-            case OP_STATIC_METHOD: {
+            case OP_STATIC_METHOD:
+            case OP_STATIC_METHOD_LONG: {
                 Value method = TOP;
                 ObjectType* clazz = VAL_AS_TYPE(SECOND);
                 Object_SetMethod((Object*)clazz, OBJ_VAL(READ_STRING()), method, vm);
                 Vm_Pop(vm);
                 break;
             }
-            case OP_METHOD: {
+            case OP_METHOD:
+            case OP_METHOD_LONG: {
                 Value method = TOP;
                 ObjectType* clazz = VAL_AS_TYPE(SECOND);
                 Object_SetMethodDirectly((Object*)clazz, OBJ_VAL(READ_STRING()), method, vm);
@@ -890,10 +1164,12 @@ static InterpretStatus run(VM* vm)
 
                 ObjectType* subclass = VAL_AS_TYPE(TOP);
                 Table_PutFrom(vm, &superclass->methods, &subclass->methods);
+                GC_WRITE_BARRIER(&vm->gc, subclass);
                 POP();
                 break;
             }
-            case OP_GET_SUPER: {
+            case OP_GET_SUPER:
+            case OP_GET_SUPER_LONG: {
                 ObjectString* name = READ_STRING();
                 ObjectType* superclass = VAL_AS_TYPE(POP());
 
@@ -907,9 +1183,12 @@ static InterpretStatus run(VM* vm)
                 TOP = key;
                 break;
             }
-            case OP_SUPER_INVOKE: {
+            case OP_SUPER_INVOKE:
+            case OP_SUPER_INVOKE_LONG: {
                 ObjectString* name = READ_STRING();
                 uint8_t argCount = READ_BYTE();
+                CHECK_HEAP();
+
                 ObjectType* superclass = VAL_AS_TYPE(POP());
 
                 frame->ip = ip;
@@ -1105,6 +1384,7 @@ static InterpretStatus run(VM* vm)
 
                 coroutine->frames[coroutine->frameCount - 1].ip = ip;
                 vm->coroutine = coroutine->transfer;
+                GC_WRITE_BARRIER(&vm->gc, vm->coroutine);
 
                 UPDATE_POINTERS();
                 PUSH(result);
@@ -1121,16 +1401,26 @@ static InterpretStatus run(VM* vm)
                 if (mod->imported) {
                     PUSH(NIL_VAL());
                 } else if (!import_module(vm, mod)) {
-                    return Vm_RuntimeError(vm, "Could not import module.");
+                    return INTERPRET_RUNTIME_ERROR;
                 }
 
                 UPDATE_POINTERS();
                 break;
             }
+            case OP_IMPORT_LAZY: {
+                if (!VAL_IS_STRING(TOP, vm)) {
+                    frame->ip = ip;
+                    return Vm_RuntimeError(vm, "Module name must be a string.");
+                }
+
+                TOP = OBJ_VAL(create_module(vm, VAL_AS_STRING(TOP)));
+                break;
+            }
             case OP_IMPORT_ALL: {
-                Table* source = &VAL_AS_MODULE(TOP)->base.fields;
-                Table* destination = &get_current_module(vm)->base.fields;
-                Table_PutFrom(vm, source, destination);
+                Table* source = &VAL_AS_MODULE(TOP)->fields;
+                ObjectModule* mod = get_current_module(vm);
+                Table_PutFrom(vm, source, &mod->fields);
+                GC_WRITE_BARRIER(&vm->gc, mod);
                 POP();
                 break;
             }
@@ -1138,10 +1428,11 @@ static InterpretStatus run(VM* vm)
                 vm->moduleRegister = VAL_AS_MODULE(POP());
                 break;
             }
-            case OP_IMPORT_BY_NAME: {
+            case OP_IMPORT_BY_NAME:
+            case OP_IMPORT_BY_NAME_LONG: {
                 ObjectString* name = READ_STRING();
                 Value value;
-                if (!Table_Get(&vm->moduleRegister->base.fields, OBJ_VAL(name), &value)) {
+                if (!Table_Get(&vm->moduleRegister->fields, OBJ_VAL(name), &value)) {
                     frame->ip = ip;
                     return Vm_RuntimeError(vm, "Identifier '%s' not found in module '%s'.", AS_CSTRING(name), AS_CSTRING(vm->moduleRegister->name));
                 }
@@ -1155,23 +1446,77 @@ static InterpretStatus run(VM* vm)
                 }
 
                 Object* obj = AS_OBJ(TOP);
-                if (!obj->type->MakeIterator) {
+                ObjectType* type = obj->type;
+
+                //Built-in sequences are walked by index, so no iterator object is needed
+                if (type == vm->listType || type == vm->tupleType || type == vm->stringType) {
+                    PUSH(NUMBER_VAL(0.0));
+                    break;
+                }
+
+                if (!type->MakeIterator) {
                     frame->ip = ip;
-                    return Vm_RuntimeError(vm, "Objects of type '%s' are not iterable.", obj->type->name);
+                    return Vm_RuntimeError(vm, "Objects of type '%s' are not iterable.", type->name);
                 }
 
-                TOP = OBJ_VAL(obj->type->MakeIterator(obj, vm));
+                TOP = OBJ_VAL(type->MakeIterator(obj, vm));
+                PUSH(NIL_VAL());
                 break;
             }
             case OP_FOR_ITERATOR: {
                 uint16_t offset = READ_SHORT();
 
-                ObjectIterator* iterator = VAL_AS_ITERATOR(TOP);
-                if (Iterator_ReachedEnd(iterator)) {
+                if (IS_NIL(TOP)) {
+                    ObjectIterator* iterator = VAL_AS_ITERATOR(SECOND);
+                    if (Iterator_ReachedEnd(iterator)) {
+                        ip += offset;
+                    } else {
+                        PUSH(Iterator_GetValue(vm, iterator));
+                        Iterator_Advance(iterator);
+                    }
+                    break;
+                }
+
+                size_t index = (size_t)AS_NUMBER(TOP);
+                Value element;
+
+                if (sequence_element(vm, AS_OBJ(SECOND), index, &element)) {
+                    TOP = NUMBER_VAL((double)(index + 1));
+                    PUSH(element);
+                } else {
+                    ip += offset;
+                }
+                break;
+            }
+            case OP_RANGE_COUNTER: {
+                if (!IS_NUMBER(THIRD)) {
+                    frame->ip = ip;
+                    return Vm_RuntimeError(vm, "Range 'begin' must be a number.");
+                }
+
+                if (!IS_NUMBER(SECOND)) {
+                    frame->ip = ip;
+                    return Vm_RuntimeError(vm, "Range 'end' must be a number.");
+                }
+
+                if (!IS_NUMBER(TOP) || AS_NUMBER(TOP) == 0.0f) {
+                    frame->ip = ip;
+                    return Vm_RuntimeError(vm, "Range 'step' must be a non-zero number.");
+                }
+                break;
+            }
+            case OP_FOR_RANGE: {
+                uint16_t offset = READ_SHORT();
+
+                double counter = AS_NUMBER(THIRD);
+                double end = AS_NUMBER(SECOND);
+                double step = AS_NUMBER(TOP);
+
+                if (step > 0.0 ? counter >= end : counter <= end) {
                     ip += offset;
                 } else {
-                    PUSH(Iterator_GetValue(vm, iterator));
-                    Iterator_Advance(iterator);
+                    THIRD = NUMBER_VAL(counter + step);
+                    PUSH(NUMBER_VAL(counter));
                 }
                 break;
             }
@@ -1200,19 +1545,103 @@ static InterpretStatus run(VM* vm)
                 TOP = OBJ_VAL(range);
                 break;
             }
+            case OP_CHECK_NUMBER: {
+                if (!IS_NUMBER(TOP)) {
+                    frame->ip = ip;
+                    return Vm_RuntimeError(vm, "Expected a value of type Number.");
+                }
+                break;
+            }
+            case OP_CHECK_NUMBER_LOCAL: {
+                if (!IS_NUMBER(frame->slots[READ_BYTE()])) {
+                    frame->ip = ip;
+                    return Vm_RuntimeError(vm, "Expected a value of type Number.");
+                }
+                break;
+            }
+            case OP_GREATER_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = BOOL_VAL(AS_NUMBER(TOP) > rhs);
+                break;
+            }
+            case OP_GREATER_EQUAL_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = BOOL_VAL(AS_NUMBER(TOP) >= rhs);
+                break;
+            }
+            case OP_LESS_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = BOOL_VAL(AS_NUMBER(TOP) < rhs);
+                break;
+            }
+            case OP_LESS_EQUAL_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = BOOL_VAL(AS_NUMBER(TOP) <= rhs);
+                break;
+            }
+            case OP_NEGATE_NUMBER: {
+                TOP = NUMBER_VAL(-AS_NUMBER(TOP));
+                break;
+            }
+            case OP_INC_NUMBER: {
+                TOP = NUMBER_VAL(AS_NUMBER(TOP) + 1);
+                break;
+            }
+            case OP_DEC_NUMBER: {
+                TOP = NUMBER_VAL(AS_NUMBER(TOP) - 1);
+                break;
+            }
+            case OP_ADD_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = NUMBER_VAL(AS_NUMBER(TOP) + rhs);
+                break;
+            }
+            case OP_SUBTRACT_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = NUMBER_VAL(AS_NUMBER(TOP) - rhs);
+                break;
+            }
+            case OP_MULTIPLY_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = NUMBER_VAL(AS_NUMBER(TOP) * rhs);
+                break;
+            }
+            case OP_DIVIDE_NUMBER: {
+                double rhs = AS_NUMBER(POP());
+                TOP = NUMBER_VAL(AS_NUMBER(TOP) / rhs);
+                break;
+            }
+            case OP_PROFILE_CALL: {
+                vm->recordedProfile->sites[READ_SHORT()].counts[0]++;
+                break;
+            }
+            case OP_PROFILE_BRANCH: {
+                vm->recordedProfile->sites[READ_SHORT()].counts[Value_IsFalsey(TOP) ? 1 : 0]++;
+                break;
+            }
+            case OP_PROFILE_OPERANDS: {
+                vm->recordedProfile->sites[READ_SHORT()].counts[IS_NUMBER(TOP) && IS_NUMBER(SECOND) ? 0 : 1]++;
+                break;
+            }
         }
     }
 
+#undef CHECK_HEAP
+
 #undef READ_BYTE
 #undef READ_SHORT
 #undef READ_CONSTANT
+#undef READ_CONSTANT_LONG
+#undef READ_OPERAND_CONSTANT
 #undef READ_STRING
 
 #undef PEEK_BYTE
 #undef PEEK_NEXT_BYTE
+#undef PEEK_AFTER_OPERAND
 
 #undef SKIP_BYTE
 #undef SKIP_SHORT
+#undef SKIP_OPERAND
 
 #undef AS_COMPLEMENT
 
@@ -1241,8 +1670,9 @@ static char* convert_path(const char* path)
 static void create_main_module(VM* vm, const char* path)
 {
     char* correctPath = convert_path(path);
+    size_t length = Reader_NormalizePath(correctPath);
 
-    ObjectString* fullPath = String_Copy(vm, correctPath, strlen(correctPath) - strlen(FILE_EXTENSION));
+    ObjectString* fullPath = String_Copy(vm, correctPath, length - strlen(FILE_EXTENSION));
     free(correctPath);
     Vm_PushTemporary(vm, OBJ_VAL(fullPath));
 
@@ -1261,8 +1691,15 @@ InterpretStatus Vm_Interpret(VM* vm, const char* source, const char* path)
 {
     if (!vm->mainModule) {
         create_main_module(vm, path);
+
+        //Modules that import the main one back must not have it read again
+        char* fileName = module_file_name(vm->mainModule);
+        Loader_Forget(&vm->loader, fileName);
+        free(fileName);
     }
 
+    Loader_Prefetch(&vm->loader, source, AS_CSTRING(vm->mainModule->path));
+
     ObjectFunction* function = Compiler_Compile(vm, source, vm->mainModule);
     if (function == NULL) {
         return INTERPRET_COMPILE_ERROR;
@@ -4,6 +4,8 @@
 #include "gc.h"
 #include "value.h"
 #include "table.h"
+#include "loader.h"
+#include "profile.h"
 
 #define TEMP_MAX 64
 
@@ -43,6 +45,13 @@ typedef struct VM {
 
     Table modules;
     Table builtins;
+
+    Loader loader;
+
+    //A profile that this run records, and one recorded earlier that guides the compiler, if they were asked for
+    Profile* recordedProfile;
+    Profile* usedProfile;
+
     Table strings;
     ObjectString* initString;
 